@@ -0,0 +1,183 @@
+#include "int256.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "uint256_kernels.h"
+#include "uint256_limbs.h"
+
+static inline uint32_t sign_of(const uint32_t data[8]) {
+  return data[7] >> 31;
+}
+
+// Return the value in data, negated if neg is 1. Negation is
+// (x ^ -neg) + neg, so both cases are the same single carry pass.
+static UInt256 negate_if(const uint32_t data[8], uint32_t neg) {
+  uint64_t mask = -(uint64_t)neg;
+  uint64_t w0 = (get_word(data, 0) ^ mask) + neg;
+  uint64_t c = w0 < neg;
+  uint64_t w1 = (get_word(data, 1) ^ mask) + c;
+  c = w1 < c;
+  uint64_t w2 = (get_word(data, 2) ^ mask) + c;
+  c = w2 < c;
+  uint64_t w3 = (get_word(data, 3) ^ mask) + c;
+  UInt256 result;
+  store_words(result.data, w0, w1, w2, w3);
+  return result;
+}
+
+// Create an Int256 value from a 64-bit signed value.
+Int256 int256_create_from_i64(int64_t val) {
+  Int256 result;
+  uint64_t fill = (uint64_t)(val >> 63);
+  store_words(result.data, (uint64_t)val, fill, fill, fill);
+  return result;
+}
+
+// Reinterpret the bits of a UInt256 value as an Int256 value.
+Int256 int256_from_uint256(UInt256 val) {
+  Int256 result;
+  memcpy(result.data, val.data, sizeof(result.data));
+  return result;
+}
+
+// Reinterpret the bits of an Int256 value as a UInt256 value.
+UInt256 int256_to_uint256(Int256 val) {
+  UInt256 result;
+  memcpy(result.data, val.data, sizeof(result.data));
+  return result;
+}
+
+// Create an Int256 value from a string of decimal digits, optionally
+// preceded by '-'.
+Int256 int256_create_from_dec(const char *dec) {
+  uint32_t neg = dec[0] == '-';
+  UInt256 mag = uint256_create_from_dec(dec + neg);
+  return int256_from_uint256(negate_if(mag.data, neg));
+}
+
+// Return a dynamically-allocated string of decimal digits representing
+// the given Int256 value, preceded by '-' if it is negative.
+char *int256_format_as_dec(Int256 val) {
+  char *digits = uint256_format_as_dec(int256_abs(val));
+  if (!int256_is_negative(val)) {
+    return digits;
+  }
+  size_t len = strlen(digits);
+  char *dec = realloc(digits, len + 2);
+  if (dec == NULL) {
+    free(digits);
+    return NULL;
+  }
+  memmove(dec + 1, dec, len + 1);
+  dec[0] = '-';
+  return dec;
+}
+
+// Return 1 if the given Int256 value is negative, 0 otherwise.
+int int256_is_negative(Int256 val) {
+  return (int)sign_of(val.data);
+}
+
+// Return the absolute value of the given Int256 value, as a UInt256.
+UInt256 int256_abs(Int256 val) {
+  return negate_if(val.data, sign_of(val.data));
+}
+
+// Compare two Int256 values: returns -1, 0 or 1 as left is less than,
+// equal to or greater than right.
+// Flipping the sign bits maps -2^255..2^255-1 in order onto
+// 0..2^256-1, so this is an unsigned comparison with the top words
+// biased, and no sign cases: the borrow out of left - right gives
+// "less", and any difference between the words gives "not equal". As
+// with uint256_cmp, the time taken doesn't depend on where the values
+// differ.
+int int256_cmp(Int256 left, Int256 right) {
+  uint64_t l0 = get_word(left.data, 0), r0 = get_word(right.data, 0);
+  uint64_t l1 = get_word(left.data, 1), r1 = get_word(right.data, 1);
+  uint64_t l2 = get_word(left.data, 2), r2 = get_word(right.data, 2);
+  uint64_t l3 = get_word(left.data, 3) ^ (1ULL << 63);
+  uint64_t r3 = get_word(right.data, 3) ^ (1ULL << 63);
+  uint64_t borrow = l0 < r0;
+  borrow = (l1 < r1) | ((l1 - r1) < borrow);
+  borrow = (l2 < r2) | ((l2 - r2) < borrow);
+  borrow = (l3 < r3) | ((l3 - r3) < borrow);
+  int ne = ((l0 ^ r0) | (l1 ^ r1) | (l2 ^ r2) | (l3 ^ r3)) != 0;
+  return ne - 2 * (int)borrow;
+}
+
+// Compute the sum of two Int256 values.
+Int256 int256_add(Int256 left, Int256 right) {
+  Int256 sum;
+  uint256_kernels->add(sum.data, left.data, right.data);
+  return sum;
+}
+
+// Compute the difference of two Int256 values.
+Int256 int256_sub(Int256 left, Int256 right) {
+  Int256 result;
+  uint256_kernels->sub(result.data, left.data, right.data);
+  return result;
+}
+
+// Return the negation of the given Int256 value.
+Int256 int256_negate(Int256 val) {
+  return int256_from_uint256(negate_if(val.data, 1));
+}
+
+// Compute the product of two Int256 values (the low 256 bits of the
+// product are the same as for the unsigned values).
+Int256 int256_mul(Int256 left, Int256 right) {
+  Int256 product;
+  uint256_kernels->mul(product.data, left.data, right.data);
+  return product;
+}
+
+// Compute the full 512-bit signed product of two Int256 values.
+// A negative operand a stands for the unsigned value a + 2^256, so the
+// unsigned product is too large by 2^256 * b for each negative a (and
+// likewise for b): the high half is corrected by subtracting the other
+// operand once for each negative one, with no negations.
+void int256_mul_wide(Int256 left, Int256 right, Int256 *hi, UInt256 *lo) {
+  UInt256 uhi;
+  uint256_mul_wide(int256_to_uint256(left), int256_to_uint256(right), &uhi,
+                   lo);
+  uint32_t lmask = -sign_of(left.data), rmask = -sign_of(right.data);
+  uint32_t fix[8];
+  for (int i = 0; i < 8; i++) {
+    fix[i] = right.data[i] & lmask;
+  }
+  sub_limbs(uhi.data, uhi.data, fix);
+  for (int i = 0; i < 8; i++) {
+    fix[i] = left.data[i] & rmask;
+  }
+  sub_limbs(uhi.data, uhi.data, fix);
+  *hi = int256_from_uint256(uhi);
+}
+
+// Divide num by den, rounding the quotient toward zero.
+// The magnitudes are divided, and then the quotient takes the sign
+// of num * den and the remainder the sign of num; each sign change is the
+// same carry pass as taking the magnitude.
+void int256_divmod(Int256 num, Int256 den, Int256 *quot, Int256 *rem) {
+  uint32_t nneg = sign_of(num.data), dneg = sign_of(den.data);
+  UInt256 q, r;
+  uint256_divmod(negate_if(num.data, nneg), negate_if(den.data, dneg),
+                 quot != NULL ? &q : NULL, rem != NULL ? &r : NULL);
+  if (quot != NULL) {
+    *quot = int256_from_uint256(negate_if(q.data, nneg ^ dneg));
+  }
+  if (rem != NULL) {
+    *rem = int256_from_uint256(negate_if(r.data, nneg));
+  }
+}
+
+// Shift given Int256 value right by specified number of bits, filling
+// with copies of the sign bit (shifts of 256 or more give all sign
+// bits).
+// This is rshift_words (uint256_limbs.h) with words of sign bits
+// shifted in, so there are no branches on the shift.
+Int256 int256_sar(Int256 val, unsigned shift) {
+  Int256 result;
+  rshift_words(result.data, val.data, shift, -(uint64_t)sign_of(val.data));
+  return result;
+}
@@ -0,0 +1,96 @@
+#ifndef INT256_H
+#define INT256_H
+
+#include <stdint.h>
+#include "uint256.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Data type representing a 256-bit signed integer in two's complement.
+// It has exactly the layout of UInt256 (index 0 is the least
+// significant limb), and the top bit of data[7] is the sign bit.
+//
+// Converting between Int256 and UInt256 reinterprets the bits, so it
+// costs nothing. Addition, subtraction, negation and the low 256 bits
+// of a product are the same operations in two's complement as for
+// unsigned values; the operations that differ (comparison, right
+// shift, the high half of a product, division and decimal conversion)
+// are implemented on the signed representation directly.
+typedef struct {
+  uint32_t data[8];
+} Int256;
+
+// Create an Int256 value from a 64-bit signed value.
+Int256 int256_create_from_i64( int64_t val );
+
+// Reinterpret the bits of a UInt256 value as an Int256 value (values
+// of 2^255 and above become negative).
+Int256 int256_from_uint256( UInt256 val );
+
+// Reinterpret the bits of an Int256 value as a UInt256 value (negative
+// values become val + 2^256).
+UInt256 int256_to_uint256( Int256 val );
+
+// Create an Int256 value from a string of decimal digits, optionally
+// preceded by '-'. Values outside the range of Int256 are reduced
+// modulo 2^256.
+Int256 int256_create_from_dec( const char *dec );
+
+// Return a dynamically-allocated string of decimal digits representing
+// the given Int256 value, preceded by '-' if it is negative.
+// Returns NULL if the string can't be allocated.
+char *int256_format_as_dec( Int256 val );
+
+// Return 1 if the given Int256 value is negative, 0 otherwise.
+int int256_is_negative( Int256 val );
+
+// Return the absolute value of the given Int256 value, as a UInt256
+// (so that the absolute value of -2^255 is representable).
+UInt256 int256_abs( Int256 val );
+
+// Compare two Int256 values: returns -1, 0 or 1 as left is less than,
+// equal to or greater than right.
+int int256_cmp( Int256 left, Int256 right );
+
+// Compute the sum of two Int256 values (wrapping modulo 2^256).
+Int256 int256_add( Int256 left, Int256 right );
+
+// Compute the difference of two Int256 values (wrapping modulo 2^256).
+Int256 int256_sub( Int256 left, Int256 right );
+
+// Return the negation of the given Int256 value (-(-2^255) is -2^255).
+Int256 int256_negate( Int256 val );
+
+// Compute the product of two Int256 values (wrapping modulo 2^256).
+Int256 int256_mul( Int256 left, Int256 right );
+
+// Compute the full 512-bit signed product of two Int256 values: the
+// product is *hi * 2^256 + *lo, where *hi is signed and *lo holds the
+// low 256 bits (unsigned).
+void int256_mul_wide( Int256 left, Int256 right, Int256 *hi, UInt256 *lo );
+
+// Divide num by den, rounding the quotient toward zero (as C's / and
+// % do), so that the remainder has the sign of num. Stores the quotient
+// in *quot and the remainder in *rem; either output pointer may be NULL
+// if that result is not needed. Division by zero is undefined;
+// -2^255 / -1 wraps to -2^255.
+//
+// This divides the magnitudes with uint256_divmod and then fixes up the
+// signs, rather than dividing signed values directly: every magnitude,
+// including that of -2^255, fits in a UInt256, the sign fixes cost two
+// branch-free negations, and it keeps a single long-division routine.
+void int256_divmod( Int256 num, Int256 den, Int256 *quot, Int256 *rem );
+
+// Shift given Int256 value right by specified number of bits, filling
+// the vacated high bits with copies of the sign bit. This rounds toward
+// negative infinity. Any shift is allowed; shifts of 256 or more give 0
+// for non-negative values and -1 for negative ones.
+Int256 int256_sar( Int256 val, unsigned shift );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INT256_H
@@ -4,6 +4,176 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#if defined(__x86_64__) && !defined(UINT256_PORTABLE)
+#include <x86intrin.h>
+#endif
+#include "uint256_kernels.h"
+#include "uint256_limbs.h"
+
+// Add/subtract kernels on the raw limbs. Every kernel reads a limb (or
+// pair of limbs) of its operands before writing the same position of
+// the result, so r may alias a or b.
+//
+// By default the carry chain has no branches: on x86-64 it uses the
+// add-with-carry / subtract-with-borrow intrinsics on 64-bit pairs of
+// limbs, elsewhere plain C on 64-bit pairs with the carry computed
+// from comparisons. Building with -DUINT256_PORTABLE selects the
+// original limb-at-a-time versions instead.
+//
+// Together with mul_kernel and lshift_kernel below, these make up the
+// generic backend; the public functions call through uint256_kernels
+// so that uint256_dispatch.c can swap in CPU-specific versions.
+#if defined(UINT256_PORTABLE)
+
+static void add_kernel(uint32_t r[8], const uint32_t a[8],
+                       const uint32_t b[8]) {
+  int overflow = 0;
+  for (int i = 0; i < 8; i++) {
+    uint32_t leftpart = a[i];
+    uint32_t rightpart = b[i];
+    uint32_t total = leftpart + rightpart + overflow;
+    r[i] = total;
+    // check whether there is an overflow
+    if ((overflow == 0 && total < leftpart) ||
+        (overflow == 1 && total <= leftpart)) {
+      overflow = 1;
+    } else {
+      overflow = 0;
+    }
+  }
+}
+
+static void negate_kernel(uint32_t r[8], const uint32_t a[8]) {
+  // Inverting all bits, then adding 1
+  uint32_t inverted[8];
+  for (int i = 0; i < 8; i++) {
+    inverted[i] = ~a[i];
+  }
+  const uint32_t one[8] = {1};
+  add_kernel(r, inverted, one);
+}
+
+static void sub_kernel(uint32_t r[8], const uint32_t a[8],
+                       const uint32_t b[8]) {
+  uint32_t nb[8];
+  negate_kernel(nb, b);
+  add_kernel(r, a, nb);
+}
+
+#elif defined(__x86_64__)
+
+static void add_kernel(uint32_t r[8], const uint32_t a[8],
+                       const uint32_t b[8]) {
+  unsigned char carry = 0;
+  for (int i = 0; i < 8; i += 2) {
+    unsigned long long x, y, s;
+    memcpy(&x, a + i, 8);
+    memcpy(&y, b + i, 8);
+    carry = _addcarry_u64(carry, x, y, &s);
+    memcpy(r + i, &s, 8);
+  }
+}
+
+static void sub_kernel(uint32_t r[8], const uint32_t a[8],
+                       const uint32_t b[8]) {
+  unsigned char borrow = 0;
+  for (int i = 0; i < 8; i += 2) {
+    unsigned long long x, y, d;
+    memcpy(&x, a + i, 8);
+    memcpy(&y, b + i, 8);
+    borrow = _subborrow_u64(borrow, x, y, &d);
+    memcpy(r + i, &d, 8);
+  }
+}
+
+static void negate_kernel(uint32_t r[8], const uint32_t a[8]) {
+  const uint32_t zero[8] = {0};
+  sub_kernel(r, zero, a);
+}
+
+#else
+
+// Load/store a pair of limbs as one 64-bit value (endian-independent).
+static inline uint64_t load_pair(const uint32_t *p) {
+  return (uint64_t)p[0] | ((uint64_t)p[1] << 32);
+}
+
+static inline void store_pair(uint32_t *p, uint64_t v) {
+  p[0] = (uint32_t)v;
+  p[1] = (uint32_t)(v >> 32);
+}
+
+static void add_kernel(uint32_t r[8], const uint32_t a[8],
+                       const uint32_t b[8]) {
+  uint64_t carry = 0;
+  for (int i = 0; i < 8; i += 2) {
+    uint64_t x = load_pair(a + i);
+    uint64_t s = x + load_pair(b + i);
+    uint64_t c1 = s < x;
+    s += carry;
+    carry = c1 | (s < carry);
+    store_pair(r + i, s);
+  }
+}
+
+static void sub_kernel(uint32_t r[8], const uint32_t a[8],
+                       const uint32_t b[8]) {
+  uint64_t borrow = 0;
+  for (int i = 0; i < 8; i += 2) {
+    uint64_t x = load_pair(a + i);
+    uint64_t y = load_pair(b + i);
+    uint64_t d = x - y;
+    uint64_t b1 = x < y;
+    uint64_t b2 = d < borrow;
+    d -= borrow;
+    borrow = b1 | b2;
+    store_pair(r + i, d);
+  }
+}
+
+static void negate_kernel(uint32_t r[8], const uint32_t a[8]) {
+  const uint32_t zero[8] = {0};
+  sub_kernel(r, zero, a);
+}
+
+#endif
+
+// Schoolbook multiplication on the 32-bit limbs (truncated to 256
+// bits): only the partial products that land in the low 256 bits are
+// formed, and each one is accumulated in 64 bits so the carry never
+// overflows ((2^32-1)^2 + 2*(2^32-1) == 2^64-1). The product is built
+// in a local buffer since every limb of the operands is needed until
+// the end, so r may alias a or b.
+static void mul_kernel(uint32_t r[8], const uint32_t a[8],
+                       const uint32_t b[8]) {
+  uint32_t t[8] = {0};
+  for (int i = 0; i < 8; i++) {
+    uint64_t carry = 0;
+    uint64_t l = a[i];
+    for (int j = 0; j < 8 - i; j++) {
+      uint64_t p = l * b[j] + t[i + j] + carry;
+      t[i + j] = (uint32_t)p;
+      carry = p >> 32;
+    }
+  }
+  for (int i = 0; i < 8; i++) {
+    r[i] = t[i];
+  }
+}
+
+// Shift left by any number of bits (256 or more gives 0), with the
+// barrel shifter in uint256_limbs.h.
+static void lshift_kernel(uint32_t r[8], const uint32_t a[8],
+                          unsigned shift) {
+  lshift_words(r, a, shift);
+}
+
+const UInt256Kernels uint256_generic_kernels = {
+    add_kernel,
+    sub_kernel,
+    mul_kernel,
+    lshift_kernel,
+};
 
 // Create a UInt256 value from a single uint32_t value.
 // Only the least-significant 32 bits are initialized directly,
@@ -31,86 +201,227 @@ UInt256 uint256_create(const uint32_t data[8]) {
   return result;
 }
 
+// Value of each hex digit character, or 0x80 for characters that
+// aren't hex digits
+#define XX 0x80
+static const uint8_t hex_value[256] = {
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, XX, XX, XX, XX, XX, XX,
+    XX, 10, 11, 12, 13, 14, 15, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, 10, 11, 12, 13, 14, 15, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+};
+#undef XX
+
 // Create a UInt256 value from a string of hexadecimal digits.
 UInt256 uint256_create_from_hex(const char *hex) {
   UInt256 result;
-  int len = strlen(hex);
-  const char *start;
-  int count;
-  int remain;
-  // if length is greater than 64, use the rightmost 64
-  if (len > 64) {
-    start = hex + len - 64;
-    count = 8;
-    remain = 0;
-  } else {
-    start = hex;
-    count = len / 8;
-    remain = len % 8;
+  uint256_parse_hex(hex, strlen(hex), &result);
+  return result;
+}
+
+// Parse exactly len characters of hex digits into *result.
+// Each limb is assembled from (up to) 8 table lookups, working from the
+// right end of the string; invalid characters are detected by OR-ing
+// all of the table values together and checking the 0x80 bit once at
+// the end, so the loop has no data-dependent branches.
+int uint256_parse_hex(const char *hex, size_t len, UInt256 *result) {
+  const unsigned char *s = (const unsigned char *)hex;
+  uint8_t bad = (len == 0) ? 0x80 : 0;
+
+  // characters beyond the rightmost 64 are validated but ignored
+  size_t skip = len > 64 ? len - 64 : 0;
+  for (size_t i = 0; i < skip; i++) {
+    bad |= hex_value[s[i]];
   }
-  // start from the rightmost 8 char, initailize uint256 value
-  int idx = 0;
-  while (idx < count) {
-    char hex_str[9];
-    strncpy(hex_str, start + remain + (count - idx - 1) * 8, 8);
-    hex_str[8] = '\0';
-    result.data[idx] = strtoul(hex_str, NULL, 16);
-    idx += 1;
+  s += skip;
+  len -= skip;
+
+  for (int idx = 0; idx < 8; idx++) {
+    uint32_t limb = 0;
+    size_t end = len > (size_t)idx * 8 ? len - (size_t)idx * 8 : 0;
+    size_t start = end > 8 ? end - 8 : 0;
+    for (size_t i = start; i < end; i++) {
+      uint8_t v = hex_value[s[i]];
+      bad |= v;
+      limb = (limb << 4) | (v & 0xF);
+    }
+    result->data[idx] = limb;
   }
-  if (remain != 0 && idx < 8) {
-    char hex_str[remain + 1];
-    strncpy(hex_str, start, remain);
-    hex_str[remain] = '\0';
-    result.data[idx] = strtoul(hex_str, NULL, 16);
-    idx += 1;
+
+  if (bad & 0x80) {
+    *result = uint256_create_from_u32(0);
+    return 0;
   }
-  // fill 0 for the uninitailized part
-  while (idx < 8) {
-    result.data[idx] = 0;
-    idx += 1;
+  return 1;
+}
+
+// Number of hex digits needed to represent val (at least 1).
+static size_t hex_length(const UInt256 *val) {
+  unsigned bits = uint256_bit_length(*val);
+  return bits == 0 ? 1 : (bits + 3) / 4;
+}
+
+// Write the low len hex digits of val to dst, most significant first.
+static void write_hex(const UInt256 *val, char *dst, size_t len) {
+  static const char digits[16] = "0123456789abcdef";
+  for (size_t k = 0; k < len; k++) {
+    uint32_t limb = val->data[k / 8];
+    dst[len - 1 - k] = digits[(limb >> ((k % 8) * 4)) & 0xF];
   }
-  return result;
 }
 
 // Return a dynamically-allocated string of hex digits representing the
 // given UInt256 value.
 char *uint256_format_as_hex(UInt256 val) {
-  char *hex = NULL;
-  // find the part of uint256 to start
-  int idx = 7;
-  while (idx >= 0 && val.data[idx] == 0) {
-    idx--;
-  }
-  // if uint256 value is 0, output "0"
-  if (idx == -1) {
-    hex = malloc(2);
-    strcpy(hex, "0");
-    return hex;
-  }
-  // get the hex string for each part
-  char *strings[idx + 1];
-  int sum_len = 0;
-  for (int i = 0; i <= idx; i++) {
-    strings[i] = malloc(9);
-    uint32_t value = val.data[idx - i];
-    if (i == 0) {
-      sprintf(strings[i], "%x", value);
-      sum_len += strlen(strings[i]);
+  size_t len = hex_length(&val);
+  char *hex = malloc(len + 1);
+  write_hex(&val, hex, len);
+  hex[len] = '\0';
+  return hex;
+}
+
+// Write the hex digits representing the given UInt256 value into buf.
+size_t uint256_format_as_hex_into(UInt256 val, char *buf, size_t cap) {
+  size_t len = hex_length(&val);
+  if (len + 1 > cap) {
+    if (cap > 0) {
+      buf[0] = '\0';
+    }
+    return len;
+  }
+  write_hex(&val, buf, len);
+  buf[len] = '\0';
+  return len;
+}
+
+// Format an array of UInt256 values into buf as hex, one per line.
+size_t uint256_format_as_hex_batch(const UInt256 *vals, size_t n, char *buf,
+                                   size_t cap) {
+  size_t pos = 0;
+  int full = 0;
+  for (size_t i = 0; i < n; i++) {
+    size_t len = hex_length(&vals[i]);
+    // room for the digits, the newline and the final terminator
+    if (!full && pos + len + 2 <= cap) {
+      write_hex(&vals[i], buf + pos, len);
+      buf[pos + len] = '\n';
     } else {
-      sprintf(strings[i], "%08x", value);
-      sum_len += 8;
+      // terminate after the last value that fit
+      if (!full && cap > 0) {
+        buf[pos] = '\0';
+      }
+      full = 1;
     }
+    pos += len + 1;
   }
-  // combine the hex strings together as a output
-  hex = malloc(sum_len + 1);
-  strcpy(hex, strings[0]);
-  for (int i = 1; i <= idx; i++) {
-    strcat(hex, strings[i]);
+  if (!full && cap > 0) {
+    buf[pos] = '\0';
   }
-  for (int i = 0; i <= idx; i++) {
-    free(strings[i]);
+  return pos;
+}
+
+// Largest power of ten that fits in a 32-bit limb, and the digits in it
+#define DEC_CHUNK_BASE 1000000000U
+#define DEC_CHUNK_DIGITS 9
+
+// Create a UInt256 value from a string of decimal digits.
+UInt256 uint256_create_from_dec(const char *dec) {
+  UInt256 result;
+  uint256_parse_dec(dec, strlen(dec), &result);
+  return result;
+}
+
+// Parse exactly len characters of decimal digits into *result.
+// Digits are consumed 9 at a time: each chunk is converted with native
+// 32-bit arithmetic and folded in with a single val = val*10^k + chunk
+// pass over the limbs. As in uint256_parse_hex, invalid characters are
+// only checked once at the end, from a flag OR-ed together per digit.
+int uint256_parse_dec(const char *dec, size_t len, UInt256 *result) {
+  const unsigned char *s = (const unsigned char *)dec;
+  uint32_t bad = (len == 0);
+  UInt256 val = uint256_create_from_u32(0);
+  // the first chunk takes the leftover digits so the rest are full
+  size_t chunk_len = len % DEC_CHUNK_DIGITS;
+  if (chunk_len == 0) {
+    chunk_len = DEC_CHUNK_DIGITS;
   }
-  return hex;
+
+  size_t pos = 0;
+  while (pos < len) {
+    uint32_t chunk = 0;
+    uint32_t scale = 1;
+    for (size_t i = 0; i < chunk_len; i++) {
+      uint32_t digit = (uint32_t)s[pos + i] - '0';
+      bad |= digit > 9;
+      chunk = chunk * 10 + digit;
+      scale *= 10;
+    }
+    pos += chunk_len;
+    chunk_len = DEC_CHUNK_DIGITS;
+
+    val = uint256_mul_add_u32(val, scale, chunk);
+  }
+
+  if (bad) {
+    *result = uint256_create_from_u32(0);
+    return 0;
+  }
+  *result = val;
+  return 1;
+}
+
+// Return a dynamically-allocated string of decimal digits representing
+// the given UInt256 value.
+// Peels off 9 digits per uint256_divmod_u32 call (at most 9 calls for
+// the 78 digits of 2^256 - 1), then writes the chunks out
+// most-significant first.
+char *uint256_format_as_dec(UInt256 val) {
+  uint32_t chunks[9];
+  int nchunks = 0;
+  do {
+    val = uint256_divmod_u32(val, DEC_CHUNK_BASE, &chunks[nchunks]);
+    nchunks++;
+  } while (val.data[0] | val.data[1] | val.data[2] | val.data[3] |
+           val.data[4] | val.data[5] | val.data[6] | val.data[7]);
+
+  char *dec = malloc(nchunks * DEC_CHUNK_DIGITS + 1);
+  char *p = dec;
+
+  // the leading chunk is written without zero padding
+  char tmp[DEC_CHUNK_DIGITS];
+  int n = 0;
+  uint32_t top = chunks[nchunks - 1];
+  do {
+    tmp[n++] = (char)('0' + top % 10);
+    top /= 10;
+  } while (top != 0);
+  while (n > 0) {
+    *p++ = tmp[--n];
+  }
+
+  // the remaining chunks are exactly 9 digits each
+  for (int i = nchunks - 2; i >= 0; i--) {
+    uint32_t chunk = chunks[i];
+    for (int j = DEC_CHUNK_DIGITS - 1; j >= 0; j--) {
+      p[j] = (char)('0' + chunk % 10);
+      chunk /= 10;
+    }
+    p += DEC_CHUNK_DIGITS;
+  }
+  *p = '\0';
+  return dec;
 }
 
 // Get 32 bits of data from a UInt256 value.
@@ -133,88 +444,492 @@ int uint256_is_bit_set(UInt256 val, unsigned index) {
 // Compute the sum of two UInt256 values.
 UInt256 uint256_add(UInt256 left, UInt256 right) {
   UInt256 sum;
-  int overflow = 0;
-  for (int i = 0; i < 8; i++) {
-    uint32_t leftpart = left.data[i];
-    uint32_t rightpart = right.data[i];
-    uint32_t total = leftpart + rightpart + overflow;
-    sum.data[i] = total;
-    // check whether there is an overflow
-    if ((overflow == 0 && total < leftpart) ||
-        (overflow == 1 && total <= leftpart)) {
-      overflow = 1;
-    } else {
-      overflow = 0;
-    }
-  }
+  uint256_kernels->add(sum.data, left.data, right.data);
   return sum;
 }
 
 // Compute the difference of two UInt256 values.
 UInt256 uint256_sub(UInt256 left, UInt256 right) {
   UInt256 result;
-  // TODO: implement
-  UInt256 nright = uint256_negate(right);
-  result = uint256_add(left, nright);
+  uint256_kernels->sub(result.data, left.data, right.data);
   return result;
 }
 
 // Return the two's-complement negation of the given UInt256 value.
 UInt256 uint256_negate(UInt256 val) {
   UInt256 result;
+  negate_kernel(result.data, val.data);
+  return result;
+}
+
+// Compute the product of two UInt256 values.
+UInt256 uint256_mul(UInt256 left, UInt256 right) {
+  UInt256 product;
+  uint256_mul_to(&product, &left, &right);
+  return product;
+}
+
+// Compute the full 512-bit product of two UInt256 values.
+// The most-significant 256 bits are stored in *hi and the
+// least-significant 256 bits in *lo.
+void uint256_mul_wide(UInt256 left, UInt256 right, UInt256 *hi, UInt256 *lo) {
+  uint32_t r[16] = {0};
 
-  // Inverting all bits
   for (int i = 0; i < 8; i++) {
-    result.data[i] = ~val.data[i]; // negating all bits for each uint32
+    uint64_t carry = 0;
+    uint64_t l = left.data[i];
+    for (int j = 0; j < 8; j++) {
+      uint64_t t = l * right.data[j] + r[i + j] + carry;
+      r[i + j] = (uint32_t)t;
+      carry = t >> 32;
+    }
+    r[i + 8] = (uint32_t)carry;
   }
 
-  // Add 1 for 2's complement's negation
-  UInt256 one = uint256_create_from_u32(1);
-  result = uint256_add(result, one);
-  return result;
+  for (int i = 0; i < 8; i++) {
+    lo->data[i] = r[i];
+    hi->data[i] = r[i + 8];
+  }
 }
 
-// Compute the product of two UInt256 values.
-UInt256 uint256_mul(UInt256 left, UInt256 right) {
-  // Initialize the product with 0
-  UInt256 product = {0};
-  
-  // Iterate through all bits that has been set
-  for (int i = 0; i < 256; i ++){
-    if (uint256_is_bit_set(left, i)){
-      // left shifting 'right' by the bit position of the bit in 'left'
-      UInt256 temp = uint256_lshift(right, i);
-      product = uint256_add(product, temp);
+// Compute the square of a UInt256 value (truncated to 256 bits).
+// Each cross product a[i]*a[j] (i < j) appears twice in the square, so
+// it is computed once and the running sum is doubled before the
+// diagonal terms a[i]*a[i] are added in.
+UInt256 uint256_sqr(UInt256 val) {
+  uint32_t r[8] = {0};
+  const uint32_t *a = val.data;
+
+  // cross products that land in the low 256 bits
+  for (int i = 0; i < 4; i++) {
+    uint64_t carry = 0;
+    for (int j = i + 1; j < 8 - i; j++) {
+      uint64_t t = (uint64_t)a[i] * a[j] + r[i + j] + carry;
+      r[i + j] = (uint32_t)t;
+      carry = t >> 32;
     }
   }
 
-  return product;
+  // double them
+  for (int i = 7; i > 0; i--) {
+    r[i] = (r[i] << 1) | (r[i - 1] >> 31);
+  }
+  r[0] <<= 1;
+
+  // add the diagonal terms
+  uint64_t carry = 0;
+  for (int i = 0; i < 4; i++) {
+    uint64_t t = (uint64_t)a[i] * a[i] + r[2 * i] + carry;
+    r[2 * i] = (uint32_t)t;
+    t = (t >> 32) + r[2 * i + 1];
+    r[2 * i + 1] = (uint32_t)t;
+    carry = t >> 32;
+  }
+
+  return uint256_create(r);
 }
 
-UInt256 uint256_lshift(UInt256 val, unsigned shift) {
-  assert(shift < 256); // undefined behavior
+// Compute the full 512-bit square of a UInt256 value.
+// The most-significant 256 bits are stored in *hi and the
+// least-significant 256 bits in *lo.
+void uint256_sqr_wide(UInt256 val, UInt256 *hi, UInt256 *lo) {
+  uint32_t r[16] = {0};
+  const uint32_t *a = val.data;
+
+  // cross products a[i]*a[j] with i < j (28 of the 64 partial products)
+  for (int i = 0; i < 7; i++) {
+    uint64_t carry = 0;
+    for (int j = i + 1; j < 8; j++) {
+      uint64_t t = (uint64_t)a[i] * a[j] + r[i + j] + carry;
+      r[i + j] = (uint32_t)t;
+      carry = t >> 32;
+    }
+    r[i + 8] = (uint32_t)carry;
+  }
+
+  // double them
+  for (int i = 15; i > 0; i--) {
+    r[i] = (r[i] << 1) | (r[i - 1] >> 31);
+  }
+  r[0] <<= 1;
+
+  // add the diagonal terms
+  uint64_t carry = 0;
+  for (int i = 0; i < 8; i++) {
+    uint64_t t = (uint64_t)a[i] * a[i] + r[2 * i] + carry;
+    r[2 * i] = (uint32_t)t;
+    t = (t >> 32) + r[2 * i + 1];
+    r[2 * i + 1] = (uint32_t)t;
+    carry = t >> 32;
+  }
+
+  for (int i = 0; i < 8; i++) {
+    lo->data[i] = r[i];
+    hi->data[i] = r[i + 8];
+  }
+}
+
+// Divide num by a single 32-bit limb, returning the quotient and
+// storing the remainder in *rem (if rem is not NULL).
+// One 64-by-32 division per limb, from the most significant down.
+UInt256 uint256_divmod_u32(UInt256 num, uint32_t den, uint32_t *rem) {
+  assert(den != 0); // undefined behavior
+
+  UInt256 quot;
+  uint64_t r = 0;
+  for (int i = 7; i >= 0; i--) {
+    uint64_t cur = (r << 32) | num.data[i];
+    quot.data[i] = (uint32_t)(cur / den);
+    r = cur % den;
+  }
+  if (rem != NULL) {
+    *rem = (uint32_t)r;
+  }
+  return quot;
+}
+
+// Multiply a UInt256 value by a single 32-bit limb (truncated to 256
+// bits).
+UInt256 uint256_mul_u32(UInt256 val, uint32_t k) {
+  return uint256_mul_add_u32(val, k, 0);
+}
+
+// One 64-bit word of val * k + carry: two 32x32 products, each of
+// which fits in 64 bits together with the incoming carry.
+static inline uint64_t mul_add_word(uint64_t w, uint32_t k, uint64_t *carry) {
+  uint64_t lo = (uint64_t)(uint32_t)w * k + *carry;
+  uint64_t hi = (w >> 32) * k + (lo >> 32);
+  *carry = hi >> 32;
+  return (uint32_t)lo | (hi << 32);
+}
+
+// Compute val * k + addend (truncated to 256 bits).
+// One pass over the words; the addend simply starts off as the carry.
+UInt256 uint256_mul_add_u32(UInt256 val, uint32_t k, uint32_t addend) {
+  UInt256 result;
+  uint64_t carry = addend;
+  uint64_t w0 = mul_add_word(get_word(val.data, 0), k, &carry);
+  uint64_t w1 = mul_add_word(get_word(val.data, 1), k, &carry);
+  uint64_t w2 = mul_add_word(get_word(val.data, 2), k, &carry);
+  uint64_t w3 = mul_add_word(get_word(val.data, 3), k, &carry);
+  store_words(result.data, w0, w1, w2, w3);
+  return result;
+}
+
+// Add a 64-bit value to a UInt256 value (wrapping modulo 2^256).
+// Only the low word takes k; the other three just ripple the carry,
+// with no branch on whether it is still nonzero.
+UInt256 uint256_add_u64(UInt256 val, uint64_t k) {
+  UInt256 result;
+  uint64_t w0 = get_word(val.data, 0) + k;
+  uint64_t c = w0 < k;
+  uint64_t w1 = get_word(val.data, 1) + c;
+  c = w1 < c;
+  uint64_t w2 = get_word(val.data, 2) + c;
+  c = w2 < c;
+  uint64_t w3 = get_word(val.data, 3) + c;
+  store_words(result.data, w0, w1, w2, w3);
+  return result;
+}
+
+// Subtract a 64-bit value from a UInt256 value (wrapping modulo 2^256).
+UInt256 uint256_sub_u64(UInt256 val, uint64_t k) {
+  UInt256 result;
+  uint64_t x0 = get_word(val.data, 0), x1 = get_word(val.data, 1);
+  uint64_t x2 = get_word(val.data, 2), x3 = get_word(val.data, 3);
+  uint64_t b = x0 < k;
+  uint64_t w1 = x1 - b;
+  b = x1 < b;
+  uint64_t w2 = x2 - b;
+  b = x2 < b;
+  store_words(result.data, x0 - k, w1, w2, x3 - b);
+  return result;
+}
+
+// Divide num by den, storing the quotient in *quot and the remainder
+// in *rem (either may be NULL).
+// Knuth's Algorithm D (TAOCP vol. 2, 4.3.1) on 32-bit limbs: the
+// divisor is shifted so its top limb has the high bit set, which makes
+// the quotient-digit estimate from the top two limbs of the running
+// remainder at most 2 too large. Single-limb divisors take the
+// uint256_divmod_u32 fast path.
+void uint256_divmod(UInt256 num, UInt256 den, UInt256 *quot, UInt256 *rem) {
+  UInt256 q = {0};
+  UInt256 r = {0};
 
-  // Initializing the result with 0
-  UInt256 result = {0};
+  // number of significant limbs in each operand
+  int n = 8;
+  while (n > 0 && den.data[n - 1] == 0) {
+    n--;
+  }
+  assert(n > 0); // division by zero is undefined
+  int m = 8;
+  while (m > 0 && num.data[m - 1] == 0) {
+    m--;
+  }
+
+  if (n == 1) {
+    uint32_t r0;
+    q = uint256_divmod_u32(num, den.data[0], &r0);
+    r.data[0] = r0;
+  } else if (m < n) {
+    r = num;
+  } else {
+    // normalize so the top limb of the divisor has its high bit set
+    int s = __builtin_clz(den.data[n - 1]);
+    uint32_t vn[8];
+    uint32_t un[9];
+    // (shifting a 64-bit value by 32 - s keeps s == 0 well defined)
+    for (int i = n - 1; i > 0; i--) {
+      vn[i] = (den.data[i] << s) |
+              (uint32_t)((uint64_t)den.data[i - 1] >> (32 - s));
+    }
+    vn[0] = den.data[0] << s;
+    un[m] = (uint32_t)((uint64_t)num.data[m - 1] >> (32 - s));
+    for (int i = m - 1; i > 0; i--) {
+      un[i] = (num.data[i] << s) |
+              (uint32_t)((uint64_t)num.data[i - 1] >> (32 - s));
+    }
+    un[0] = num.data[0] << s;
 
-  int element_shift = shift / 32; // 32-bits element need to shift
-  int bits_shift = shift % 32;    // individual bits need to shift
+    for (int j = m - n; j >= 0; j--) {
+      // estimate the quotient digit from the top two remainder limbs
+      uint64_t top = ((uint64_t)un[j + n] << 32) | un[j + n - 1];
+      uint64_t qhat = top / vn[n - 1];
+      uint64_t rhat = top % vn[n - 1];
+      while (qhat > 0xFFFFFFFFU ||
+             qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])) {
+        qhat--;
+        rhat += vn[n - 1];
+        if (rhat > 0xFFFFFFFFU) {
+          break;
+        }
+      }
 
-  if (bits_shift > 0) {
-    for (int i = 7; i >= element_shift; i--) {
-      // shifting elements and bits
-      result.data[i] = val.data[i - element_shift] << bits_shift;
+      // multiply and subtract qhat * divisor from the remainder
+      int64_t borrow = 0;
+      uint64_t carry = 0;
+      for (int i = 0; i < n; i++) {
+        uint64_t p = qhat * vn[i] + carry;
+        carry = p >> 32;
+        int64_t t = (int64_t)un[i + j] - (int64_t)(uint32_t)p + borrow;
+        un[i + j] = (uint32_t)t;
+        borrow = t >> 32;
+      }
+      int64_t t = (int64_t)un[j + n] - (int64_t)carry + borrow;
+      un[j + n] = (uint32_t)t;
 
-      // handle overflow from the previous element
-      if ((i - element_shift) > 0) {
-        uint32_t overflow = val.data[i - element_shift - 1] >> (32 - bits_shift);
-        result.data[i] = result.data[i] | overflow; //bitwise OR
+      // the estimate was one too large: add the divisor back
+      if (t < 0) {
+        qhat--;
+        carry = 0;
+        for (int i = 0; i < n; i++) {
+          uint64_t sum = (uint64_t)un[i + j] + vn[i] + carry;
+          un[i + j] = (uint32_t)sum;
+          carry = sum >> 32;
+        }
+        un[j + n] += (uint32_t)carry;
       }
+      q.data[j] = (uint32_t)qhat;
     }
-  } else { // only shift elements (shift is divisible by 32)
-    for (int i = 7; i >= element_shift; i--) {
-      result.data[i] = val.data[i - element_shift];
+
+    // un now holds the normalized remainder
+    for (int i = 0; i < n - 1; i++) {
+      r.data[i] = (un[i] >> s) | (uint32_t)((uint64_t)un[i + 1] << (32 - s));
     }
+    r.data[n - 1] = un[n - 1] >> s;
+  }
+
+  if (quot != NULL) {
+    *quot = q;
+  }
+  if (rem != NULL) {
+    *rem = r;
+  }
+}
+
+// Shift given UInt256 value left by specified number of bits.
+// Any shift is allowed; shifts of 256 or more give 0.
+UInt256 uint256_lshift(UInt256 val, unsigned shift) {
+  UInt256 result;
+  uint256_kernels->lshift(result.data, val.data, shift);
+  return result;
+}
+
+// Shift given UInt256 value right by specified number of bits.
+// Any shift is allowed; shifts of 256 or more give 0.
+UInt256 uint256_rshift(UInt256 val, unsigned shift) {
+  UInt256 result;
+  rshift_words(result.data, val.data, shift, 0);
+  return result;
+}
+
+// Rotate given UInt256 value left by the specified number of bits.
+// Any shift is allowed; only shift % 256 matters.
+// As in lshift_words, but the word moves wrap around instead of
+// shifting in zeros, so no shift needs a special case.
+UInt256 uint256_rotl(UInt256 val, unsigned shift) {
+  uint64_t x0 = get_word(val.data, 0), x1 = get_word(val.data, 1);
+  uint64_t x2 = get_word(val.data, 2), x3 = get_word(val.data, 3);
+  uint64_t m = bit_mask(shift, 7);
+  uint64_t t0 = pick(m, x2, x0), t1 = pick(m, x3, x1);
+  uint64_t t2 = pick(m, x0, x2), t3 = pick(m, x1, x3);
+  m = bit_mask(shift, 6);
+  x0 = pick(m, t3, t0);
+  x1 = pick(m, t0, t1);
+  x2 = pick(m, t1, t2);
+  x3 = pick(m, t2, t3);
+  unsigned bits = shift % 64;
+  UInt256 result;
+  store_words(result.data, shld64(x0, x3, bits), shld64(x1, x0, bits),
+              shld64(x2, x1, bits), shld64(x3, x2, bits));
+  return result;
+}
+
+// Rotate given UInt256 value right by the specified number of bits.
+// Any shift is allowed; only shift % 256 matters.
+UInt256 uint256_rotr(UInt256 val, unsigned shift) {
+  return uint256_rotl(val, 256 - shift % 256);
+}
+
+// Compute the bitwise AND of two UInt256 values.
+UInt256 uint256_and(UInt256 left, UInt256 right) {
+  UInt256 result;
+  for (int i = 0; i < 8; i++) {
+    result.data[i] = left.data[i] & right.data[i];
+  }
+  return result;
+}
+
+// Compute the bitwise OR of two UInt256 values.
+UInt256 uint256_or(UInt256 left, UInt256 right) {
+  UInt256 result;
+  for (int i = 0; i < 8; i++) {
+    result.data[i] = left.data[i] | right.data[i];
   }
   return result;
 }
+
+// Compute the bitwise XOR of two UInt256 values.
+UInt256 uint256_xor(UInt256 left, UInt256 right) {
+  UInt256 result;
+  for (int i = 0; i < 8; i++) {
+    result.data[i] = left.data[i] ^ right.data[i];
+  }
+  return result;
+}
+
+// Compute the bitwise complement of a UInt256 value.
+UInt256 uint256_not(UInt256 val) {
+  UInt256 result;
+  for (int i = 0; i < 8; i++) {
+    result.data[i] = ~val.data[i];
+  }
+  return result;
+}
+
+// Compare two UInt256 values: returns -1, 0 or 1 as left is less than,
+// equal to or greater than right.
+// Both borrow chains (left - right and right - left) are run over all
+// limbs, so the time taken doesn't depend on where the values differ.
+int uint256_cmp(UInt256 left, UInt256 right) {
+  uint64_t lt = 0, gt = 0;
+  for (int i = 0; i < 8; i++) {
+    lt = ((uint64_t)left.data[i] - right.data[i] - lt) >> 63;
+    gt = ((uint64_t)right.data[i] - left.data[i] - gt) >> 63;
+  }
+  return (int)gt - (int)lt;
+}
+
+// Compare a UInt256 value with a 64-bit value: returns -1, 0 or 1 as
+// left is less than, equal to or greater than right.
+// Any nonzero limb above the low two makes left the larger; otherwise
+// the low 64 bits decide.
+int uint256_cmp_u64(UInt256 left, uint64_t right) {
+  uint32_t high = 0;
+  for (int i = 2; i < 8; i++) {
+    high |= left.data[i];
+  }
+  uint64_t low = (uint64_t)left.data[0] | ((uint64_t)left.data[1] << 32);
+  if (high != 0) {
+    return 1;
+  }
+  return (low > right) - (low < right);
+}
+
+// Return 1 if the given UInt256 value is 0, 0 otherwise.
+int uint256_is_zero(UInt256 val) {
+  uint32_t any = 0;
+  for (int i = 0; i < 8; i++) {
+    any |= val.data[i];
+  }
+  return any == 0;
+}
+
+// Return the number of bits set in the given UInt256 value.
+unsigned uint256_popcount(UInt256 val) {
+  unsigned count = 0;
+  for (int i = 0; i < 8; i++) {
+    count += __builtin_popcount(val.data[i]);
+  }
+  return count;
+}
+
+// Return the number of leading (most-significant) zero bits in the
+// given UInt256 value, or 256 if the value is 0.
+// found becomes all ones at the first nonzero limb, which masks out
+// the counts of every limb below it.
+unsigned uint256_clz(UInt256 val) {
+  unsigned count = 0, found = 0;
+  for (int i = 7; i >= 0; i--) {
+    uint32_t limb = val.data[i];
+    unsigned lz = limb != 0 ? (unsigned)__builtin_clz(limb) : 32;
+    count += lz & ~found;
+    found |= -(unsigned)(limb != 0);
+  }
+  return count;
+}
+
+// Return the number of trailing (least-significant) zero bits in the
+// given UInt256 value, or 256 if the value is 0.
+unsigned uint256_ctz(UInt256 val) {
+  unsigned count = 0, found = 0;
+  for (int i = 0; i < 8; i++) {
+    uint32_t limb = val.data[i];
+    unsigned tz = limb != 0 ? (unsigned)__builtin_ctz(limb) : 32;
+    count += tz & ~found;
+    found |= -(unsigned)(limb != 0);
+  }
+  return count;
+}
+
+// Return the number of bits needed to represent the given UInt256
+// value (the index of the highest set bit plus 1), or 0 if it is 0.
+unsigned uint256_bit_length(UInt256 val) {
+  return 256 - uint256_clz(val);
+}
+
+// *dst = *left + *right
+void uint256_add_to(UInt256 *dst, const UInt256 *left, const UInt256 *right) {
+  uint256_kernels->add(dst->data, left->data, right->data);
+}
+
+// *dst = *left - *right
+void uint256_sub_to(UInt256 *dst, const UInt256 *left, const UInt256 *right) {
+  uint256_kernels->sub(dst->data, left->data, right->data);
+}
+
+// *dst = -*val (two's complement)
+void uint256_negate_to(UInt256 *dst, const UInt256 *val) {
+  negate_kernel(dst->data, val->data);
+}
+
+// *dst = *left * *right (truncated to 256 bits)
+void uint256_mul_to(UInt256 *dst, const UInt256 *left, const UInt256 *right) {
+  uint256_kernels->mul(dst->data, left->data, right->data);
+}
+
+// *dst = *val << shift (0 for shifts of 256 or more)
+void uint256_lshift_to(UInt256 *dst, const UInt256 *val, unsigned shift) {
+  uint256_kernels->lshift(dst->data, val->data, shift);
+}
@@ -1,8 +1,13 @@
 #ifndef UINT256_H
 #define UINT256_H
 
+#include <stddef.h>
 #include <stdint.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 // Data type representing a 256-bit unsigned integer, represented
 // as an array of 8 uint32_t values. It is expected that the value
 // at index 0 is the least significant, and the value at index 7
@@ -25,12 +30,62 @@ UInt256 uint256_create_from_u32( uint32_t val );
 UInt256 uint256_create( const uint32_t data[8] );
 
 // Create a UInt256 value from a string of hexadecimal digits.
+// If the string is empty or contains a character that is not a hex
+// digit, the result is 0 (use uint256_parse_hex to detect this).
 UInt256 uint256_create_from_hex( const char *hex );
 
+// Parse exactly len characters of hex digits (upper or lower case)
+// into *result. The input does not need to be NUL-terminated.
+// If there are more than 64 digits, only the rightmost 64 are used.
+//
+// Returns:
+//   1 if successful, 0 if len is 0 or any character is not a hex
+//   digit (in which case *result is set to 0)
+int uint256_parse_hex( const char *hex, size_t len, UInt256 *result );
+
 // Return a dynamically-allocated string of hex digits representing the
 // given UInt256 value.
 char *uint256_format_as_hex( UInt256 val );
 
+// Buffer size (including the NUL terminator) that is always large
+// enough for uint256_format_as_hex_into.
+#define UINT256_HEX_BUFSIZE 65
+
+// Write the hex digits representing the given UInt256 value into buf,
+// followed by a NUL terminator, without allocating memory.
+// Returns the number of digits (not counting the terminator). If cap is
+// too small to hold the digits and the terminator, nothing is written
+// except an empty string (when cap > 0), and the return value is the
+// length that would have been needed.
+size_t uint256_format_as_hex_into( UInt256 val, char *buf, size_t cap );
+
+// Format an array of n UInt256 values into buf as hex, one value per
+// line (each followed by '\n'), with a single NUL terminator at the end.
+// Returns the total number of characters (not counting the terminator).
+// If the return value is >= cap, the output did not fit and only the
+// values that fit completely were written.
+size_t uint256_format_as_hex_batch( const UInt256 *vals, size_t n, char *buf,
+                                    size_t cap );
+
+// Create a UInt256 value from a string of decimal digits.
+// Values that don't fit in 256 bits are reduced modulo 2^256.
+// If the string is empty or contains a character that is not a decimal
+// digit, the result is 0 (use uint256_parse_dec to detect this).
+UInt256 uint256_create_from_dec( const char *dec );
+
+// Parse exactly len characters of decimal digits into *result.
+// The input does not need to be NUL-terminated. Values that don't fit
+// in 256 bits are reduced modulo 2^256.
+//
+// Returns:
+//   1 if successful, 0 if len is 0 or any character is not a decimal
+//   digit (in which case *result is set to 0)
+int uint256_parse_dec( const char *dec, size_t len, UInt256 *result );
+
+// Return a dynamically-allocated string of decimal digits representing
+// the given UInt256 value.
+char *uint256_format_as_dec( UInt256 val );
+
 // Get 32 bits of data from a UInt256 value.
 // Index 0 is the least significant 32 bits, index 7 is the most
 // significant 32 bits.
@@ -51,7 +106,120 @@ UInt256 uint256_negate( UInt256 val );
 // Compute the product of two UInt256 values.
 UInt256 uint256_mul( UInt256 left, UInt256 right );
 
+// Compute the full 512-bit product of two UInt256 values.
+// The most-significant 256 bits are stored in *hi and the
+// least-significant 256 bits in *lo.
+void uint256_mul_wide( UInt256 left, UInt256 right, UInt256 *hi, UInt256 *lo );
+
+// Compute the square of a UInt256 value (truncated to 256 bits).
+UInt256 uint256_sqr( UInt256 val );
+
+// Compute the full 512-bit square of a UInt256 value.
+// The most-significant 256 bits are stored in *hi and the
+// least-significant 256 bits in *lo.
+void uint256_sqr_wide( UInt256 val, UInt256 *hi, UInt256 *lo );
+
+// Divide num by den, storing the quotient in *quot and the remainder
+// in *rem. Either output pointer may be NULL if that result is not
+// needed. Division by zero is undefined.
+void uint256_divmod( UInt256 num, UInt256 den, UInt256 *quot, UInt256 *rem );
+
+// Divide num by a single 32-bit limb, returning the quotient and
+// storing the remainder in *rem (if rem is not NULL).
+// Division by zero is undefined.
+UInt256 uint256_divmod_u32( UInt256 num, uint32_t den, uint32_t *rem );
+
+// Multiply a UInt256 value by a single 32-bit limb (truncated to 256
+// bits).
+UInt256 uint256_mul_u32( UInt256 val, uint32_t k );
+
+// Compute val * k + addend for a single 32-bit limb k and addend
+// (truncated to 256 bits), e.g. to append a digit in base k.
+UInt256 uint256_mul_add_u32( UInt256 val, uint32_t k, uint32_t addend );
+
+// Add a 64-bit value to a UInt256 value (wrapping modulo 2^256).
+UInt256 uint256_add_u64( UInt256 val, uint64_t k );
+
+// Subtract a 64-bit value from a UInt256 value (wrapping modulo 2^256).
+UInt256 uint256_sub_u64( UInt256 val, uint64_t k );
+
 // Shift given UInt256 value left by specified number of bits.
+// Any shift is allowed; shifts of 256 or more give 0.
 UInt256 uint256_lshift( UInt256 val, unsigned shift );
 
+// Shift given UInt256 value right by specified number of bits.
+// Any shift is allowed; shifts of 256 or more give 0.
+UInt256 uint256_rshift( UInt256 val, unsigned shift );
+
+// Rotate given UInt256 value left by the specified number of bits.
+// Any shift is allowed; only shift % 256 matters.
+UInt256 uint256_rotl( UInt256 val, unsigned shift );
+
+// Rotate given UInt256 value right by the specified number of bits.
+// Any shift is allowed; only shift % 256 matters.
+UInt256 uint256_rotr( UInt256 val, unsigned shift );
+
+// Compute the bitwise AND of two UInt256 values.
+UInt256 uint256_and( UInt256 left, UInt256 right );
+
+// Compute the bitwise OR of two UInt256 values.
+UInt256 uint256_or( UInt256 left, UInt256 right );
+
+// Compute the bitwise XOR of two UInt256 values.
+UInt256 uint256_xor( UInt256 left, UInt256 right );
+
+// Compute the bitwise complement of a UInt256 value.
+UInt256 uint256_not( UInt256 val );
+
+// Compare two UInt256 values: returns -1, 0 or 1 as left is less than,
+// equal to or greater than right.
+int uint256_cmp( UInt256 left, UInt256 right );
+
+// Compare a UInt256 value with a 64-bit value: returns -1, 0 or 1 as
+// left is less than, equal to or greater than right.
+int uint256_cmp_u64( UInt256 left, uint64_t right );
+
+// Return 1 if the given UInt256 value is 0, 0 otherwise.
+int uint256_is_zero( UInt256 val );
+
+// Return the number of bits set in the given UInt256 value.
+unsigned uint256_popcount( UInt256 val );
+
+// Return the number of leading (most-significant) zero bits in the
+// given UInt256 value, or 256 if the value is 0.
+unsigned uint256_clz( UInt256 val );
+
+// Return the number of trailing (least-significant) zero bits in the
+// given UInt256 value, or 256 if the value is 0.
+unsigned uint256_ctz( UInt256 val );
+
+// Return the number of bits needed to represent the given UInt256
+// value (the index of the highest set bit plus 1), or 0 if it is 0.
+unsigned uint256_bit_length( UInt256 val );
+
+// Pointer-based variants of the arithmetic functions above. Each one
+// stores its result in *dst instead of returning it, which avoids
+// copying 32-byte structs through the stack in chained expressions.
+// dst may point to the same value as any of the operands (e.g.
+// uint256_add_to( &acc, &acc, &x ) accumulates in place).
+
+// *dst = *left + *right
+void uint256_add_to( UInt256 *dst, const UInt256 *left, const UInt256 *right );
+
+// *dst = *left - *right
+void uint256_sub_to( UInt256 *dst, const UInt256 *left, const UInt256 *right );
+
+// *dst = -*val (two's complement)
+void uint256_negate_to( UInt256 *dst, const UInt256 *val );
+
+// *dst = *left * *right (truncated to 256 bits)
+void uint256_mul_to( UInt256 *dst, const UInt256 *left, const UInt256 *right );
+
+// *dst = *val << shift (0 for shifts of 256 or more)
+void uint256_lshift_to( UInt256 *dst, const UInt256 *val, unsigned shift );
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif // UINT256_H
@@ -0,0 +1,142 @@
+#include "uint256_acc.h"
+#include <stdint.h>
+#include <string.h>
+#include "uint256_kernels.h"
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(UINT256_PORTABLE)
+#define UINT256_ACC_AVX2 1
+#include <immintrin.h>
+#endif
+
+// After normalization every lane is below 2^32, and each addition adds
+// at most 2^32 to a lane (a limb, or ~limb + 1 in lane 0 for a
+// subtraction). So after UINT256_ACC_MAX_PENDING additions a lane is
+// below 2^32 * (UINT256_ACC_MAX_PENDING + 1) = 2^64 - 2^32, which
+// leaves room for the incoming carry while normalizing.
+
+// Propagate the carries so that every lane is below 2^32 again.
+// Whatever carries out of the top lane is beyond 2^256 and dropped.
+static void normalize(uint64_t lanes[8]) {
+  uint64_t carry = 0;
+  for (int i = 0; i < 8; i++) {
+    uint64_t t = lanes[i] + carry;
+    lanes[i] = (uint32_t)t;
+    carry = t >> 32;
+  }
+}
+
+// Make room for n more additions.
+static void reserve(UInt256Acc *acc, uint32_t n) {
+  if (acc->pending > UINT256_ACC_MAX_PENDING - n) {
+    normalize(acc->lanes);
+    acc->pending = 0;
+  }
+  acc->pending += n;
+}
+
+// Initialize an accumulator to 0.
+void uint256_acc_init(UInt256Acc *acc) {
+  memset(acc->lanes, 0, sizeof(acc->lanes));
+  acc->pending = 0;
+}
+
+// Add a value to an accumulator.
+void uint256_acc_add(UInt256Acc *acc, UInt256 val) {
+  reserve(acc, 1);
+  for (int i = 0; i < 8; i++) {
+    acc->lanes[i] += val.data[i];
+  }
+}
+
+// Subtract a value from an accumulator, by adding ~val + 1.
+void uint256_acc_sub(UInt256Acc *acc, UInt256 val) {
+  reserve(acc, 1);
+  for (int i = 0; i < 8; i++) {
+    acc->lanes[i] += (uint32_t)~val.data[i];
+  }
+  acc->lanes[0] += 1;
+}
+
+#ifdef UINT256_ACC_AVX2
+
+#define AVX2 __attribute__((target("avx2")))
+
+// The lanes live in two registers of four 64-bit lanes. Each value is
+// zero-extended from 32-bit limbs straight from memory (VPMOVZXDQ) and
+// added in, so a value costs two loads and two additions.
+AVX2 static void add_n_avx2(uint64_t lanes[8], const UInt256 *vals,
+                            size_t n) {
+  __m256i lo = _mm256_loadu_si256((const __m256i *)lanes);
+  __m256i hi = _mm256_loadu_si256((const __m256i *)(lanes + 4));
+  for (size_t k = 0; k < n; k++) {
+    __m128i vlo = _mm_loadu_si128((const __m128i *)vals[k].data);
+    __m128i vhi = _mm_loadu_si128((const __m128i *)(vals[k].data + 4));
+    lo = _mm256_add_epi64(lo, _mm256_cvtepu32_epi64(vlo));
+    hi = _mm256_add_epi64(hi, _mm256_cvtepu32_epi64(vhi));
+  }
+  _mm256_storeu_si256((__m256i *)lanes, lo);
+  _mm256_storeu_si256((__m256i *)(lanes + 4), hi);
+}
+
+#undef AVX2
+
+static int have_avx2(void) {
+  return (uint256_cpu_features() & UINT256_CPU_AVX2) != 0;
+}
+
+#endif // UINT256_ACC_AVX2
+
+static void add_n_generic(uint64_t lanes[8], const UInt256 *vals, size_t n) {
+  for (size_t k = 0; k < n; k++) {
+    for (int i = 0; i < 8; i++) {
+      lanes[i] += vals[k].data[i];
+    }
+  }
+}
+
+// Add vals[0], ..., vals[n-1] to an accumulator, in runs that fit in
+// the lanes' headroom.
+void uint256_acc_add_n(UInt256Acc *acc, const UInt256 *vals, size_t n) {
+#ifdef UINT256_ACC_AVX2
+  int avx2 = have_avx2();
+#endif
+  while (n > 0) {
+    uint32_t run = n < UINT256_ACC_MAX_PENDING ? (uint32_t)n
+                                               : UINT256_ACC_MAX_PENDING;
+    reserve(acc, run);
+#ifdef UINT256_ACC_AVX2
+    if (avx2) {
+      add_n_avx2(acc->lanes, vals, run);
+    } else
+#endif
+    {
+      add_n_generic(acc->lanes, vals, run);
+    }
+    vals += run;
+    n -= run;
+  }
+}
+
+// Add the sum held by another accumulator to acc. A normalized copy of
+// other has every lane below 2^32, so it counts as one addition.
+void uint256_acc_merge(UInt256Acc *acc, const UInt256Acc *other) {
+  uint64_t lanes[8];
+  memcpy(lanes, other->lanes, sizeof(lanes));
+  normalize(lanes);
+  reserve(acc, 1);
+  for (int i = 0; i < 8; i++) {
+    acc->lanes[i] += lanes[i];
+  }
+}
+
+// Return the sum held by an accumulator (modulo 2^256).
+UInt256 uint256_acc_get(const UInt256Acc *acc) {
+  uint64_t lanes[8];
+  memcpy(lanes, acc->lanes, sizeof(lanes));
+  normalize(lanes);
+  UInt256 sum;
+  for (int i = 0; i < 8; i++) {
+    sum.data[i] = (uint32_t)lanes[i];
+  }
+  return sum;
+}
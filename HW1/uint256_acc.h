@@ -0,0 +1,54 @@
+#ifndef UINT256_ACC_H
+#define UINT256_ACC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "uint256.h"
+
+// Carry-save accumulator for summing long streams of UInt256 values
+// (modulo 2^256, like uint256_add).
+//
+// Each 32-bit limb is summed into its own 64-bit lane, and carries
+// between lanes are only propagated when the value is read (or when
+// the lanes are about to run out of headroom), so adding a value is
+// eight independent additions with no carry chain.
+//
+// Accumulators are independent of each other: to sum an array on
+// several threads, give each thread its own accumulator for its part
+// of the array and combine them afterwards with uint256_acc_merge.
+
+// Number of additions after which the lanes are normalized (carries
+// propagated) so that they can't overflow.
+#define UINT256_ACC_MAX_PENDING 0xfffffffeU
+
+typedef struct {
+  // lanes[i] is the (not yet carried) sum for limb i
+  uint64_t lanes[8];
+  // additions since the lanes were last normalized
+  uint32_t pending;
+} UInt256Acc;
+
+// Initialize an accumulator to 0.
+void uint256_acc_init( UInt256Acc *acc );
+
+// Add a value to an accumulator.
+void uint256_acc_add( UInt256Acc *acc, UInt256 val );
+
+// Subtract a value from an accumulator. This costs the same as an
+// addition: -val is ~val + 1, and ~val needs no carries.
+void uint256_acc_sub( UInt256Acc *acc, UInt256 val );
+
+// Add vals[0], ..., vals[n-1] to an accumulator. Uses AVX2 when the
+// CPU supports it.
+void uint256_acc_add_n( UInt256Acc *acc, const UInt256 *vals, size_t n );
+
+// Add the sum held by another accumulator to acc (other is not
+// changed). Merging is associative and commutative, so per-thread
+// accumulators can be merged in any order or as a tree.
+void uint256_acc_merge( UInt256Acc *acc, const UInt256Acc *other );
+
+// Return the sum held by an accumulator (modulo 2^256). The
+// accumulator is not changed, and can go on accumulating.
+UInt256 uint256_acc_get( const UInt256Acc *acc );
+
+#endif // UINT256_ACC_H
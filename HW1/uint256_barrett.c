@@ -0,0 +1,302 @@
+#include "uint256_barrett.h"
+#include <stdint.h>
+#include <string.h>
+#include "uint256_limbs.h"
+
+// The reduction works on 64-bit words (least significant first): a
+// 64x64-bit product is a single instruction on 64-bit targets, so the
+// products below take a quarter of the multiplies they would on the
+// 32-bit limbs.
+#ifdef __SIZEOF_INT128__
+__extension__ typedef unsigned __int128 u128;
+
+// Return the low 64 bits of a*b + c + *carry, storing the high 64 bits
+// in *carry (the sum always fits in 128 bits).
+static inline uint64_t mac64(uint64_t a, uint64_t b, uint64_t c,
+                             uint64_t *carry) {
+  u128 t = (u128)a * b + c + *carry;
+  *carry = (uint64_t)(t >> 64);
+  return (uint64_t)t;
+}
+#else
+static inline uint64_t mac64(uint64_t a, uint64_t b, uint64_t c,
+                             uint64_t *carry) {
+  uint64_t a0 = (uint32_t)a, a1 = a >> 32;
+  uint64_t b0 = (uint32_t)b, b1 = b >> 32;
+  uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+  uint64_t mid = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+  uint64_t hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+  uint64_t lo = (mid << 32) | (uint32_t)p00;
+  lo += c;
+  hi += lo < c;
+  lo += *carry;
+  hi += lo < *carry;
+  *carry = hi;
+  return lo;
+}
+#endif
+
+// On little-endian targets a 64-bit word is the same memory as two
+// consecutive 32-bit limbs, so it is copied directly; the copies are
+// kept one word at a time (see uint256_dispatch.c).
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+static void to_words(uint64_t w[4], const UInt256 *val) {
+  for (int i = 0; i < 4; i++) {
+    memcpy(&w[i], &val->data[2 * i], 8);
+  }
+}
+
+static UInt256 from_words(const uint64_t w[4]) {
+  UInt256 val;
+  for (int i = 0; i < 4; i++) {
+    memcpy(&val.data[2 * i], &w[i], 8);
+  }
+  return val;
+}
+#else
+static void to_words(uint64_t w[4], const UInt256 *val) {
+  for (int i = 0; i < 4; i++) {
+    w[i] = (uint64_t)val->data[2 * i] | ((uint64_t)val->data[2 * i + 1] << 32);
+  }
+}
+
+static UInt256 from_words(const uint64_t w[4]) {
+  UInt256 val;
+  for (int i = 0; i < 4; i++) {
+    val.data[2 * i] = (uint32_t)w[i];
+    val.data[2 * i + 1] = (uint32_t)(w[i] >> 32);
+  }
+  return val;
+}
+#endif
+
+// r[0..3] += a*b[0..3], returning the word carried out of r[3].
+// This and the other four-word helpers below are written out in full:
+// kept as loops, compilers either leave them rolled or turn them into
+// vector code that reloads words which were just stored one at a time.
+static inline uint64_t mul_add_row(uint64_t r[4], uint64_t a,
+                                   const uint64_t b[4]) {
+  uint64_t carry = 0;
+  r[0] = mac64(a, b[0], r[0], &carry);
+  r[1] = mac64(a, b[1], r[1], &carry);
+  r[2] = mac64(a, b[2], r[2], &carry);
+  r[3] = mac64(a, b[3], r[3], &carry);
+  return carry;
+}
+
+// Return a + b + *carry, updating *carry (0 or 1).
+static inline uint64_t addc64(uint64_t a, uint64_t b, uint64_t *carry) {
+  uint64_t s = a + *carry;
+  uint64_t c = s < a;
+  s += b;
+  *carry = c | (s < b);
+  return s;
+}
+
+// Return a - b - *borrow, updating *borrow (0 or 1).
+static inline uint64_t subb64(uint64_t a, uint64_t b, uint64_t *borrow) {
+  uint64_t d = a - b;
+  uint64_t bo = a < b;
+  uint64_t r = d - *borrow;
+  *borrow = bo | (d < *borrow);
+  return r;
+}
+
+// r = a + b + carry over 4 words, returning the carry out.
+static inline uint64_t add4(uint64_t r[4], const uint64_t a[4],
+                            const uint64_t b[4], uint64_t carry) {
+  r[0] = addc64(a[0], b[0], &carry);
+  r[1] = addc64(a[1], b[1], &carry);
+  r[2] = addc64(a[2], b[2], &carry);
+  r[3] = addc64(a[3], b[3], &carry);
+  return carry;
+}
+
+// r = a - b over 4 words, returning the borrow out.
+static inline uint64_t sub4(uint64_t r[4], const uint64_t a[4],
+                            const uint64_t b[4]) {
+  uint64_t borrow = 0;
+  r[0] = subb64(a[0], b[0], &borrow);
+  r[1] = subb64(a[1], b[1], &borrow);
+  r[2] = subb64(a[2], b[2], &borrow);
+  r[3] = subb64(a[3], b[3], &borrow);
+  return borrow;
+}
+
+// Return 1 if a >= b, 0 otherwise (a - b doesn't borrow).
+static inline int geq4(const uint64_t a[4], const uint64_t b[4]) {
+  uint64_t borrow = 0;
+  subb64(a[0], b[0], &borrow);
+  subb64(a[1], b[1], &borrow);
+  subb64(a[2], b[2], &borrow);
+  subb64(a[3], b[3], &borrow);
+  return !borrow;
+}
+
+// Return the high word of (hi:lo) << bits, for bits < 64; two steps
+// keep bits == 0 well defined.
+static inline uint64_t shl_pair(uint64_t hi, uint64_t lo, unsigned bits) {
+  return (hi << bits) | ((lo >> 1) >> (63 - bits));
+}
+
+// Return the low word of (hi:lo) >> bits, for bits < 64.
+static inline uint64_t shr_pair(uint64_t hi, uint64_t lo, unsigned bits) {
+  return (lo >> bits) | ((hi << 1) << (63 - bits));
+}
+
+// Initialize a Barrett context for the given modulus.
+int uint256_barrett_init(UInt256BarrettCtx *ctx, UInt256 modulus) {
+  if (uint256_is_zero(modulus)) {
+    return 0;
+  }
+  ctx->modulus = modulus;
+  ctx->shift = uint256_clz(modulus);
+  ctx->norm = uint256_lshift(modulus, ctx->shift);
+
+  // 2^512 - 1 = 2^256*d + (~d)*2^256 + (2^256 - 1) for d = norm, and
+  // ~d < d, so the reciprocal is the quotient of that 512-bit remainder
+  // by d. It is only computed once, so plain shift-and-subtract long
+  // division (one quotient bit per step) is good enough; every bit
+  // shifted in from the low half is a 1.
+  const uint32_t *d = ctx->norm.data;
+  UInt256 rem = uint256_not(ctx->norm);
+  UInt256 quot = uint256_create_from_u32(0);
+  for (int i = 0; i < 256; i++) {
+    uint32_t top = rem.data[7] >> 31;
+    rem = uint256_lshift(rem, 1);
+    rem.data[0] |= 1U;
+    quot = uint256_lshift(quot, 1);
+    if (top || geq_limbs(rem.data, d)) {
+      sub_limbs(rem.data, rem.data, d);
+      quot.data[0] |= 1U;
+    }
+  }
+  ctx->recip = quot;
+  return 1;
+}
+
+// Reduce u[4..7]*2^256 + u[0..3] modulo the normalized modulus d, for
+// u[4..7] < d, storing the remainder in r.
+// This is the 2-by-1 division step of Moller and Granlund ("Improved
+// division by invariant integers", 2011) with 256-bit digits: the
+// quotient estimate comes from the high half of recip*u1, the
+// candidate remainder is only needed modulo 2^256, and the estimate is
+// off by at most one in either direction, which the two conditional
+// adjustments correct.
+static void reduce_norm(uint64_t r[4], const uint64_t u[8],
+                        const uint64_t d[4], const uint64_t recip[4]) {
+  const uint64_t *u1 = u + 4;
+  static const uint64_t zero[4] = {0};
+
+  // Zero high words of u1 and q1 are skipped, which makes reducing a
+  // 256-bit value (where u1 holds only the bits shifted out of it)
+  // much cheaper than a full 512-bit reduction.
+  int n1 = u1[3] ? 4 : u1[2] ? 3 : u1[1] ? 2 : u1[0] ? 1 : 0;
+
+  // (q1, q0) = recip*u1 + (u1, u0)
+  uint64_t q[8] = {0};
+  for (int i = 0; i < n1; i++) {
+    q[i + 4] = mul_add_row(q + i, u1[i], recip);
+  }
+  uint64_t carry = add4(q, q, u, 0);
+  add4(q + 4, q + 4, u1, carry);
+
+  // q1 += 1 (wrapping around is fine, the adjustments make up for it)
+  uint64_t *q1 = q + 4;
+  add4(q1, q1, zero, 1);
+  int nq = q1[3] ? 4 : q1[2] ? 3 : q1[1] ? 2 : q1[0] ? 1 : 0;
+
+  // r = u0 - q1*d mod 2^256 (the words of p above 2^256 are discarded)
+  uint64_t p[8] = {0};
+  for (int i = 0; i < nq; i++) {
+    p[i + 4] = mul_add_row(p + i, q1[i], d);
+  }
+  sub4(r, u, p);
+
+  // r > q0 means the estimate was one too large
+  if (!geq4(q, r)) {
+    add4(r, r, d, 0);
+  }
+  if (geq4(r, d)) {
+    sub4(r, r, d);
+  }
+}
+
+// Reduce the 512-bit value x[4..7]*2^256 + x[0..3] modulo m, for
+// x[4..7] < m, storing the remainder in r. The value is shifted left
+// along with the modulus, so the remainder of the normalized division
+// is shifted back at the end.
+static void reduce_words(const UInt256BarrettCtx *ctx, uint64_t r[4],
+                         const uint64_t x[8]) {
+  uint64_t u[8], d[4], recip[4];
+  to_words(d, &ctx->norm);
+  to_words(recip, &ctx->recip);
+  unsigned word_shift = ctx->shift / 64;
+  unsigned bits_shift = ctx->shift % 64;
+
+  // u = x << shift; x[4..7] < m keeps the result within 512 bits.
+  // The value is placed above some zero padding so that the word
+  // offsets need no range checks.
+  uint64_t pad[12] = {0};
+  for (int i = 0; i < 8; i++) {
+    pad[i + 4] = x[i];
+  }
+  const uint64_t *src = pad + 4 - word_shift;
+  u[0] = shl_pair(src[0], src[-1], bits_shift);
+  u[1] = shl_pair(src[1], src[0], bits_shift);
+  u[2] = shl_pair(src[2], src[1], bits_shift);
+  u[3] = shl_pair(src[3], src[2], bits_shift);
+  u[4] = shl_pair(src[4], src[3], bits_shift);
+  u[5] = shl_pair(src[5], src[4], bits_shift);
+  u[6] = shl_pair(src[6], src[5], bits_shift);
+  u[7] = shl_pair(src[7], src[6], bits_shift);
+
+  // r = rem >> shift, with rem[4..7] as the zero padding
+  uint64_t rem[8] = {0};
+  reduce_norm(rem, u, d, recip);
+  src = rem + word_shift;
+  r[0] = shr_pair(src[1], src[0], bits_shift);
+  r[1] = shr_pair(src[2], src[1], bits_shift);
+  r[2] = shr_pair(src[3], src[2], bits_shift);
+  r[3] = shr_pair(src[4], src[3], bits_shift);
+}
+
+// Reduce the 512-bit value hi*2^256 + lo modulo m.
+UInt256 uint256_barrett_reduce(const UInt256BarrettCtx *ctx, UInt256 hi,
+                               UInt256 lo) {
+  uint64_t x[8], r[4];
+  to_words(x, &lo);
+  to_words(x + 4, &hi);
+  if (geq_limbs(hi.data, ctx->modulus.data)) {
+    // the division step needs hi < m, so reduce the high half on its
+    // own first (as a 512-bit value with a high half of 0)
+    uint64_t y[8] = {0};
+    to_words(y, &hi);
+    reduce_words(ctx, x + 4, y);
+  }
+  reduce_words(ctx, r, x);
+  return from_words(r);
+}
+
+// Compute (a * b) mod m.
+// The 512-bit product is formed on 64-bit words too, so it goes
+// straight into the reduction without a round trip through UInt256.
+UInt256 uint256_barrett_mulmod(const UInt256BarrettCtx *ctx, UInt256 a,
+                               UInt256 b) {
+  uint64_t x[8] = {0}, aw[4], bw[4], m[4], r[4];
+  to_words(aw, &a);
+  to_words(bw, &b);
+  for (int i = 0; i < 4; i++) {
+    x[i + 4] = mul_add_row(x + i, aw[i], bw);
+  }
+  to_words(m, &ctx->modulus);
+  if (geq4(x + 4, m)) {
+    uint64_t y[8] = {0};
+    for (int i = 0; i < 4; i++) {
+      y[i] = x[i + 4];
+    }
+    reduce_words(ctx, x + 4, y);
+  }
+  reduce_words(ctx, r, x);
+  return from_words(r);
+}
@@ -0,0 +1,38 @@
+#ifndef UINT256_BARRETT_H
+#define UINT256_BARRETT_H
+
+#include "uint256.h"
+
+// Precomputed constants for reducing many values modulo the same
+// 256-bit modulus m, which (unlike for Montgomery arithmetic) may be
+// even.
+//
+// The modulus is shifted left until its top bit is set, and a
+// reciprocal of the shifted value is computed once. Each reduction
+// then estimates the quotient with one multiplication by the
+// reciprocal, and fixes up the estimate with at most two adjustments,
+// instead of running a long division.
+typedef struct {
+  UInt256 modulus; // m (must be nonzero)
+  UInt256 norm;    // m << shift, with the top bit set
+  UInt256 recip;   // floor((2^512 - 1) / norm) - 2^256
+  unsigned shift;  // number of leading zero bits in m
+} UInt256BarrettCtx;
+
+// Initialize a Barrett context for the given modulus.
+//
+// Returns:
+//   1 if successful, 0 if the modulus is 0
+int uint256_barrett_init( UInt256BarrettCtx *ctx, UInt256 modulus );
+
+// Reduce the 512-bit value hi*2^256 + lo modulo m.
+// Any value is accepted; it is cheapest when hi is already less than m,
+// as it is for the product of two reduced values.
+UInt256 uint256_barrett_reduce( const UInt256BarrettCtx *ctx, UInt256 hi,
+                                UInt256 lo );
+
+// Compute (a * b) mod m. The operands may be any 256-bit values.
+UInt256 uint256_barrett_mulmod( const UInt256BarrettCtx *ctx, UInt256 a,
+                                UInt256 b );
+
+#endif // UINT256_BARRETT_H
@@ -0,0 +1,415 @@
+#include "uint256_batch.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "uint256_kernels.h"
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(UINT256_PORTABLE)
+#define UINT256_BATCH_AVX2 1
+#include <immintrin.h>
+#endif
+
+#ifdef UINT256_BATCH_AVX2
+
+#define AVX2 __attribute__((target("avx2")))
+
+// All of the AVX2 kernels work on eight values at a time, with one
+// register holding the same limb of each value (one value per 32-bit
+// lane). Carries and borrows are kept as lane masks (0 or all ones),
+// so adding a carry is a subtraction of the mask. Each step handles
+// one limb, so the SoA kernels can stream limb by limb from memory
+// with only the carry kept in a register.
+
+// One limb of r = a + b across all eight lanes.
+AVX2 static inline __m256i add_step(__m256i a, __m256i b, __m256i *carry) {
+  const __m256i ones = _mm256_set1_epi32(-1);
+  __m256i s = _mm256_add_epi32(a, b);
+  // s < a (unsigned) iff max(s, a) != s
+  __m256i c1 = _mm256_xor_si256(
+      _mm256_cmpeq_epi32(_mm256_max_epu32(s, a), s), ones);
+  // adding the carry wraps iff s is all ones
+  __m256i c2 = _mm256_and_si256(_mm256_cmpeq_epi32(s, ones), *carry);
+  __m256i t = _mm256_sub_epi32(s, *carry);
+  *carry = _mm256_or_si256(c1, c2);
+  return t;
+}
+
+// One limb of r = a - b across all eight lanes.
+AVX2 static inline __m256i sub_step(__m256i a, __m256i b, __m256i *borrow) {
+  const __m256i ones = _mm256_set1_epi32(-1);
+  __m256i d = _mm256_sub_epi32(a, b);
+  // a < b (unsigned) iff max(a, b) != a
+  __m256i b1 = _mm256_xor_si256(
+      _mm256_cmpeq_epi32(_mm256_max_epu32(a, b), a), ones);
+  // subtracting the borrow wraps iff d == 0
+  __m256i b2 =
+      _mm256_and_si256(_mm256_cmpeq_epi32(d, _mm256_setzero_si256()), *borrow);
+  __m256i r = _mm256_add_epi32(d, *borrow);
+  *borrow = _mm256_or_si256(b1, b2);
+  return r;
+}
+
+// One limb of a -1/0/1 comparison of each lane. Limbs must be fed from
+// the top down; res only changes in lanes that are still undecided.
+AVX2 static inline __m256i cmp_step(__m256i a, __m256i b, __m256i res) {
+  __m256i mx = _mm256_max_epu32(a, b);
+  __m256i gt = _mm256_andnot_si256(_mm256_cmpeq_epi32(mx, b),
+                                   _mm256_set1_epi32(1));
+  __m256i lt = _mm256_andnot_si256(_mm256_cmpeq_epi32(mx, a),
+                                   _mm256_set1_epi32(-1));
+  __m256i undecided = _mm256_cmpeq_epi32(res, _mm256_setzero_si256());
+  return _mm256_or_si256(
+      res, _mm256_and_si256(_mm256_or_si256(gt, lt), undecided));
+}
+
+// Transpose an 8x8 matrix of 32-bit elements held in eight registers.
+// Converts between eight UInt256 values and eight limb vectors (the
+// operation is its own inverse).
+AVX2 static void transpose8(__m256i m[8]) {
+  __m256i t0 = _mm256_unpacklo_epi32(m[0], m[1]);
+  __m256i t1 = _mm256_unpackhi_epi32(m[0], m[1]);
+  __m256i t2 = _mm256_unpacklo_epi32(m[2], m[3]);
+  __m256i t3 = _mm256_unpackhi_epi32(m[2], m[3]);
+  __m256i t4 = _mm256_unpacklo_epi32(m[4], m[5]);
+  __m256i t5 = _mm256_unpackhi_epi32(m[4], m[5]);
+  __m256i t6 = _mm256_unpacklo_epi32(m[6], m[7]);
+  __m256i t7 = _mm256_unpackhi_epi32(m[6], m[7]);
+
+  __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+  __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+  __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+  __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+  __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+  __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+  __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+  __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+
+  m[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+  m[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+  m[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+  m[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+  m[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+  m[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+  m[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+  m[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+// Load eight consecutive UInt256 values as limb vectors.
+AVX2 static void load_aos8(__m256i m[8], const UInt256 *src) {
+  for (int i = 0; i < 8; i++) {
+    m[i] = _mm256_loadu_si256((const __m256i *)src[i].data);
+  }
+  transpose8(m);
+}
+
+// Load/store limb i of the eight elements of a UInt256Vec starting at
+// element k.
+AVX2 static inline __m256i load_soa(const UInt256Vec *vec, int i, size_t k) {
+  return _mm256_load_si256((const __m256i *)(vec->limbs[i] + k));
+}
+
+AVX2 static inline void store_soa(UInt256Vec *vec, int i, size_t k,
+                                  __m256i v) {
+  _mm256_store_si256((__m256i *)(vec->limbs[i] + k), v);
+}
+
+// Process the multiple-of-eight prefix of an AoS batch; returns the
+// number of values handled.
+AVX2 static size_t cmp_n_avx2(int *dst, const UInt256 *a, const UInt256 *b,
+                              size_t n) {
+  size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    __m256i va[8], vb[8];
+    load_aos8(va, a + k);
+    load_aos8(vb, b + k);
+    __m256i res = _mm256_setzero_si256();
+    for (int i = 7; i >= 0; i--) {
+      res = cmp_step(va[i], vb[i], res);
+    }
+    _mm256_storeu_si256((__m256i *)(dst + k), res);
+  }
+  return k;
+}
+
+// The SoA storage is padded to a multiple of eight elements, so whole
+// blocks can be processed without a tail. Each limb is loaded right
+// before it is stored, so dst may be the same vector as a or b.
+AVX2 static void vec_add_avx2(UInt256Vec *dst, const UInt256Vec *a,
+                              const UInt256Vec *b) {
+  for (size_t k = 0; k < a->n; k += 8) {
+    __m256i carry = _mm256_setzero_si256();
+    for (int i = 0; i < 8; i++) {
+      store_soa(dst, i, k, add_step(load_soa(a, i, k), load_soa(b, i, k),
+                                    &carry));
+    }
+  }
+}
+
+AVX2 static void vec_sub_avx2(UInt256Vec *dst, const UInt256Vec *a,
+                              const UInt256Vec *b) {
+  for (size_t k = 0; k < a->n; k += 8) {
+    __m256i borrow = _mm256_setzero_si256();
+    for (int i = 0; i < 8; i++) {
+      store_soa(dst, i, k, sub_step(load_soa(a, i, k), load_soa(b, i, k),
+                                    &borrow));
+    }
+  }
+}
+
+AVX2 static void vec_cmp_avx2(int *dst, const UInt256Vec *a,
+                              const UInt256Vec *b) {
+  for (size_t k = 0; k < a->n; k += 8) {
+    __m256i res = _mm256_setzero_si256();
+    for (int i = 7; i >= 0; i--) {
+      res = cmp_step(load_soa(a, i, k), load_soa(b, i, k), res);
+    }
+    if (k + 8 <= a->n) {
+      _mm256_storeu_si256((__m256i *)(dst + k), res);
+    } else {
+      int tmp[8];
+      _mm256_storeu_si256((__m256i *)tmp, res);
+      memcpy(dst + k, tmp, (a->n - k) * sizeof(int));
+    }
+  }
+}
+
+// Per-element shifts of AoS values, one value per register as four
+// 64-bit lanes. For each value, result lane j is a funnel shift of the
+// two source words a whole-word shift brings to it; both are picked
+// out with one cross-lane permute each and zeroed when they fall
+// outside the value. SLLV/SRLV give 0 for counts of 64, so a shift
+// that is a multiple of 64 needs no special case, and a shift of 256
+// or more selects no words at all: there are no branches on the shift.
+AVX2 static inline __m256i pick_words(__m256i v, __m256i src) {
+  // 32-bit lane 2i + h of the result is half h of word src[i]
+  const __m256i half = _mm256_setr_epi32(0, 1, 0, 1, 0, 1, 0, 1);
+  return _mm256_permutevar8x32_epi32(
+      v, _mm256_add_epi32(_mm256_add_epi32(src, src), half));
+}
+
+// Word index of each 32-bit lane, and the whole-word part of a shift
+// (4 for shifts of 256 or more) broadcast to every lane.
+AVX2 static inline __m256i lane_words(void) {
+  return _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+}
+
+AVX2 static inline __m256i shift_words(unsigned shift) {
+  return _mm256_set1_epi32((int)((shift < 256 ? shift : 256) / 64));
+}
+
+AVX2 static void lshift_n_avx2(UInt256 *dst, const UInt256 *src,
+                               const unsigned *shifts, size_t n) {
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i none = _mm256_set1_epi32(-1);
+  for (size_t k = 0; k < n; k++) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)src[k].data);
+    __m256i hi_src = _mm256_sub_epi32(lane_words(), shift_words(shifts[k]));
+    __m256i lo_src = _mm256_sub_epi32(hi_src, one);
+    __m256i hi = _mm256_and_si256(pick_words(v, hi_src),
+                                  _mm256_cmpgt_epi32(hi_src, none));
+    __m256i lo = _mm256_and_si256(pick_words(v, lo_src),
+                                  _mm256_cmpgt_epi32(lo_src, none));
+    __m256i bits = _mm256_set1_epi64x(shifts[k] % 64);
+    __m256i r = _mm256_or_si256(
+        _mm256_sllv_epi64(hi, bits),
+        _mm256_srlv_epi64(lo, _mm256_sub_epi64(_mm256_set1_epi64x(64), bits)));
+    _mm256_storeu_si256((__m256i *)dst[k].data, r);
+  }
+}
+
+AVX2 static void rshift_n_avx2(UInt256 *dst, const UInt256 *src,
+                               const unsigned *shifts, size_t n) {
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i four = _mm256_set1_epi32(4);
+  for (size_t k = 0; k < n; k++) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)src[k].data);
+    __m256i lo_src = _mm256_add_epi32(lane_words(), shift_words(shifts[k]));
+    __m256i hi_src = _mm256_add_epi32(lo_src, one);
+    __m256i lo = _mm256_and_si256(pick_words(v, lo_src),
+                                  _mm256_cmpgt_epi32(four, lo_src));
+    __m256i hi = _mm256_and_si256(pick_words(v, hi_src),
+                                  _mm256_cmpgt_epi32(four, hi_src));
+    __m256i bits = _mm256_set1_epi64x(shifts[k] % 64);
+    __m256i r = _mm256_or_si256(
+        _mm256_srlv_epi64(lo, bits),
+        _mm256_sllv_epi64(hi, _mm256_sub_epi64(_mm256_set1_epi64x(64), bits)));
+    _mm256_storeu_si256((__m256i *)dst[k].data, r);
+  }
+}
+
+#undef AVX2
+
+static int have_avx2(void) {
+  return (uint256_cpu_features() & UINT256_CPU_AVX2) != 0;
+}
+
+#endif // UINT256_BATCH_AVX2
+
+// Element-wise dst[k] = a[k] + b[k] for k in [0, n).
+// For arrays of UInt256 the single-value carry-chain kernels win: the
+// transposes needed to use AVX2 cost more than they save.
+void uint256_add_n(UInt256 *dst, const UInt256 *a, const UInt256 *b,
+                   size_t n) {
+  void (*add)(uint32_t *, const uint32_t *, const uint32_t *) =
+      uint256_kernels->add;
+  for (size_t k = 0; k < n; k++) {
+    add(dst[k].data, a[k].data, b[k].data);
+  }
+}
+
+// Element-wise dst[k] = a[k] - b[k] for k in [0, n).
+void uint256_sub_n(UInt256 *dst, const UInt256 *a, const UInt256 *b,
+                   size_t n) {
+  void (*sub)(uint32_t *, const uint32_t *, const uint32_t *) =
+      uint256_kernels->sub;
+  for (size_t k = 0; k < n; k++) {
+    sub(dst[k].data, a[k].data, b[k].data);
+  }
+}
+
+// Element-wise three-way comparison.
+void uint256_cmp_n(int *dst, const UInt256 *a, const UInt256 *b, size_t n) {
+  size_t k = 0;
+#ifdef UINT256_BATCH_AVX2
+  if (have_avx2()) {
+    k = cmp_n_avx2(dst, a, b, n);
+  }
+#endif
+  for (; k < n; k++) {
+    dst[k] = uint256_cmp(a[k], b[k]);
+  }
+}
+
+// Element-wise dst[k] = src[k] << shifts[k].
+void uint256_lshift_n(UInt256 *dst, const UInt256 *src,
+                      const unsigned *shifts, size_t n) {
+#ifdef UINT256_BATCH_AVX2
+  if (have_avx2()) {
+    lshift_n_avx2(dst, src, shifts, n);
+    return;
+  }
+#endif
+  void (*lshift)(uint32_t *, const uint32_t *, unsigned) =
+      uint256_kernels->lshift;
+  for (size_t k = 0; k < n; k++) {
+    lshift(dst[k].data, src[k].data, shifts[k]);
+  }
+}
+
+// Element-wise dst[k] = src[k] >> shifts[k].
+void uint256_rshift_n(UInt256 *dst, const UInt256 *src,
+                      const unsigned *shifts, size_t n) {
+#ifdef UINT256_BATCH_AVX2
+  if (have_avx2()) {
+    rshift_n_avx2(dst, src, shifts, n);
+    return;
+  }
+#endif
+  for (size_t k = 0; k < n; k++) {
+    dst[k] = uint256_rshift(src[k], shifts[k]);
+  }
+}
+
+// Initialize a UInt256Vec with room for n values, all set to 0.
+// The limb arrays share one 32-byte-aligned block, each padded to a
+// multiple of eight elements so the vector kernels never need a tail.
+int uint256_vec_init(UInt256Vec *vec, size_t n) {
+  size_t cap = (n + 7) & ~(size_t)7;
+  if (cap == 0) {
+    cap = 8;
+  }
+  uint32_t *block = aligned_alloc(32, cap * 8 * sizeof(uint32_t));
+  if (block == NULL) {
+    return 0;
+  }
+  memset(block, 0, cap * 8 * sizeof(uint32_t));
+  vec->n = n;
+  for (int i = 0; i < 8; i++) {
+    vec->limbs[i] = block + i * cap;
+  }
+  return 1;
+}
+
+// De-allocate the memory used by a UInt256Vec.
+void uint256_vec_cleanup(UInt256Vec *vec) {
+  free(vec->limbs[0]);
+  for (int i = 0; i < 8; i++) {
+    vec->limbs[i] = NULL;
+  }
+  vec->n = 0;
+}
+
+// Copy vec->n values from an array of UInt256 into vec.
+void uint256_vec_load(UInt256Vec *vec, const UInt256 *src) {
+  for (size_t k = 0; k < vec->n; k++) {
+    for (int i = 0; i < 8; i++) {
+      vec->limbs[i][k] = src[k].data[i];
+    }
+  }
+}
+
+// Copy the vec->n values in vec out to an array of UInt256.
+void uint256_vec_store(const UInt256Vec *vec, UInt256 *dst) {
+  for (size_t k = 0; k < vec->n; k++) {
+    for (int i = 0; i < 8; i++) {
+      dst[k].data[i] = vec->limbs[i][k];
+    }
+  }
+}
+
+// Element-wise dst = a + b.
+void uint256_vec_add(UInt256Vec *dst, const UInt256Vec *a,
+                     const UInt256Vec *b) {
+#ifdef UINT256_BATCH_AVX2
+  if (have_avx2()) {
+    vec_add_avx2(dst, a, b);
+    return;
+  }
+#endif
+  for (size_t k = 0; k < a->n; k++) {
+    uint64_t carry = 0;
+    for (int i = 0; i < 8; i++) {
+      uint64_t t = (uint64_t)a->limbs[i][k] + b->limbs[i][k] + carry;
+      dst->limbs[i][k] = (uint32_t)t;
+      carry = t >> 32;
+    }
+  }
+}
+
+// Element-wise dst = a - b.
+void uint256_vec_sub(UInt256Vec *dst, const UInt256Vec *a,
+                     const UInt256Vec *b) {
+#ifdef UINT256_BATCH_AVX2
+  if (have_avx2()) {
+    vec_sub_avx2(dst, a, b);
+    return;
+  }
+#endif
+  for (size_t k = 0; k < a->n; k++) {
+    uint64_t borrow = 0;
+    for (int i = 0; i < 8; i++) {
+      uint64_t t = (uint64_t)a->limbs[i][k] - b->limbs[i][k] - borrow;
+      dst->limbs[i][k] = (uint32_t)t;
+      borrow = (t >> 32) & 1;
+    }
+  }
+}
+
+// Element-wise three-way comparison of two vectors.
+void uint256_vec_cmp(int *dst, const UInt256Vec *a, const UInt256Vec *b) {
+#ifdef UINT256_BATCH_AVX2
+  if (have_avx2()) {
+    vec_cmp_avx2(dst, a, b);
+    return;
+  }
+#endif
+  for (size_t k = 0; k < a->n; k++) {
+    int res = 0;
+    for (int i = 7; i >= 0 && res == 0; i--) {
+      uint32_t x = a->limbs[i][k];
+      uint32_t y = b->limbs[i][k];
+      res = (x > y) - (x < y);
+    }
+    dst[k] = res;
+  }
+}
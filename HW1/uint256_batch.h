@@ -0,0 +1,90 @@
+#ifndef UINT256_BATCH_H
+#define UINT256_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "uint256.h"
+
+// Batch operations on arrays of UInt256 values.
+//
+// The *_n functions work on ordinary arrays of UInt256 (array of
+// structures). Add and subtract run the same carry-chain kernels as
+// uint256_add/uint256_sub over each element. Compare uses AVX2 when the
+// CPU supports it: eight values at a time are transposed into
+// registers so that each register holds the same limb of eight
+// different values; any leftover values are handled one at a time.
+// The shifts use AVX2 with one value per register, moving its four
+// 64-bit words with cross-lane permutes, so each element can have its
+// own shift count.
+//
+// UInt256Vec stores values already transposed (structure of arrays):
+// limb i of every element is contiguous. Operations on UInt256Vec use
+// AVX2 without any transposes, propagating the carry chain for eight
+// values at once, so they are the fastest option when the same values
+// take part in many batch operations.
+
+// Element-wise dst[k] = a[k] + b[k] for k in [0, n).
+// dst may be the same array as a or b.
+void uint256_add_n( UInt256 *dst, const UInt256 *a, const UInt256 *b,
+                    size_t n );
+
+// Element-wise dst[k] = a[k] - b[k] for k in [0, n).
+// dst may be the same array as a or b.
+void uint256_sub_n( UInt256 *dst, const UInt256 *a, const UInt256 *b,
+                    size_t n );
+
+// Element-wise comparison: dst[k] is -1, 0 or 1 as a[k] is less than,
+// equal to or greater than b[k].
+void uint256_cmp_n( int *dst, const UInt256 *a, const UInt256 *b, size_t n );
+
+// Element-wise dst[k] = src[k] << shifts[k] for k in [0, n). Any shift
+// is allowed; shifts of 256 or more give 0. dst may be the same array
+// as src.
+void uint256_lshift_n( UInt256 *dst, const UInt256 *src,
+                       const unsigned *shifts, size_t n );
+
+// Element-wise dst[k] = src[k] >> shifts[k] for k in [0, n). Any shift
+// is allowed; shifts of 256 or more give 0. dst may be the same array
+// as src.
+void uint256_rshift_n( UInt256 *dst, const UInt256 *src,
+                       const unsigned *shifts, size_t n );
+
+// A vector of n UInt256 values in structure-of-arrays form.
+// limbs[i][k] is limb i (0 = least significant) of element k.
+typedef struct {
+  size_t n;
+  uint32_t *limbs[8];
+} UInt256Vec;
+
+// Initialize a UInt256Vec with room for n values, all set to 0.
+//
+// Returns:
+//   1 if successful, 0 if memory could not be allocated
+int uint256_vec_init( UInt256Vec *vec, size_t n );
+
+// De-allocate the memory used by a UInt256Vec (but not the struct
+// itself).
+void uint256_vec_cleanup( UInt256Vec *vec );
+
+// Copy vec->n values from an array of UInt256 into vec.
+void uint256_vec_load( UInt256Vec *vec, const UInt256 *src );
+
+// Copy the vec->n values in vec out to an array of UInt256.
+void uint256_vec_store( const UInt256Vec *vec, UInt256 *dst );
+
+// Element-wise dst = a + b. All three must have the same length, and
+// dst may be the same vector as a or b.
+void uint256_vec_add( UInt256Vec *dst, const UInt256Vec *a,
+                      const UInt256Vec *b );
+
+// Element-wise dst = a - b. All three must have the same length, and
+// dst may be the same vector as a or b.
+void uint256_vec_sub( UInt256Vec *dst, const UInt256Vec *a,
+                      const UInt256Vec *b );
+
+// Element-wise comparison of two vectors of the same length: dst[k] is
+// -1, 0 or 1 as element k of a is less than, equal to or greater than
+// element k of b.
+void uint256_vec_cmp( int *dst, const UInt256Vec *a, const UInt256Vec *b );
+
+#endif // UINT256_BATCH_H
@@ -0,0 +1,2083 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "int256.h"
+#include "uint256.h"
+#include "uint256_acc.h"
+#include "uint256_barrett.h"
+#include "uint256_batch.h"
+#include "uint256_bytes.h"
+#include "uint256_dispatch.h"
+#include "uint256_field.h"
+#include "uint256_gcd.h"
+#include "uint256_mont.h"
+#include "uint256_root.h"
+#include "uint256_rng.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HAVE_TSC 1
+#include <x86intrin.h>
+#endif
+
+// Microbenchmarks for the UInt256 library.
+//
+// Usage: uint256_bench [iterations]
+//
+// Each benchmark runs over a fixed pool of pseudo-random operands so
+// that the timings are not dominated by a single lucky input, and
+// folds every result into a sink so the compiler can't discard the
+// work. Every exported function is timed by at least one of them.
+//
+// Timings are reported in nanoseconds and, on x86, in time stamp
+// counter cycles. The TSC ticks at a fixed rate, so its cycles equal
+// core cycles only while the core runs at its nominal frequency.
+
+#define POOL_SIZE 1024
+#define DEFAULT_ITERS 1000000L
+
+static UInt256 pool_a[POOL_SIZE];
+static UInt256 pool_b[POOL_SIZE];
+static volatile uint32_t sink;
+
+// xorshift64* generator, good enough to fill benchmark operands
+static uint64_t rng_state = 0x9e3779b97f4a7c15ULL;
+
+static uint64_t rng_next(void) {
+  rng_state ^= rng_state >> 12;
+  rng_state ^= rng_state << 25;
+  rng_state ^= rng_state >> 27;
+  return rng_state * 0x2545f4914f6cdd1dULL;
+}
+
+static UInt256 random_uint256(void) {
+  UInt256 val;
+  for (int i = 0; i < 8; i += 2) {
+    uint64_t r = rng_next();
+    val.data[i] = (uint32_t)r;
+    val.data[i + 1] = (uint32_t)(r >> 32);
+  }
+  return val;
+}
+
+static void fill_pools(void) {
+  for (int i = 0; i < POOL_SIZE; i++) {
+    pool_a[i] = random_uint256();
+    pool_b[i] = random_uint256();
+  }
+}
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// TSC cycles per nanosecond, measured at startup; 0 if there is no TSC
+static double cycles_per_ns;
+
+static void calibrate_cycles(void) {
+#ifdef HAVE_TSC
+  double start = now_ns();
+  uint64_t start_tsc = __rdtsc();
+  while (now_ns() - start < 2e7) {
+    // spin for 20 ms
+  }
+  cycles_per_ns = (__rdtsc() - start_tsc) / (now_ns() - start);
+#endif
+}
+
+static void report(const char *name, double elapsed_ns, long iters) {
+  printf("%-32s %10.2f ns/op", name, elapsed_ns / iters);
+  if (cycles_per_ns > 0) {
+    printf(" %10.1f cycles/op", elapsed_ns * cycles_per_ns / iters);
+  }
+  printf("\n");
+}
+
+static void report_rate(const char *name, double elapsed_ns, long elems) {
+  printf("%-32s %10.2f Melem/s", name, elems / elapsed_ns * 1e3);
+  if (cycles_per_ns > 0) {
+    printf(" %8.1f cycles/elem", elapsed_ns * cycles_per_ns / elems);
+  }
+  printf("\n");
+}
+
+static uint32_t fold(UInt256 val) {
+  uint32_t h = 0;
+  for (int i = 0; i < 8; i++) {
+    h ^= val.data[i];
+  }
+  return h;
+}
+
+// Return 1 if a >= b, 0 otherwise.
+static int geq(UInt256 a, UInt256 b) {
+  for (int i = 7; i >= 0; i--) {
+    if (a.data[i] != b.data[i]) {
+      return a.data[i] > b.data[i];
+    }
+  }
+  return 1;
+}
+
+// The original bit-serial multiply, kept here as the baseline that the
+// limb-wise kernel in uint256.c is measured (and checked) against.
+static UInt256 bitserial_mul(UInt256 left, UInt256 right) {
+  UInt256 product = {0};
+  for (int i = 0; i < 256; i++) {
+    if (uint256_is_bit_set(left, i)) {
+      UInt256 temp = uint256_lshift(right, i);
+      product = uint256_add(product, temp);
+    }
+  }
+  return product;
+}
+
+static void bench_mul(long iters) {
+  // sanity check: both kernels must agree bit-for-bit
+  for (int i = 0; i < POOL_SIZE; i++) {
+    UInt256 x = uint256_mul(pool_a[i], pool_b[i]);
+    UInt256 y = bitserial_mul(pool_a[i], pool_b[i]);
+    if (memcmp(&x, &y, sizeof(UInt256)) != 0) {
+      fprintf(stderr, "uint256_mul mismatch at pool index %d\n", i);
+      exit(1);
+    }
+  }
+
+  uint32_t acc = 0;
+  double start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc ^= fold(uint256_mul(pool_a[i % POOL_SIZE], pool_b[i % POOL_SIZE]));
+  }
+  report("uint256_mul (limb)", now_ns() - start, iters);
+
+  // the bit-serial version is much slower, so run it for fewer iterations
+  long slow_iters = iters / 100 > 0 ? iters / 100 : 1;
+  start = now_ns();
+  for (long i = 0; i < slow_iters; i++) {
+    acc ^= fold(bitserial_mul(pool_a[i % POOL_SIZE], pool_b[i % POOL_SIZE]));
+  }
+  report("uint256_mul (bit-serial)", now_ns() - start, slow_iters);
+  sink = acc;
+}
+
+static void bench_mul_wide(long iters) {
+  // sanity check: the dedicated squaring must agree with mul_wide(a, a)
+  for (int i = 0; i < POOL_SIZE; i++) {
+    UInt256 hi1, lo1, hi2, lo2;
+    uint256_mul_wide(pool_a[i], pool_a[i], &hi1, &lo1);
+    uint256_sqr_wide(pool_a[i], &hi2, &lo2);
+    if (memcmp(&hi1, &hi2, sizeof(UInt256)) != 0 ||
+        memcmp(&lo1, &lo2, sizeof(UInt256)) != 0) {
+      fprintf(stderr, "uint256_sqr_wide mismatch at pool index %d\n", i);
+      exit(1);
+    }
+  }
+
+  uint32_t acc = 0;
+  UInt256 hi, lo;
+  double start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    uint256_mul_wide(pool_a[i % POOL_SIZE], pool_b[i % POOL_SIZE], &hi, &lo);
+    acc ^= fold(hi) ^ fold(lo);
+  }
+  report("uint256_mul_wide", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    uint256_mul_wide(pool_a[i % POOL_SIZE], pool_a[i % POOL_SIZE], &hi, &lo);
+    acc ^= fold(hi) ^ fold(lo);
+  }
+  report("uint256_mul_wide (a*a)", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    uint256_sqr_wide(pool_a[i % POOL_SIZE], &hi, &lo);
+    acc ^= fold(hi) ^ fold(lo);
+  }
+  report("uint256_sqr_wide", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc ^= fold(uint256_sqr(pool_a[i % POOL_SIZE]));
+  }
+  report("uint256_sqr", now_ns() - start, iters);
+  sink = acc;
+}
+
+// Reference modular multiply built only from the basic library
+// operations: double-and-add over the bits of b, reducing with a
+// conditional uint256_sub after every step. Requires a, b < m < 2^255.
+static UInt256 naive_mulmod(UInt256 a, UInt256 b, UInt256 m) {
+  UInt256 r = {0};
+  for (int i = 255; i >= 0; i--) {
+    r = uint256_lshift(r, 1);
+    if (geq(r, m)) {
+      r = uint256_sub(r, m);
+    }
+    if (uint256_is_bit_set(b, i)) {
+      r = uint256_add(r, a);
+      if (geq(r, m)) {
+        r = uint256_sub(r, m);
+      }
+    }
+  }
+  return r;
+}
+
+// Reference restoring division, one quotient bit per step.
+static void shift_subtract_divmod(UInt256 num, UInt256 den, UInt256 *quot,
+                                  UInt256 *rem) {
+  UInt256 q = {0};
+  UInt256 r = {0};
+  for (int i = 255; i >= 0; i--) {
+    int top = uint256_is_bit_set(r, 255);
+    r = uint256_lshift(r, 1);
+    r.data[0] |= uint256_is_bit_set(num, i);
+    if (top || geq(r, den)) {
+      r = uint256_sub(r, den);
+      q.data[i / 32] |= 1U << (i % 32);
+    }
+  }
+  *quot = q;
+  *rem = r;
+}
+
+static void bench_divmod(long iters) {
+  // divisors of 32, 64, 128, 192 and 256 bits
+  static const int widths[] = {1, 2, 4, 6, 8};
+  char name[64];
+
+  for (unsigned w = 0; w < sizeof(widths) / sizeof(widths[0]); w++) {
+    UInt256 den[POOL_SIZE];
+    for (int i = 0; i < POOL_SIZE; i++) {
+      den[i] = pool_b[i];
+      for (int j = widths[w]; j < 8; j++) {
+        den[i].data[j] = 0;
+      }
+      if (den[i].data[widths[w] - 1] == 0) {
+        den[i].data[widths[w] - 1] = 1;
+      }
+    }
+
+    // sanity check against the bit-at-a-time reference
+    for (int i = 0; i < POOL_SIZE; i++) {
+      UInt256 q1, r1, q2, r2;
+      uint256_divmod(pool_a[i], den[i], &q1, &r1);
+      shift_subtract_divmod(pool_a[i], den[i], &q2, &r2);
+      if (memcmp(&q1, &q2, sizeof(UInt256)) != 0 ||
+          memcmp(&r1, &r2, sizeof(UInt256)) != 0) {
+        fprintf(stderr, "uint256_divmod mismatch at pool index %d\n", i);
+        exit(1);
+      }
+    }
+
+    uint32_t acc = 0;
+    UInt256 q, r;
+    double start = now_ns();
+    for (long i = 0; i < iters; i++) {
+      uint256_divmod(pool_a[i % POOL_SIZE], den[i % POOL_SIZE], &q, &r);
+      acc ^= fold(q) ^ fold(r);
+    }
+    snprintf(name, sizeof(name), "uint256_divmod (256/%d)", widths[w] * 32);
+    report(name, now_ns() - start, iters);
+    sink = acc;
+  }
+
+  uint32_t acc = 0;
+  uint32_t rem;
+  double start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc ^= fold(uint256_divmod_u32(pool_a[i % POOL_SIZE], 1000000007U, &rem));
+    acc ^= rem;
+  }
+  report("uint256_divmod_u32", now_ns() - start, iters);
+
+  long slow_iters = iters / 100 > 0 ? iters / 100 : 1;
+  UInt256 q, r;
+  start = now_ns();
+  for (long i = 0; i < slow_iters; i++) {
+    shift_subtract_divmod(pool_a[i % POOL_SIZE], pool_b[i % POOL_SIZE], &q, &r);
+    acc ^= fold(q) ^ fold(r);
+  }
+  report("divmod (shift-subtract)", now_ns() - start, slow_iters);
+  sink = acc;
+}
+
+// Reference decimal conversions that handle one digit per pass over
+// the limbs.
+static UInt256 digitwise_from_dec(const char *dec) {
+  UInt256 val = {0};
+  for (const char *p = dec; *p != '\0'; p++) {
+    val = uint256_mul(val, uint256_create_from_u32(10));
+    val = uint256_add(val, uint256_create_from_u32((uint32_t)(*p - '0')));
+  }
+  return val;
+}
+
+static char *digitwise_format_as_dec(UInt256 val) {
+  char tmp[80];
+  int n = 0;
+  UInt256 zero = {0};
+  do {
+    uint32_t digit;
+    val = uint256_divmod_u32(val, 10, &digit);
+    tmp[n++] = (char)('0' + digit);
+  } while (memcmp(&val, &zero, sizeof(UInt256)) != 0);
+  char *dec = malloc(n + 1);
+  for (int i = 0; i < n; i++) {
+    dec[i] = tmp[n - 1 - i];
+  }
+  dec[n] = '\0';
+  return dec;
+}
+
+static void bench_dec(long iters) {
+  // pre-format the pool so parsing can be timed on its own
+  char *strs[POOL_SIZE];
+  long total_digits = 0;
+  for (int i = 0; i < POOL_SIZE; i++) {
+    strs[i] = uint256_format_as_dec(pool_a[i]);
+    total_digits += strlen(strs[i]);
+
+    char *ref = digitwise_format_as_dec(pool_a[i]);
+    UInt256 back = uint256_create_from_dec(strs[i]);
+    if (strcmp(ref, strs[i]) != 0 ||
+        memcmp(&back, &pool_a[i], sizeof(UInt256)) != 0) {
+      fprintf(stderr, "decimal conversion mismatch at pool index %d\n", i);
+      exit(1);
+    }
+    free(ref);
+  }
+  double digits_per_value = (double)total_digits / POOL_SIZE;
+
+  uint32_t acc = 0;
+  double start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc ^= fold(uint256_create_from_dec(strs[i % POOL_SIZE]));
+  }
+  double elapsed = now_ns() - start;
+  report("uint256_create_from_dec", elapsed, iters);
+  printf("%-32s %10.2f Mdigits/s\n", "",
+         digits_per_value * iters / elapsed * 1e3);
+
+  long slow_iters = iters / 10 > 0 ? iters / 10 : 1;
+  start = now_ns();
+  for (long i = 0; i < slow_iters; i++) {
+    acc ^= fold(digitwise_from_dec(strs[i % POOL_SIZE]));
+  }
+  report("from_dec (digit at a time)", now_ns() - start, slow_iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    char *s = uint256_format_as_dec(pool_a[i % POOL_SIZE]);
+    acc ^= (uint32_t)s[0];
+    free(s);
+  }
+  elapsed = now_ns() - start;
+  report("uint256_format_as_dec", elapsed, iters);
+  printf("%-32s %10.2f Mdigits/s\n", "",
+         digits_per_value * iters / elapsed * 1e3);
+
+  start = now_ns();
+  for (long i = 0; i < slow_iters; i++) {
+    char *s = digitwise_format_as_dec(pool_a[i % POOL_SIZE]);
+    acc ^= (uint32_t)s[0];
+    free(s);
+  }
+  report("format_as_dec (digit at a time)", now_ns() - start, slow_iters);
+
+  for (int i = 0; i < POOL_SIZE; i++) {
+    free(strs[i]);
+  }
+  sink = acc;
+}
+
+// The original formatter: one malloc'd sprintf string per limb,
+// joined with strcat.
+static char *sprintf_format_as_hex(UInt256 val) {
+  char *hex = NULL;
+  int idx = 7;
+  while (idx >= 0 && val.data[idx] == 0) {
+    idx--;
+  }
+  if (idx == -1) {
+    hex = malloc(2);
+    strcpy(hex, "0");
+    return hex;
+  }
+  char *strings[idx + 1];
+  int sum_len = 0;
+  for (int i = 0; i <= idx; i++) {
+    strings[i] = malloc(9);
+    uint32_t value = val.data[idx - i];
+    if (i == 0) {
+      sprintf(strings[i], "%x", value);
+      sum_len += strlen(strings[i]);
+    } else {
+      sprintf(strings[i], "%08x", value);
+      sum_len += 8;
+    }
+  }
+  hex = malloc(sum_len + 1);
+  strcpy(hex, strings[0]);
+  for (int i = 1; i <= idx; i++) {
+    strcat(hex, strings[i]);
+  }
+  for (int i = 0; i <= idx; i++) {
+    free(strings[i]);
+  }
+  return hex;
+}
+
+static void bench_hex_format(long iters) {
+  char buf[UINT256_HEX_BUFSIZE];
+  for (int i = 0; i < POOL_SIZE; i++) {
+    char *ref = sprintf_format_as_hex(pool_a[i]);
+    uint256_format_as_hex_into(pool_a[i], buf, sizeof(buf));
+    if (strcmp(ref, buf) != 0) {
+      fprintf(stderr, "hex format mismatch at pool index %d\n", i);
+      exit(1);
+    }
+    free(ref);
+  }
+
+  uint32_t acc = 0;
+  double start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    char *s = sprintf_format_as_hex(pool_a[i % POOL_SIZE]);
+    acc ^= (uint32_t)s[0];
+    free(s);
+  }
+  report("format_as_hex (sprintf)", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    char *s = uint256_format_as_hex(pool_a[i % POOL_SIZE]);
+    acc ^= (uint32_t)s[0];
+    free(s);
+  }
+  report("uint256_format_as_hex", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc ^= (uint32_t)uint256_format_as_hex_into(pool_a[i % POOL_SIZE], buf,
+                                                sizeof(buf));
+  }
+  report("uint256_format_as_hex_into", now_ns() - start, iters);
+
+  size_t cap = (size_t)POOL_SIZE * UINT256_HEX_BUFSIZE + 1;
+  char *big = malloc(cap);
+  long rounds = iters / POOL_SIZE > 0 ? iters / POOL_SIZE : 1;
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    acc ^= (uint32_t)uint256_format_as_hex_batch(pool_a, POOL_SIZE, big, cap);
+  }
+  report("uint256_format_as_hex_batch", now_ns() - start, rounds * POOL_SIZE);
+  free(big);
+  sink = acc;
+}
+
+// The original parser: strncpy each 8-character chunk into a
+// temporary and convert it with strtoul.
+static UInt256 strtoul_create_from_hex(const char *hex) {
+  UInt256 result;
+  int len = strlen(hex);
+  const char *start;
+  int count;
+  int remain;
+  if (len > 64) {
+    start = hex + len - 64;
+    count = 8;
+    remain = 0;
+  } else {
+    start = hex;
+    count = len / 8;
+    remain = len % 8;
+  }
+  int idx = 0;
+  while (idx < count) {
+    char hex_str[9];
+    strncpy(hex_str, start + remain + (count - idx - 1) * 8, 8);
+    hex_str[8] = '\0';
+    result.data[idx] = strtoul(hex_str, NULL, 16);
+    idx += 1;
+  }
+  if (remain != 0 && idx < 8) {
+    char hex_str[remain + 1];
+    strncpy(hex_str, start, remain);
+    hex_str[remain] = '\0';
+    result.data[idx] = strtoul(hex_str, NULL, 16);
+    idx += 1;
+  }
+  while (idx < 8) {
+    result.data[idx] = 0;
+    idx += 1;
+  }
+  return result;
+}
+
+static void bench_hex_parse(long iters) {
+  static char strs[POOL_SIZE][UINT256_HEX_BUFSIZE];
+  static size_t lens[POOL_SIZE];
+  for (int i = 0; i < POOL_SIZE; i++) {
+    lens[i] = uint256_format_as_hex_into(pool_a[i], strs[i], sizeof(strs[i]));
+    UInt256 x, y = strtoul_create_from_hex(strs[i]);
+    if (!uint256_parse_hex(strs[i], lens[i], &x) ||
+        memcmp(&x, &y, sizeof(UInt256)) != 0) {
+      fprintf(stderr, "hex parse mismatch at pool index %d\n", i);
+      exit(1);
+    }
+  }
+
+  uint32_t acc = 0;
+  double start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc ^= fold(strtoul_create_from_hex(strs[i % POOL_SIZE]));
+  }
+  report("create_from_hex (strtoul)", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc ^= fold(uint256_create_from_hex(strs[i % POOL_SIZE]));
+  }
+  report("uint256_create_from_hex", now_ns() - start, iters);
+
+  UInt256 val;
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc ^= uint256_parse_hex(strs[i % POOL_SIZE], lens[i % POOL_SIZE], &val);
+    acc ^= fold(val);
+  }
+  report("uint256_parse_hex", now_ns() - start, iters);
+  sink = acc;
+}
+
+// Accumulate over the pool with the by-value and pointer APIs.
+// The chain acc += -(x - y) exercises the case where temporaries pile
+// up in the by-value form.
+static void bench_in_place(long iters) {
+  UInt256 acc = {0};
+  double start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc = uint256_add(acc, pool_a[i % POOL_SIZE]);
+  }
+  report("acc = add(acc, x)", now_ns() - start, iters);
+  UInt256 check = acc;
+
+  acc = uint256_create_from_u32(0);
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    uint256_add_to(&acc, &acc, &pool_a[i % POOL_SIZE]);
+  }
+  report("add_to(&acc, &acc, &x)", now_ns() - start, iters);
+  if (memcmp(&acc, &check, sizeof(UInt256)) != 0) {
+    fprintf(stderr, "uint256_add_to accumulation mismatch\n");
+    exit(1);
+  }
+
+  acc = uint256_create_from_u32(0);
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    UInt256 d = uint256_sub(pool_a[i % POOL_SIZE], pool_b[i % POOL_SIZE]);
+    acc = uint256_add(acc, uint256_negate(d));
+  }
+  report("acc = add(acc, neg(sub(x, y)))", now_ns() - start, iters);
+  check = acc;
+
+  acc = uint256_create_from_u32(0);
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    UInt256 d;
+    uint256_sub_to(&d, &pool_a[i % POOL_SIZE], &pool_b[i % POOL_SIZE]);
+    uint256_negate_to(&d, &d);
+    uint256_add_to(&acc, &acc, &d);
+  }
+  report("sub_to/negate_to/add_to chain", now_ns() - start, iters);
+  if (memcmp(&acc, &check, sizeof(UInt256)) != 0) {
+    fprintf(stderr, "pointer API chain mismatch\n");
+    exit(1);
+  }
+
+  // odd multipliers, so the running product never collapses to zero
+  UInt256 odd[POOL_SIZE];
+  for (int i = 0; i < POOL_SIZE; i++) {
+    odd[i] = pool_a[i];
+    odd[i].data[0] |= 1;
+  }
+
+  acc = uint256_create_from_u32(1);
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc = uint256_mul(acc, odd[i % POOL_SIZE]);
+  }
+  report("acc = mul(acc, x)", now_ns() - start, iters);
+  check = acc;
+
+  acc = uint256_create_from_u32(1);
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    uint256_mul_to(&acc, &acc, &odd[i % POOL_SIZE]);
+  }
+  report("mul_to(&acc, &acc, &x)", now_ns() - start, iters);
+  if (memcmp(&acc, &check, sizeof(UInt256)) != 0) {
+    fprintf(stderr, "uint256_mul_to accumulation mismatch\n");
+    exit(1);
+  }
+  sink = fold(acc);
+}
+
+// The original add (carry decided by data-dependent branches) and
+// sub (negate, then add), used as the baseline for the carry-chain
+// kernels.
+static UInt256 branchy_add(UInt256 left, UInt256 right) {
+  UInt256 sum;
+  int overflow = 0;
+  for (int i = 0; i < 8; i++) {
+    uint32_t leftpart = left.data[i];
+    uint32_t rightpart = right.data[i];
+    uint32_t total = leftpart + rightpart + overflow;
+    sum.data[i] = total;
+    if ((overflow == 0 && total < leftpart) ||
+        (overflow == 1 && total <= leftpart)) {
+      overflow = 1;
+    } else {
+      overflow = 0;
+    }
+  }
+  return sum;
+}
+
+static UInt256 negate_add_sub(UInt256 left, UInt256 right) {
+  for (int i = 0; i < 8; i++) {
+    right.data[i] = ~right.data[i];
+  }
+  right = branchy_add(right, uint256_create_from_u32(1));
+  return branchy_add(left, right);
+}
+
+static void bench_add_sub(long iters) {
+  for (int i = 0; i < POOL_SIZE; i++) {
+    UInt256 x = uint256_add(pool_a[i], pool_b[i]);
+    UInt256 y = branchy_add(pool_a[i], pool_b[i]);
+    UInt256 z = uint256_sub(pool_a[i], pool_b[i]);
+    UInt256 w = negate_add_sub(pool_a[i], pool_b[i]);
+    if (memcmp(&x, &y, sizeof(UInt256)) != 0 ||
+        memcmp(&z, &w, sizeof(UInt256)) != 0) {
+      fprintf(stderr, "add/sub backend mismatch at pool index %d\n", i);
+      exit(1);
+    }
+  }
+
+  uint32_t acc = 0;
+  double start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc ^= fold(branchy_add(pool_a[i % POOL_SIZE], pool_b[i % POOL_SIZE]));
+  }
+  report("add (branchy carry)", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc ^= fold(uint256_add(pool_a[i % POOL_SIZE], pool_b[i % POOL_SIZE]));
+  }
+  report("uint256_add", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc ^= fold(negate_add_sub(pool_a[i % POOL_SIZE], pool_b[i % POOL_SIZE]));
+  }
+  report("sub (negate + add)", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc ^= fold(uint256_sub(pool_a[i % POOL_SIZE], pool_b[i % POOL_SIZE]));
+  }
+  report("uint256_sub", now_ns() - start, iters);
+  sink = acc;
+}
+
+static void bench_batch(long iters) {
+  UInt256 *dst = malloc(POOL_SIZE * sizeof(UInt256));
+  int *cmp = malloc(POOL_SIZE * sizeof(int));
+  UInt256Vec va, vb, vr;
+  uint256_vec_init(&va, POOL_SIZE);
+  uint256_vec_init(&vb, POOL_SIZE);
+  uint256_vec_init(&vr, POOL_SIZE);
+  uint256_vec_load(&va, pool_a);
+  uint256_vec_load(&vb, pool_b);
+
+  long rounds = iters / POOL_SIZE > 0 ? iters / POOL_SIZE : 1;
+  long elems = rounds * POOL_SIZE;
+  uint32_t acc = 0;
+
+  double start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    for (int i = 0; i < POOL_SIZE; i++) {
+      dst[i] = uint256_add(pool_a[i], pool_b[i]);
+    }
+    acc ^= dst[r % POOL_SIZE].data[0];
+  }
+  report_rate("loop over uint256_add", now_ns() - start, elems);
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    uint256_add_n(dst, pool_a, pool_b, POOL_SIZE);
+    acc ^= dst[r % POOL_SIZE].data[0];
+  }
+  report_rate("uint256_add_n", now_ns() - start, elems);
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    uint256_vec_add(&vr, &va, &vb);
+    acc ^= vr.limbs[0][r % POOL_SIZE];
+  }
+  report_rate("uint256_vec_add", now_ns() - start, elems);
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    for (int i = 0; i < POOL_SIZE; i++) {
+      dst[i] = uint256_sub(pool_a[i], pool_b[i]);
+    }
+    acc ^= dst[r % POOL_SIZE].data[0];
+  }
+  report_rate("loop over uint256_sub", now_ns() - start, elems);
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    uint256_sub_n(dst, pool_a, pool_b, POOL_SIZE);
+    acc ^= dst[r % POOL_SIZE].data[0];
+  }
+  report_rate("uint256_sub_n", now_ns() - start, elems);
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    uint256_vec_sub(&vr, &va, &vb);
+    acc ^= vr.limbs[0][r % POOL_SIZE];
+  }
+  report_rate("uint256_vec_sub", now_ns() - start, elems);
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    uint256_cmp_n(cmp, pool_a, pool_b, POOL_SIZE);
+    acc ^= (uint32_t)cmp[r % POOL_SIZE];
+  }
+  report_rate("uint256_cmp_n", now_ns() - start, elems);
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    uint256_vec_cmp(cmp, &va, &vb);
+    acc ^= (uint32_t)cmp[r % POOL_SIZE];
+  }
+  report_rate("uint256_vec_cmp", now_ns() - start, elems);
+
+  uint256_vec_cleanup(&va);
+  uint256_vec_cleanup(&vb);
+  uint256_vec_cleanup(&vr);
+  free(dst);
+  free(cmp);
+  sink = acc;
+}
+
+static void bench_mont(long iters) {
+  // a 255-bit odd modulus so naive_mulmod can't overflow
+  UInt256 m = uint256_create_from_hex(
+      "7fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffed");
+  UInt256MontCtx ctx;
+  uint256_mont_init(&ctx, m);
+
+  UInt256 am[POOL_SIZE], bm[POOL_SIZE];
+  for (int i = 0; i < POOL_SIZE; i++) {
+    am[i] = uint256_mont_to(&ctx, pool_a[i]);
+    bm[i] = uint256_mont_to(&ctx, pool_b[i]);
+  }
+
+  // sanity check against the naive reference
+  for (int i = 0; i < 64; i++) {
+    UInt256 a = uint256_mont_from(&ctx, am[i]);
+    UInt256 b = uint256_mont_from(&ctx, bm[i]);
+    UInt256 x = uint256_mont_from(&ctx, uint256_mont_mul(&ctx, am[i], bm[i]));
+    UInt256 y = naive_mulmod(a, b, m);
+    if (memcmp(&x, &y, sizeof(UInt256)) != 0) {
+      fprintf(stderr, "uint256_mont_mul mismatch at pool index %d\n", i);
+      exit(1);
+    }
+  }
+
+  uint32_t acc = 0;
+  double start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc ^= fold(uint256_mont_mul(&ctx, am[i % POOL_SIZE], bm[i % POOL_SIZE]));
+  }
+  report("uint256_mont_mul", now_ns() - start, iters);
+
+  long slow_iters = iters / 100 > 0 ? iters / 100 : 1;
+  start = now_ns();
+  for (long i = 0; i < slow_iters; i++) {
+    acc ^= fold(naive_mulmod(am[i % POOL_SIZE], bm[i % POOL_SIZE], m));
+  }
+  report("mulmod (add/sub only)", now_ns() - start, slow_iters);
+
+  long pow_iters = iters / 1000 > 0 ? iters / 1000 : 1;
+  start = now_ns();
+  for (long i = 0; i < pow_iters; i++) {
+    acc ^= fold(uint256_mont_pow(&ctx, am[i % POOL_SIZE], pool_b[i % POOL_SIZE]));
+  }
+  report("uint256_mont_pow", now_ns() - start, pow_iters);
+  sink = acc;
+}
+
+// Compare each special-form field against generic Montgomery
+// multiplication modulo the same prime.
+static void bench_field(long iters) {
+  const UInt256Field *fields[3] = {&uint256_field_secp256k1,
+                                   &uint256_field_p256, &uint256_field_p25519};
+  char name[64];
+
+  for (int f = 0; f < 3; f++) {
+    const UInt256Field *field = fields[f];
+    UInt256MontCtx ctx;
+    uint256_mont_init(&ctx, field->modulus);
+
+    UInt256 a[POOL_SIZE], b[POOL_SIZE], am[POOL_SIZE], bm[POOL_SIZE];
+    for (int i = 0; i < POOL_SIZE; i++) {
+      a[i] = field->reduce(uint256_create_from_u32(0), pool_a[i]);
+      b[i] = field->reduce(uint256_create_from_u32(0), pool_b[i]);
+      am[i] = uint256_mont_to(&ctx, a[i]);
+      bm[i] = uint256_mont_to(&ctx, b[i]);
+    }
+
+    // sanity check: both backends must agree
+    for (int i = 0; i < POOL_SIZE; i++) {
+      UInt256 x = uint256_field_mul(field, a[i], b[i]);
+      UInt256 y = uint256_mont_from(&ctx, uint256_mont_mul(&ctx, am[i], bm[i]));
+      if (memcmp(&x, &y, sizeof(UInt256)) != 0) {
+        fprintf(stderr, "%s: field/mont mismatch at pool index %d\n",
+                field->name, i);
+        exit(1);
+      }
+    }
+
+    uint32_t acc = 0;
+    double start = now_ns();
+    for (long i = 0; i < iters; i++) {
+      acc ^= fold(uint256_field_mul(field, a[i % POOL_SIZE], b[i % POOL_SIZE]));
+    }
+    snprintf(name, sizeof(name), "field_mul (%s)", field->name);
+    report(name, now_ns() - start, iters);
+
+    start = now_ns();
+    for (long i = 0; i < iters; i++) {
+      acc ^= fold(uint256_field_sqr(field, a[i % POOL_SIZE]));
+    }
+    snprintf(name, sizeof(name), "field_sqr (%s)", field->name);
+    report(name, now_ns() - start, iters);
+
+    start = now_ns();
+    for (long i = 0; i < iters; i++) {
+      acc ^= fold(uint256_mont_mul(&ctx, am[i % POOL_SIZE], bm[i % POOL_SIZE]));
+    }
+    snprintf(name, sizeof(name), "mont_mul (%s)", field->name);
+    report(name, now_ns() - start, iters);
+    sink = acc;
+  }
+}
+
+// Time the dispatched kernels under every backend the CPU supports,
+// checking that each backend produces the same results.
+static void bench_dispatch(long iters) {
+  UInt256 expected[4];
+  int have_expected = 0;
+
+  for (int be = 0; be < UINT256_NUM_BACKENDS; be++) {
+    UInt256Backend backend = (UInt256Backend)be;
+    if (!uint256_set_backend(backend)) {
+      printf("(backend %s not supported on this CPU)\n",
+             uint256_backend_name(backend));
+      continue;
+    }
+    char name[64];
+    UInt256 acc[4];
+
+    acc[0] = uint256_create_from_u32(0);
+    double start = now_ns();
+    for (long i = 0; i < iters; i++) {
+      uint256_add_to(&acc[0], &acc[0], &pool_a[i % POOL_SIZE]);
+    }
+    snprintf(name, sizeof(name), "%s add_to", uint256_backend_name(backend));
+    report(name, now_ns() - start, iters);
+
+    acc[1] = uint256_create_from_u32(0);
+    start = now_ns();
+    for (long i = 0; i < iters; i++) {
+      uint256_sub_to(&acc[1], &acc[1], &pool_b[i % POOL_SIZE]);
+    }
+    snprintf(name, sizeof(name), "%s sub_to", uint256_backend_name(backend));
+    report(name, now_ns() - start, iters);
+
+    acc[2] = uint256_create_from_u32(1);
+    start = now_ns();
+    for (long i = 0; i < iters; i++) {
+      UInt256 x = pool_a[i % POOL_SIZE];
+      x.data[0] |= 1U; // odd, so the product never collapses to zero
+      uint256_mul_to(&acc[2], &acc[2], &x);
+    }
+    snprintf(name, sizeof(name), "%s mul_to", uint256_backend_name(backend));
+    report(name, now_ns() - start, iters);
+
+    acc[3] = uint256_create_from_u32(0);
+    start = now_ns();
+    for (long i = 0; i < iters; i++) {
+      UInt256 x;
+      uint256_lshift_to(&x, &pool_a[i % POOL_SIZE], (unsigned)i % 256);
+      uint256_add_to(&acc[3], &acc[3], &x);
+    }
+    snprintf(name, sizeof(name), "%s lshift_to (+add_to)",
+             uint256_backend_name(backend));
+    report(name, now_ns() - start, iters);
+
+    if (!have_expected) {
+      memcpy(expected, acc, sizeof(acc));
+      have_expected = 1;
+    } else if (memcmp(expected, acc, sizeof(acc)) != 0) {
+      fprintf(stderr, "backend %s disagrees with generic\n",
+              uint256_backend_name(backend));
+      exit(1);
+    }
+  }
+  uint256_dispatch_init();
+}
+
+// Reference: find the bit length one bit at a time, the way callers
+// had to before uint256_bit_length existed.
+static unsigned bitwise_bit_length(UInt256 val) {
+  for (unsigned i = 256; i > 0; i--) {
+    if (uint256_is_bit_set(val, i - 1)) {
+      return i;
+    }
+  }
+  return 0;
+}
+
+static void bench_bits(long iters) {
+  // shift the pool values right so the bit lengths vary
+  UInt256 vals[POOL_SIZE];
+  for (int i = 0; i < POOL_SIZE; i++) {
+    vals[i] = uint256_rshift(pool_a[i], (unsigned)(i * 37) % 256);
+    if (bitwise_bit_length(vals[i]) != uint256_bit_length(vals[i])) {
+      fprintf(stderr, "uint256_bit_length mismatch at pool index %d\n", i);
+      exit(1);
+    }
+  }
+
+  unsigned acc = 0;
+  double start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc += bitwise_bit_length(vals[i % POOL_SIZE]);
+  }
+  report("bit length (bit-at-a-time)", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc += uint256_bit_length(vals[i % POOL_SIZE]);
+  }
+  report("uint256_bit_length", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc += uint256_popcount(vals[i % POOL_SIZE]);
+  }
+  report("uint256_popcount", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc += (unsigned)uint256_cmp(vals[i % POOL_SIZE], pool_b[i % POOL_SIZE]);
+  }
+  report("uint256_cmp", now_ns() - start, iters);
+
+  UInt256 x = pool_a[0];
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    x = uint256_xor(uint256_rotl(x, (unsigned)i), pool_b[i % POOL_SIZE]);
+  }
+  report("x = rotl(x, i) ^ y", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    x = uint256_xor(uint256_rshift(x, (unsigned)i % 256),
+                    pool_b[i % POOL_SIZE]);
+  }
+  report("x = rshift(x, i) ^ y", now_ns() - start, iters);
+
+  sink = acc ^ x.data[0];
+}
+
+// The original limb-wise left shift, which branches on whether the
+// shift is a whole number of limbs and on the limb boundaries, kept as
+// the baseline for the funnel-shift kernels (shift must be less than
+// 256). It is kept out of line, since the library's shifts are calls.
+__attribute__((noinline)) static UInt256 limb_lshift(UInt256 val,
+                                                     unsigned shift) {
+  UInt256 result = {0};
+  int element_shift = shift / 32;
+  int bits_shift = shift % 32;
+  if (bits_shift > 0) {
+    for (int i = 7; i >= element_shift; i--) {
+      result.data[i] = val.data[i - element_shift] << bits_shift;
+      if ((i - element_shift) > 0) {
+        result.data[i] |= val.data[i - element_shift - 1] >> (32 - bits_shift);
+      }
+    }
+  } else {
+    for (int i = 7; i >= element_shift; i--) {
+      result.data[i] = val.data[i - element_shift];
+    }
+  }
+  return result;
+}
+
+// Shifts by random counts, so that a branch on the count can't be
+// predicted: single values (the baseline only takes counts below 256)
+// and per-element batches (with a quarter of the counts 256 or more).
+static void bench_shift(long iters) {
+  unsigned shifts[POOL_SIZE], any_shifts[POOL_SIZE];
+  for (int i = 0; i < POOL_SIZE; i++) {
+    uint64_t r = rng_next();
+    shifts[i] = (unsigned)(r & 255);
+    any_shifts[i] = (unsigned)(r & 1023) < 768 ? shifts[i] : 256 + shifts[i];
+    UInt256 want = limb_lshift(pool_a[i], shifts[i]);
+    UInt256 got = uint256_lshift(pool_a[i], shifts[i]);
+    if (memcmp(&want, &got, sizeof(UInt256)) != 0) {
+      fprintf(stderr, "uint256_lshift mismatch at pool index %d\n", i);
+      exit(1);
+    }
+  }
+
+  UInt256 x = pool_a[0];
+  double start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    x = uint256_xor(limb_lshift(x, shifts[i % POOL_SIZE]),
+                    pool_b[i % POOL_SIZE]);
+  }
+  report("x = lshift(x, s) ^ y (limb loop)", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    x = uint256_xor(uint256_lshift(x, shifts[i % POOL_SIZE]),
+                    pool_b[i % POOL_SIZE]);
+  }
+  report("x = lshift(x, s) ^ y", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    x = uint256_xor(uint256_rshift(x, shifts[i % POOL_SIZE]),
+                    pool_b[i % POOL_SIZE]);
+  }
+  report("x = rshift(x, s) ^ y", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    x = uint256_xor(uint256_rotl(x, shifts[i % POOL_SIZE]),
+                    pool_b[i % POOL_SIZE]);
+  }
+  report("x = rotl(x, s) ^ y", now_ns() - start, iters);
+
+  UInt256 *dst = malloc(POOL_SIZE * sizeof(UInt256));
+  long rounds = iters / POOL_SIZE > 0 ? iters / POOL_SIZE : 1;
+  long elems = rounds * POOL_SIZE;
+  uint32_t acc = 0;
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    for (int i = 0; i < POOL_SIZE; i++) {
+      dst[i] = limb_lshift(pool_a[i], shifts[i]);
+    }
+    acc ^= dst[r % POOL_SIZE].data[0];
+  }
+  report_rate("loop over limb-loop lshift", now_ns() - start, elems);
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    for (int i = 0; i < POOL_SIZE; i++) {
+      dst[i] = uint256_lshift(pool_a[i], any_shifts[i]);
+    }
+    acc ^= dst[r % POOL_SIZE].data[0];
+  }
+  report_rate("loop over uint256_lshift", now_ns() - start, elems);
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    uint256_lshift_n(dst, pool_a, any_shifts, POOL_SIZE);
+    acc ^= dst[r % POOL_SIZE].data[0];
+  }
+  report_rate("uint256_lshift_n", now_ns() - start, elems);
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    for (int i = 0; i < POOL_SIZE; i++) {
+      dst[i] = uint256_rshift(pool_a[i], any_shifts[i]);
+    }
+    acc ^= dst[r % POOL_SIZE].data[0];
+  }
+  report_rate("loop over uint256_rshift", now_ns() - start, elems);
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    uint256_rshift_n(dst, pool_a, any_shifts, POOL_SIZE);
+    acc ^= dst[r % POOL_SIZE].data[0];
+  }
+  report_rate("uint256_rshift_n", now_ns() - start, elems);
+
+  free(dst);
+  sink = acc ^ x.data[0];
+}
+
+// Reference gcd: Euclid's algorithm with a full division per step.
+static UInt256 divmod_gcd(UInt256 a, UInt256 b) {
+  while (!uint256_is_zero(b)) {
+    UInt256 r;
+    uint256_divmod(a, b, NULL, &r);
+    a = b;
+    b = r;
+  }
+  return a;
+}
+
+static void bench_gcd(long iters) {
+  for (int i = 0; i < 64; i++) {
+    UInt256 x = divmod_gcd(pool_a[i], pool_b[i]);
+    UInt256 y = uint256_gcd(pool_a[i], pool_b[i]);
+    UInt256 z = uint256_gcd_lehmer(pool_a[i], pool_b[i]);
+    if (memcmp(&x, &y, sizeof(UInt256)) != 0 ||
+        memcmp(&x, &z, sizeof(UInt256)) != 0) {
+      fprintf(stderr, "uint256_gcd mismatch at pool index %d\n", i);
+      exit(1);
+    }
+  }
+
+  long gcd_iters = iters / 100 > 0 ? iters / 100 : 1;
+  uint32_t acc = 0;
+  double start = now_ns();
+  for (long i = 0; i < gcd_iters; i++) {
+    acc ^= fold(divmod_gcd(pool_a[i % POOL_SIZE], pool_b[i % POOL_SIZE]));
+  }
+  report("gcd (Euclid, divmod per step)", now_ns() - start, gcd_iters);
+
+  start = now_ns();
+  for (long i = 0; i < gcd_iters; i++) {
+    acc ^= fold(uint256_gcd(pool_a[i % POOL_SIZE], pool_b[i % POOL_SIZE]));
+  }
+  report("uint256_gcd", now_ns() - start, gcd_iters);
+
+  start = now_ns();
+  for (long i = 0; i < gcd_iters; i++) {
+    acc ^= fold(
+        uint256_gcd_lehmer(pool_a[i % POOL_SIZE], pool_b[i % POOL_SIZE]));
+  }
+  report("uint256_gcd_lehmer", now_ns() - start, gcd_iters);
+
+  // inverses modulo 2^255 - 19, against Fermat's a^(p-2) mod p
+  UInt256 p = uint256_field_p25519.modulus;
+  UInt256 p_minus_2 = uint256_sub(p, uint256_create_from_u32(2U));
+  UInt256MontCtx ctx;
+  uint256_mont_init(&ctx, p);
+  for (int i = 0; i < 16; i++) {
+    UInt256 x, y;
+    uint256_modinv(pool_a[i], p, &x);
+    y = uint256_mont_from(
+        &ctx, uint256_mont_pow(&ctx, uint256_mont_to(&ctx, pool_a[i]),
+                               p_minus_2));
+    if (memcmp(&x, &y, sizeof(UInt256)) != 0) {
+      fprintf(stderr, "uint256_modinv mismatch at pool index %d\n", i);
+      exit(1);
+    }
+  }
+
+  long inv_iters = iters / 1000 > 0 ? iters / 1000 : 1;
+  start = now_ns();
+  for (long i = 0; i < inv_iters; i++) {
+    UInt256 a = uint256_mont_to(&ctx, pool_a[i % POOL_SIZE]);
+    acc ^= fold(uint256_mont_from(&ctx, uint256_mont_pow(&ctx, a, p_minus_2)));
+  }
+  report("modinv (Fermat, mont_pow)", now_ns() - start, inv_iters);
+
+  start = now_ns();
+  for (long i = 0; i < inv_iters; i++) {
+    UInt256 inv;
+    uint256_modinv(pool_a[i % POOL_SIZE], p, &inv);
+    acc ^= fold(inv);
+  }
+  report("uint256_modinv", now_ns() - start, inv_iters);
+  sink = acc;
+}
+
+// Reference mulmod through a general division: the 512-bit product is
+// divided by m with schoolbook long division on 32-bit limbs (Knuth,
+// TAOCP vol. 2, Algorithm 4.3.1D), keeping only the remainder.
+static UInt256 long_div_mulmod(UInt256 a, UInt256 b, UInt256 m) {
+  UInt256 hi, lo;
+  uint256_mul_wide(a, b, &hi, &lo);
+  uint32_t u[17], v[8];
+  int n = 8;
+  while (m.data[n - 1] == 0) {
+    n--;
+  }
+
+  // normalize so the top limb of the divisor has its top bit set
+  unsigned s = (unsigned)__builtin_clz(m.data[n - 1]);
+  for (int i = n - 1; i > 0; i--) {
+    v[i] = (m.data[i] << s) | (s ? m.data[i - 1] >> (32 - s) : 0);
+  }
+  v[0] = m.data[0] << s;
+  u[16] = s ? hi.data[7] >> (32 - s) : 0;
+  for (int i = 15; i >= 0; i--) {
+    uint32_t cur = i >= 8 ? hi.data[i - 8] : lo.data[i];
+    uint32_t prev = i == 0 ? 0 : i - 1 >= 8 ? hi.data[i - 9] : lo.data[i - 1];
+    u[i] = (cur << s) | (s ? prev >> (32 - s) : 0);
+  }
+
+  for (int j = 16 - n; j >= 0; j--) {
+    uint64_t num = ((uint64_t)u[j + n] << 32) | u[j + n - 1];
+    uint64_t qhat = num / v[n - 1];
+    uint64_t rhat = num % v[n - 1];
+    while (qhat >> 32 ||
+           (n > 1 && qhat * v[n - 2] > ((rhat << 32) | u[j + n - 2]))) {
+      qhat--;
+      rhat += v[n - 1];
+      if (rhat >> 32) {
+        break;
+      }
+    }
+    // u[j..j+n] -= qhat * v
+    int64_t borrow = 0;
+    uint64_t carry = 0;
+    for (int i = 0; i < n; i++) {
+      uint64_t p = qhat * v[i] + carry;
+      carry = p >> 32;
+      int64_t t = (int64_t)u[i + j] - (int64_t)(uint32_t)p + borrow;
+      u[i + j] = (uint32_t)t;
+      borrow = t >> 32;
+    }
+    int64_t t = (int64_t)u[j + n] - (int64_t)carry + borrow;
+    u[j + n] = (uint32_t)t;
+    if (t < 0) {
+      // qhat was one too large: add v back
+      carry = 0;
+      for (int i = 0; i < n; i++) {
+        uint64_t sum = (uint64_t)u[i + j] + v[i] + carry;
+        u[i + j] = (uint32_t)sum;
+        carry = sum >> 32;
+      }
+      u[j + n] += (uint32_t)carry;
+    }
+  }
+
+  UInt256 r = uint256_create_from_u32(0);
+  for (int i = 0; i < n; i++) {
+    r.data[i] = (u[i] >> s) | (s && i + 1 < n ? u[i + 1] << (32 - s) : 0);
+  }
+  return r;
+}
+
+static void bench_barrett(long iters) {
+  // even moduli of 256 and 160 bits (the second like a bucket count)
+  UInt256 moduli[2] = {pool_b[0], pool_b[1]};
+  moduli[0].data[0] &= ~1U;
+  moduli[0].data[7] |= 0x80000000U;
+  moduli[1].data[0] &= ~1U;
+  for (int j = 5; j < 8; j++) {
+    moduli[1].data[j] = 0;
+  }
+  moduli[1].data[4] |= 0x80000000U;
+  char name[64];
+  uint32_t acc = 0;
+
+  for (int k = 0; k < 2; k++) {
+    UInt256 m = moduli[k];
+    unsigned bits = uint256_bit_length(m);
+    UInt256BarrettCtx ctx;
+    uint256_barrett_init(&ctx, m);
+
+    // sanity check against divmod, the long division and the add/sub-only
+    // mulmod
+    UInt256 am[POOL_SIZE], bm[POOL_SIZE];
+    for (int i = 0; i < POOL_SIZE; i++) {
+      uint256_divmod(pool_a[i], m, NULL, &am[i]);
+      uint256_divmod(pool_b[i], m, NULL, &bm[i]);
+      UInt256 x = uint256_barrett_reduce(&ctx, uint256_create_from_u32(0),
+                                         pool_a[i]);
+      if (memcmp(&x, &am[i], sizeof(UInt256)) != 0) {
+        fprintf(stderr, "uint256_barrett_reduce mismatch at pool index %d\n",
+                i);
+        exit(1);
+      }
+    }
+    for (int i = 0; i < POOL_SIZE; i++) {
+      UInt256 x = uint256_barrett_mulmod(&ctx, am[i], bm[i]);
+      UInt256 y = long_div_mulmod(am[i], bm[i], m);
+      UInt256 z = i < 64 && bits < 256 ? naive_mulmod(am[i], bm[i], m) : y;
+      if (memcmp(&x, &y, sizeof(UInt256)) != 0 ||
+          memcmp(&x, &z, sizeof(UInt256)) != 0) {
+        fprintf(stderr, "uint256_barrett_mulmod mismatch at pool index %d\n",
+                i);
+        exit(1);
+      }
+    }
+
+    UInt256 r;
+    double start = now_ns();
+    for (long i = 0; i < iters; i++) {
+      uint256_divmod(pool_a[i % POOL_SIZE], m, NULL, &r);
+      acc ^= fold(r);
+    }
+    snprintf(name, sizeof(name), "x mod m (divmod, %u-bit m)", bits);
+    report(name, now_ns() - start, iters);
+
+    UInt256 zero = uint256_create_from_u32(0);
+    start = now_ns();
+    for (long i = 0; i < iters; i++) {
+      acc ^= fold(uint256_barrett_reduce(&ctx, zero, pool_a[i % POOL_SIZE]));
+    }
+    snprintf(name, sizeof(name), "x mod m (Barrett, %u-bit m)", bits);
+    report(name, now_ns() - start, iters);
+
+    start = now_ns();
+    for (long i = 0; i < iters; i++) {
+      acc ^= fold(
+          uint256_barrett_mulmod(&ctx, am[i % POOL_SIZE], bm[i % POOL_SIZE]));
+    }
+    snprintf(name, sizeof(name), "uint256_barrett_mulmod (%u-bit m)", bits);
+    report(name, now_ns() - start, iters);
+
+    start = now_ns();
+    for (long i = 0; i < iters; i++) {
+      acc ^= fold(long_div_mulmod(am[i % POOL_SIZE], bm[i % POOL_SIZE], m));
+    }
+    snprintf(name, sizeof(name), "mulmod (long division, %u-bit m)", bits);
+    report(name, now_ns() - start, iters);
+
+    // the add/sub-only reference needs a modulus below 2^255
+    if (bits < 256) {
+      long slow_iters = iters / 100 > 0 ? iters / 100 : 1;
+      start = now_ns();
+      for (long i = 0; i < slow_iters; i++) {
+        acc ^= fold(naive_mulmod(am[i % POOL_SIZE], bm[i % POOL_SIZE], m));
+      }
+      snprintf(name, sizeof(name), "mulmod (add/sub only, %u-bit m)", bits);
+      report(name, now_ns() - start, slow_iters);
+    }
+  }
+  sink = acc;
+}
+
+// Reference exponentiation: left-to-right square-and-multiply, one
+// bit at a time (base and result in Montgomery form).
+static UInt256 binary_mont_pow(const UInt256MontCtx *ctx, UInt256 base,
+                               UInt256 exp) {
+  UInt256 result = ctx->one;
+  for (int i = (int)uint256_bit_length(exp) - 1; i >= 0; i--) {
+    result = uint256_mont_mul(ctx, result, result);
+    if (uint256_is_bit_set(exp, (unsigned)i)) {
+      result = uint256_mont_mul(ctx, result, base);
+    }
+  }
+  return result;
+}
+
+static void bench_mont_pow(long iters) {
+  // secp256k1 field prime, full-width random exponents
+  UInt256 p = uint256_field_secp256k1.modulus;
+  UInt256MontCtx ctx;
+  uint256_mont_init(&ctx, p);
+  UInt256 g = uint256_mont_to(&ctx, pool_a[0]);
+  char name[64];
+
+  for (int i = 0; i < 16; i++) {
+    UInt256 x = binary_mont_pow(&ctx, g, pool_b[i]);
+    UInt256 y = uint256_mont_pow(&ctx, g, pool_b[i]);
+    if (memcmp(&x, &y, sizeof(UInt256)) != 0) {
+      fprintf(stderr, "uint256_mont_pow mismatch at pool index %d\n", i);
+      exit(1);
+    }
+  }
+
+  long pow_iters = iters / 1000 > 0 ? iters / 1000 : 1;
+  uint32_t acc = 0;
+  double start = now_ns();
+  for (long i = 0; i < pow_iters; i++) {
+    acc ^= fold(binary_mont_pow(&ctx, g, pool_b[i % POOL_SIZE]));
+  }
+  report("mont pow (square-and-multiply)", now_ns() - start, pow_iters);
+
+  for (unsigned w = 2; w <= UINT256_MONT_MAX_WINDOW; w++) {
+    start = now_ns();
+    for (long i = 0; i < pow_iters; i++) {
+      acc ^= fold(uint256_mont_pow_window(&ctx, g, pool_b[i % POOL_SIZE], w));
+    }
+    snprintf(name, sizeof(name), "uint256_mont_pow_window (w=%u)", w);
+    report(name, now_ns() - start, pow_iters);
+  }
+
+  for (unsigned w = 4; w <= UINT256_MONT_MAX_WINDOW; w += 2) {
+    UInt256MontFixedBase fb;
+    start = now_ns();
+    if (!uint256_mont_fixed_base_init(&fb, &ctx, g, w)) {
+      fprintf(stderr, "uint256_mont_fixed_base_init failed\n");
+      exit(1);
+    }
+    snprintf(name, sizeof(name), "uint256_mont_fixed_base_init (w=%u)", w);
+    report(name, now_ns() - start, 1);
+
+    for (int i = 0; i < 16; i++) {
+      UInt256 x = binary_mont_pow(&ctx, g, pool_b[i]);
+      UInt256 y = uint256_mont_fixed_base_pow(&fb, pool_b[i]);
+      if (memcmp(&x, &y, sizeof(UInt256)) != 0) {
+        fprintf(stderr, "fixed-base pow mismatch at pool index %d\n", i);
+        exit(1);
+      }
+    }
+
+    start = now_ns();
+    for (long i = 0; i < pow_iters; i++) {
+      acc ^= fold(uint256_mont_fixed_base_pow(&fb, pool_b[i % POOL_SIZE]));
+    }
+    snprintf(name, sizeof(name), "uint256_mont_fixed_base_pow (w=%u)", w);
+    report(name, now_ns() - start, pow_iters);
+    uint256_mont_fixed_base_free(&fb);
+  }
+  sink = acc;
+}
+
+// Big-endian load one byte at a time, the baseline for the word-wise
+// byte-swapping conversions.
+static UInt256 bytewise_load_be(const uint8_t *buf) {
+  UInt256 val = {0};
+  for (int i = 0; i < 32; i++) {
+    val.data[(31 - i) / 4] |= (uint32_t)buf[i] << (8 * ((31 - i) % 4));
+  }
+  return val;
+}
+
+static void bench_bytes(long iters) {
+  uint8_t *buf = malloc(POOL_SIZE * 32);
+  UInt256 *dst = malloc(POOL_SIZE * sizeof(UInt256));
+  uint256_store_be_n(buf, 32, pool_a, POOL_SIZE);
+  for (int i = 0; i < POOL_SIZE; i++) {
+    UInt256 x = uint256_load_be(buf + 32 * i);
+    UInt256 y = bytewise_load_be(buf + 32 * i);
+    if (memcmp(&x, &pool_a[i], sizeof(x)) != 0 ||
+        memcmp(&y, &pool_a[i], sizeof(y)) != 0) {
+      fprintf(stderr, "byte conversion mismatch at %d\n", i);
+      exit(1);
+    }
+  }
+
+  uint32_t acc = 0;
+  double start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc ^= fold(bytewise_load_be(buf + 32 * (i % POOL_SIZE)));
+  }
+  report("bytewise_load_be", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc ^= fold(uint256_load_be(buf + 32 * (i % POOL_SIZE)));
+  }
+  report("uint256_load_be", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    uint256_store_be(buf + 32 * (i % POOL_SIZE), pool_a[i % POOL_SIZE]);
+  }
+  acc ^= buf[7];
+  report("uint256_store_be", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc ^= fold(uint256_load_le(buf + 32 * (i % POOL_SIZE)));
+  }
+  report("uint256_load_le", now_ns() - start, iters);
+
+  long rounds = iters / POOL_SIZE > 0 ? iters / POOL_SIZE : 1;
+  long elems = rounds * POOL_SIZE;
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    for (int i = 0; i < POOL_SIZE; i++) {
+      dst[i] = uint256_load_be(buf + 32 * i);
+    }
+    acc ^= dst[r % POOL_SIZE].data[0];
+  }
+  report_rate("loop over uint256_load_be", now_ns() - start, elems);
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    uint256_load_be_n(dst, buf, 32, POOL_SIZE);
+    acc ^= dst[r % POOL_SIZE].data[0];
+  }
+  report_rate("uint256_load_be_n", now_ns() - start, elems);
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    uint256_store_be_n(buf, 32, pool_a, POOL_SIZE);
+    acc ^= buf[r % POOL_SIZE];
+  }
+  report_rate("uint256_store_be_n", now_ns() - start, elems);
+
+  free(buf);
+  free(dst);
+  sink = acc;
+}
+
+// Each scalar fast path against the general routine it replaces, with
+// the scalar widened by uint256_create_from_u32 as callers did before.
+static void bench_scalar(long iters) {
+  uint32_t acc = 0;
+  UInt256 q;
+  uint32_t rem;
+
+  double start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    int j = i % POOL_SIZE;
+    UInt256 k = uint256_create_from_u32(pool_b[j].data[0]);
+    acc ^= fold(uint256_mul(pool_a[j], k));
+  }
+  report("mul by create_from_u32", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    int j = i % POOL_SIZE;
+    acc ^= fold(uint256_mul_u32(pool_a[j], pool_b[j].data[0]));
+  }
+  report("uint256_mul_u32", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    int j = i % POOL_SIZE;
+    UInt256 k = uint256_create_from_u32(pool_b[j].data[0]);
+    k.data[1] = pool_b[j].data[1];
+    acc ^= fold(uint256_add(pool_a[j], k));
+  }
+  report("add of a widened u64", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    int j = i % POOL_SIZE;
+    uint64_t k = (uint64_t)pool_b[j].data[0] | ((uint64_t)pool_b[j].data[1] << 32);
+    acc ^= fold(uint256_add_u64(pool_a[j], k));
+  }
+  report("uint256_add_u64", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    int j = i % POOL_SIZE;
+    UInt256 k = uint256_create_from_u32(pool_b[j].data[0]);
+    k.data[1] = pool_b[j].data[1];
+    acc += (uint32_t)uint256_cmp(pool_a[j], k);
+  }
+  report("cmp with a widened u64", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    int j = i % POOL_SIZE;
+    uint64_t k = (uint64_t)pool_b[j].data[0] | ((uint64_t)pool_b[j].data[1] << 32);
+    acc += (uint32_t)uint256_cmp_u64(pool_a[j], k);
+  }
+  report("uint256_cmp_u64", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    int j = i % POOL_SIZE;
+    UInt256 k = uint256_create_from_u32(pool_b[j].data[0] | 1);
+    UInt256 r;
+    uint256_divmod(pool_a[j], k, &q, &r);
+    acc ^= fold(q) ^ r.data[0];
+  }
+  report("divmod by create_from_u32", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    int j = i % POOL_SIZE;
+    q = uint256_divmod_u32(pool_a[j], pool_b[j].data[0] | 1, &rem);
+    acc ^= fold(q) ^ rem;
+  }
+  report("uint256_divmod_u32", now_ns() - start, iters);
+
+  sink = acc;
+}
+
+// Summing the pool: a chain of uint256_add, where each addition waits
+// for the previous carry chain, against the carry-save accumulator.
+static void bench_acc(long iters) {
+  long rounds = iters / POOL_SIZE > 0 ? iters / POOL_SIZE : 1;
+  long elems = rounds * POOL_SIZE;
+
+  UInt256 sum = {0};
+  double start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    for (int i = 0; i < POOL_SIZE; i++) {
+      sum = uint256_add(sum, pool_a[i]);
+    }
+  }
+  report_rate("chain of uint256_add", now_ns() - start, elems);
+
+  UInt256Acc acc;
+  uint256_acc_init(&acc);
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    for (int i = 0; i < POOL_SIZE; i++) {
+      uint256_acc_add(&acc, pool_a[i]);
+    }
+  }
+  UInt256 got = uint256_acc_get(&acc);
+  report_rate("uint256_acc_add", now_ns() - start, elems);
+  if (memcmp(&got, &sum, sizeof(sum)) != 0) {
+    fprintf(stderr, "accumulator mismatch\n");
+    exit(1);
+  }
+
+  uint256_acc_init(&acc);
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    uint256_acc_add_n(&acc, pool_a, POOL_SIZE);
+  }
+  got = uint256_acc_get(&acc);
+  report_rate("uint256_acc_add_n", now_ns() - start, elems);
+  if (memcmp(&got, &sum, sizeof(sum)) != 0) {
+    fprintf(stderr, "accumulator mismatch\n");
+    exit(1);
+  }
+
+  sink = fold(got);
+}
+
+// Square root by binary search on the result bits, squaring each
+// candidate with uint256_mul: the approach uint256_isqrt replaces.
+static UInt256 bsearch_isqrt(UInt256 val) {
+  UInt256 r = {0};
+  for (int bit = 127; bit >= 0; bit--) {
+    UInt256 cand = r;
+    cand.data[bit / 32] |= 1U << (bit % 32);
+    if (geq(val, uint256_mul(cand, cand))) {
+      r = cand;
+    }
+  }
+  return r;
+}
+
+static void bench_root(long iters) {
+  for (int i = 0; i < POOL_SIZE; i++) {
+    UInt256 x = uint256_isqrt(pool_a[i]);
+    UInt256 y = bsearch_isqrt(pool_a[i]);
+    if (memcmp(&x, &y, sizeof(x)) != 0) {
+      fprintf(stderr, "isqrt mismatch at %d\n", i);
+      exit(1);
+    }
+  }
+
+  // the binary search is slow; time it on fewer roots
+  long few = iters / 16 > 0 ? iters / 16 : 1;
+  uint32_t acc = 0;
+  double start = now_ns();
+  for (long i = 0; i < few; i++) {
+    acc ^= fold(bsearch_isqrt(pool_a[i % POOL_SIZE]));
+  }
+  report("bsearch_isqrt", now_ns() - start, few);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc ^= fold(uint256_isqrt(pool_a[i % POOL_SIZE]));
+  }
+  report("uint256_isqrt", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < few; i++) {
+    acc ^= fold(uint256_iroot(pool_a[i % POOL_SIZE], 3));
+  }
+  report("uint256_iroot (n = 3)", now_ns() - start, few);
+
+  start = now_ns();
+  for (long i = 0; i < few; i++) {
+    acc ^= fold(uint256_iroot(pool_a[i % POOL_SIZE], 17));
+  }
+  report("uint256_iroot (n = 17)", now_ns() - start, few);
+
+  sink = acc;
+}
+
+static void bench_rng(long iters) {
+  UInt256 *dst = malloc(POOL_SIZE * sizeof(UInt256));
+  long rounds = iters / POOL_SIZE > 0 ? iters / POOL_SIZE : 1;
+  long elems = rounds * POOL_SIZE;
+  UInt256Rng rng;
+  uint256_rng_init(&rng, 1);
+  uint32_t acc = 0;
+
+  // the xorshift64* fill used for the benchmark operands, as a
+  // baseline (it is not counter-based, so it can't be split)
+  double start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    for (int i = 0; i < POOL_SIZE; i++) {
+      dst[i] = random_uint256();
+    }
+    acc ^= dst[r % POOL_SIZE].data[0];
+  }
+  report_rate("xorshift64* fill", now_ns() - start, elems);
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    for (int i = 0; i < POOL_SIZE; i++) {
+      dst[i] = uint256_rng_next(&rng);
+    }
+    acc ^= dst[r % POOL_SIZE].data[0];
+  }
+  report_rate("loop over uint256_rng_next", now_ns() - start, elems);
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    uint256_rng_fill(&rng, dst, POOL_SIZE);
+    acc ^= dst[r % POOL_SIZE].data[0];
+  }
+  report_rate("uint256_rng_fill", now_ns() - start, elems);
+
+  UInt256 bound = uint256_create_from_dec("1000000000000000000000000000000");
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    uint256_rng_below_n(&rng, dst, POOL_SIZE, bound);
+    acc ^= dst[r % POOL_SIZE].data[0];
+  }
+  report_rate("uint256_rng_below_n", now_ns() - start, elems);
+
+  free(dst);
+  sink = acc;
+}
+
+// The sign handling that Int256 replaces: signed values kept in
+// UInt256, with each signed operation done on magnitudes taken with
+// uint256_negate.
+static int is_neg(UInt256 val) {
+  return val.data[7] >> 31;
+}
+
+static int negate_cmp(UInt256 a, UInt256 b) {
+  if (is_neg(a) != is_neg(b)) {
+    return is_neg(b) - is_neg(a);
+  }
+  return uint256_cmp(a, b);
+}
+
+static UInt256 negate_sar(UInt256 val, unsigned shift) {
+  if (!is_neg(val)) {
+    return uint256_rshift(val, shift);
+  }
+  // floor(-m / 2^s) = -ceil(m / 2^s)
+  UInt256 mag = uint256_negate(val);
+  UInt256 r = uint256_rshift(mag, shift);
+  if (shift > 0 && !uint256_is_zero(uint256_lshift(mag, 256 - shift))) {
+    r = uint256_add(r, uint256_create_from_u32(1));
+  }
+  return uint256_negate(r);
+}
+
+static void negate_mul_wide(UInt256 a, UInt256 b, UInt256 *hi,
+                            UInt256 *lo) {
+  int neg = is_neg(a) != is_neg(b);
+  uint256_mul_wide(is_neg(a) ? uint256_negate(a) : a,
+                   is_neg(b) ? uint256_negate(b) : b, hi, lo);
+  if (neg) {
+    // negate the 512-bit product
+    *hi = uint256_not(*hi);
+    *lo = uint256_negate(*lo);
+    if (uint256_is_zero(*lo)) {
+      *hi = uint256_add(*hi, uint256_create_from_u32(1));
+    }
+  }
+}
+
+static void negate_divmod(UInt256 num, UInt256 den, UInt256 *quot,
+                          UInt256 *rem) {
+  uint256_divmod(is_neg(num) ? uint256_negate(num) : num,
+                 is_neg(den) ? uint256_negate(den) : den, quot, rem);
+  if (is_neg(num) != is_neg(den)) {
+    *quot = uint256_negate(*quot);
+  }
+  if (is_neg(num)) {
+    *rem = uint256_negate(*rem);
+  }
+}
+
+static void bench_int256(long iters) {
+  // the pools are half negative as Int256 values; divide by 128-bit
+  // values so the quotients aren't mostly 0 or -1
+  static Int256 sa[POOL_SIZE], sb[POOL_SIZE], sd[POOL_SIZE];
+  static UInt256 ud[POOL_SIZE];
+  for (int i = 0; i < POOL_SIZE; i++) {
+    sa[i] = int256_from_uint256(pool_a[i]);
+    sb[i] = int256_from_uint256(pool_b[i]);
+    ud[i] = pool_b[i];
+    for (int j = 4; j < 8; j++) {
+      ud[i].data[j] = is_neg(pool_b[i]) ? 0xffffffffU : 0;
+    }
+    sd[i] = int256_from_uint256(ud[i]);
+  }
+
+  // sanity check: both ways must agree bit-for-bit
+  for (int i = 0; i < POOL_SIZE; i++) {
+    unsigned s = pool_b[i].data[0] & 255;
+    UInt256 x = int256_to_uint256(int256_sar(sa[i], s));
+    UInt256 y = negate_sar(pool_a[i], s);
+    Int256 hi, q, r;
+    UInt256 lo, hi2, lo2, q2, r2;
+    int256_mul_wide(sa[i], sb[i], &hi, &lo);
+    negate_mul_wide(pool_a[i], pool_b[i], &hi2, &lo2);
+    int256_divmod(sa[i], sd[i], &q, &r);
+    negate_divmod(pool_a[i], ud[i], &q2, &r2);
+    if (int256_cmp(sa[i], sb[i]) != negate_cmp(pool_a[i], pool_b[i]) ||
+        memcmp(&x, &y, sizeof(x)) != 0 || memcmp(&hi, &hi2, 32) != 0 ||
+        memcmp(&lo, &lo2, 32) != 0 || memcmp(&q, &q2, 32) != 0 ||
+        memcmp(&r, &r2, 32) != 0) {
+      fprintf(stderr, "int256 mismatch at pool index %d\n", i);
+      exit(1);
+    }
+  }
+
+  uint32_t acc = 0;
+  double start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc += negate_cmp(pool_a[i % POOL_SIZE], pool_b[i % POOL_SIZE]);
+  }
+  report("compare (sign cases)", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    acc += int256_cmp(sa[i % POOL_SIZE], sb[i % POOL_SIZE]);
+  }
+  report("int256_cmp", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    unsigned s = pool_b[i % POOL_SIZE].data[0] & 255;
+    acc ^= fold(negate_sar(pool_a[i % POOL_SIZE], s));
+  }
+  report("sar (negate + rshift)", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    unsigned s = pool_b[i % POOL_SIZE].data[0] & 255;
+    acc ^= fold(int256_to_uint256(int256_sar(sa[i % POOL_SIZE], s)));
+  }
+  report("int256_sar", now_ns() - start, iters);
+
+  UInt256 hi, lo;
+  Int256 shi;
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    negate_mul_wide(pool_a[i % POOL_SIZE], pool_b[i % POOL_SIZE], &hi, &lo);
+    acc ^= fold(hi);
+  }
+  report("mul_wide (negate magnitudes)", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    int256_mul_wide(sa[i % POOL_SIZE], sb[i % POOL_SIZE], &shi, &lo);
+    acc ^= fold(int256_to_uint256(shi));
+  }
+  report("int256_mul_wide", now_ns() - start, iters);
+
+  UInt256 q, r;
+  Int256 sq, sr;
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    negate_divmod(pool_a[i % POOL_SIZE], ud[i % POOL_SIZE], &q, &r);
+    acc ^= fold(q) ^ fold(r);
+  }
+  report("divmod (negate magnitudes)", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    int256_divmod(sa[i % POOL_SIZE], sd[i % POOL_SIZE], &sq, &sr);
+    acc ^= fold(int256_to_uint256(sq)) ^ fold(int256_to_uint256(sr));
+  }
+  report("int256_divmod", now_ns() - start, iters);
+
+  // decimal strings are slow; time fewer of them
+  long few = iters / 16 > 0 ? iters / 16 : 1;
+  start = now_ns();
+  for (long i = 0; i < few; i++) {
+    char *s = int256_format_as_dec(sa[i % POOL_SIZE]);
+    acc ^= (uint32_t)s[1];
+    free(s);
+  }
+  report("int256_format_as_dec", now_ns() - start, few);
+
+  char *dec = int256_format_as_dec(sa[0]);
+  start = now_ns();
+  for (long i = 0; i < few; i++) {
+    acc ^= fold(int256_to_uint256(int256_create_from_dec(dec)));
+  }
+  report("int256_create_from_dec", now_ns() - start, few);
+  free(dec);
+
+  sink = acc;
+}
+
+// Time expr, a uint32_t computed from operands a = xs[j] and b = ys[j]
+// (and k, a small count taken from b), over iters pool entries.
+#define SWEEP(name, xs, ys, expr)                                     \
+  do {                                                                \
+    uint32_t acc_ = 0;                                                \
+    double start_ = now_ns();                                         \
+    for (long i_ = 0; i_ < iters; i_++) {                             \
+      UInt256 a = (xs)[i_ % POOL_SIZE], b = (ys)[i_ % POOL_SIZE];     \
+      unsigned k = b.data[0] & 255;                                   \
+      (void)a, (void)b, (void)k;                                      \
+      acc_ ^= (expr);                                                 \
+    }                                                                 \
+    report(name, now_ns() - start_, iters);                           \
+    sink = acc_;                                                      \
+  } while (0)
+
+// The exported functions that none of the benchmarks above time. The
+// backend queries are left out: they only read a variable.
+static void bench_rest(long iters) {
+  const UInt256Field *field = &uint256_field_secp256k1;
+  UInt256MontCtx ctx;
+  uint256_mont_init(&ctx, field->modulus);
+  UInt256 zero = uint256_create_from_u32(0);
+  // field and Montgomery operands must be reduced
+  static UInt256 ra[POOL_SIZE], rb[POOL_SIZE];
+  for (int i = 0; i < POOL_SIZE; i++) {
+    ra[i] = field->reduce(zero, pool_a[i]);
+    rb[i] = field->reduce(zero, pool_b[i]);
+  }
+
+  SWEEP("uint256_create", pool_a, pool_b, fold(uint256_create(a.data)));
+  SWEEP("uint256_get_bits", pool_a, pool_b, uint256_get_bits(a, k & 7));
+  SWEEP("uint256_and", pool_a, pool_b, fold(uint256_and(a, b)));
+  SWEEP("uint256_or", pool_a, pool_b, fold(uint256_or(a, b)));
+  SWEEP("uint256_not", pool_a, pool_b, fold(uint256_not(a)));
+  SWEEP("uint256_rotr", pool_a, pool_b, fold(uint256_rotr(a, k)));
+  SWEEP("uint256_clz", pool_a, pool_b, uint256_clz(uint256_rshift(a, k)));
+  SWEEP("uint256_ctz", pool_a, pool_b, uint256_ctz(uint256_lshift(a, k)));
+  SWEEP("uint256_mul_add_u32", pool_a, pool_b,
+        fold(uint256_mul_add_u32(a, b.data[1], b.data[2])));
+  SWEEP("uint256_sub_u64", pool_a, pool_b,
+        fold(uint256_sub_u64(a, b.data[1] | (uint64_t)b.data[2] << 32)));
+  SWEEP("uint256_secp256k1_reduce", pool_a, pool_b,
+        fold(uint256_secp256k1_reduce(a, b)));
+  SWEEP("uint256_p256_reduce", pool_a, pool_b,
+        fold(uint256_p256_reduce(a, b)));
+  SWEEP("uint256_p25519_reduce", pool_a, pool_b,
+        fold(uint256_p25519_reduce(a, b)));
+  SWEEP("uint256_field_add (secp256k1)", ra, rb,
+        fold(uint256_field_add(field, a, b)));
+  SWEEP("uint256_field_sub (secp256k1)", ra, rb,
+        fold(uint256_field_sub(field, a, b)));
+  SWEEP("uint256_mont_add", ra, rb, fold(uint256_mont_add(&ctx, a, b)));
+  SWEEP("uint256_mont_sub", ra, rb, fold(uint256_mont_sub(&ctx, a, b)));
+
+  UInt256Rng rng, child;
+  uint256_rng_init(&rng, 1);
+  SWEEP("uint256_rng_below", pool_a, pool_b,
+        fold(uint256_rng_below(&rng, b)));
+  SWEEP("uint256_rng_split", pool_a, pool_b,
+        (uint256_rng_split(&child, &rng, k), (uint32_t)child.stream));
+
+  UInt256Acc acc;
+  uint256_acc_init(&acc);
+  SWEEP("uint256_acc_sub", pool_a, pool_b,
+        (uint256_acc_sub(&acc, a), (uint32_t)acc.lanes[0]));
+  SWEEP("uint256_acc_merge", pool_a, pool_b,
+        (uint256_acc_merge(&acc, &acc), (uint32_t)acc.lanes[0]));
+
+  // batch functions, by the element
+  uint8_t *buf = malloc(POOL_SIZE * 32);
+  UInt256 *dst = malloc(POOL_SIZE * sizeof(UInt256));
+  UInt256Vec vec;
+  uint256_vec_init(&vec, POOL_SIZE);
+  uint256_vec_load(&vec, pool_a);
+  long rounds = iters / POOL_SIZE > 0 ? iters / POOL_SIZE : 1;
+  long elems = rounds * POOL_SIZE;
+  uint32_t sum = 0;
+
+  double start = now_ns();
+  for (long i = 0; i < iters; i++) {
+    uint256_store_le(buf + 32 * (i % POOL_SIZE), pool_a[i % POOL_SIZE]);
+  }
+  sum ^= buf[7];
+  report("uint256_store_le", now_ns() - start, iters);
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    uint256_store_le_n(buf, 32, pool_a, POOL_SIZE);
+    sum ^= buf[r % POOL_SIZE];
+  }
+  report_rate("uint256_store_le_n", now_ns() - start, elems);
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    uint256_load_le_n(dst, buf, 32, POOL_SIZE);
+    sum ^= dst[r % POOL_SIZE].data[0];
+  }
+  report_rate("uint256_load_le_n", now_ns() - start, elems);
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    uint256_vec_store(&vec, dst);
+    sum ^= dst[r % POOL_SIZE].data[0];
+  }
+  report_rate("uint256_vec_store", now_ns() - start, elems);
+
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    uint256_rng_fill_at(&rng, dst, POOL_SIZE, (uint64_t)r * POOL_SIZE);
+    sum ^= dst[r % POOL_SIZE].data[0];
+  }
+  report_rate("uint256_rng_fill_at", now_ns() - start, elems);
+
+  uint256_vec_cleanup(&vec);
+  free(buf);
+  free(dst);
+  sink = sum;
+}
+
+int main(int argc, char **argv) {
+  long iters = DEFAULT_ITERS;
+  if (argc > 1) {
+    iters = strtol(argv[1], NULL, 10);
+    if (iters <= 0) {
+      fprintf(stderr, "Usage: uint256_bench [iterations]\n");
+      return 1;
+    }
+  }
+
+  fill_pools();
+  calibrate_cycles();
+  bench_add_sub(iters);
+  bench_mul(iters);
+  bench_mul_wide(iters);
+  bench_mont(iters);
+  bench_mont_pow(iters);
+  bench_field(iters);
+  bench_divmod(iters);
+  bench_dec(iters);
+  bench_hex_format(iters);
+  bench_hex_parse(iters);
+  bench_in_place(iters);
+  bench_batch(iters);
+  bench_dispatch(iters);
+  bench_bits(iters);
+  bench_shift(iters);
+  bench_gcd(iters);
+  bench_barrett(iters);
+  bench_bytes(iters);
+  bench_scalar(iters);
+  bench_acc(iters);
+  bench_root(iters);
+  bench_rng(iters);
+  bench_int256(iters);
+  bench_rest(iters);
+  return 0;
+}
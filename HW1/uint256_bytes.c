@@ -0,0 +1,183 @@
+#include "uint256_bytes.h"
+#include <stdint.h>
+#include <string.h>
+#include "uint256_kernels.h"
+#include "uint256_limbs.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define UINT256_BYTES_LE_HOST 1
+#endif
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(UINT256_PORTABLE)
+#define UINT256_BYTES_AVX2 1
+#include <immintrin.h>
+#endif
+
+#ifdef UINT256_BYTES_LE_HOST
+
+// On a little-endian host the limbs of a UInt256 are laid out exactly
+// like its little-endian byte encoding, so those conversions are plain
+// copies. The big-endian ones move 64-bit words with a byte swap
+// (BSWAP, or MOVBE where the compiler may use it): word i of the value
+// is the byte-reversed word at offset 24 - 8*i of the buffer.
+
+static inline uint64_t load64(const uint8_t *p) {
+  uint64_t w;
+  memcpy(&w, p, 8);
+  return w;
+}
+
+static inline void store64(uint8_t *p, uint64_t w) {
+  memcpy(p, &w, 8);
+}
+
+UInt256 uint256_load_be(const uint8_t *buf) {
+  UInt256 val;
+  store_words(val.data, __builtin_bswap64(load64(buf + 24)),
+              __builtin_bswap64(load64(buf + 16)),
+              __builtin_bswap64(load64(buf + 8)),
+              __builtin_bswap64(load64(buf)));
+  return val;
+}
+
+UInt256 uint256_load_le(const uint8_t *buf) {
+  UInt256 val;
+  memcpy(val.data, buf, 32);
+  return val;
+}
+
+void uint256_store_be(uint8_t *buf, UInt256 val) {
+  uint64_t w0, w1, w2, w3;
+  memcpy(&w0, &val.data[0], 8);
+  memcpy(&w1, &val.data[2], 8);
+  memcpy(&w2, &val.data[4], 8);
+  memcpy(&w3, &val.data[6], 8);
+  store64(buf + 24, __builtin_bswap64(w0));
+  store64(buf + 16, __builtin_bswap64(w1));
+  store64(buf + 8, __builtin_bswap64(w2));
+  store64(buf, __builtin_bswap64(w3));
+}
+
+void uint256_store_le(uint8_t *buf, UInt256 val) {
+  memcpy(buf, val.data, 32);
+}
+
+#else
+
+// Any other host: assemble each limb from its bytes.
+
+static uint32_t get_limb(const uint8_t *p, int be) {
+  if (be) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | p[3];
+  }
+  return ((uint32_t)p[3] << 24) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[1] << 8) | p[0];
+}
+
+static void put_limb(uint8_t *p, uint32_t limb, int be) {
+  for (int i = 0; i < 4; i++) {
+    p[be ? 3 - i : i] = (uint8_t)(limb >> (8 * i));
+  }
+}
+
+UInt256 uint256_load_be(const uint8_t *buf) {
+  UInt256 val;
+  for (int i = 0; i < 8; i++) {
+    val.data[i] = get_limb(buf + 28 - 4 * i, 1);
+  }
+  return val;
+}
+
+UInt256 uint256_load_le(const uint8_t *buf) {
+  UInt256 val;
+  for (int i = 0; i < 8; i++) {
+    val.data[i] = get_limb(buf + 4 * i, 0);
+  }
+  return val;
+}
+
+void uint256_store_be(uint8_t *buf, UInt256 val) {
+  for (int i = 0; i < 8; i++) {
+    put_limb(buf + 28 - 4 * i, val.data[i], 1);
+  }
+}
+
+void uint256_store_le(uint8_t *buf, UInt256 val) {
+  for (int i = 0; i < 8; i++) {
+    put_limb(buf + 4 * i, val.data[i], 0);
+  }
+}
+
+#endif // UINT256_BYTES_LE_HOST
+
+#ifdef UINT256_BYTES_AVX2
+
+#define AVX2 __attribute__((target("avx2")))
+
+// Reverse all 32 bytes of a register: VPSHUFB reverses the bytes within
+// each 128-bit lane, then VPERMQ swaps the two lanes. Reversal is its
+// own inverse, so the same kernel serves loads and stores.
+AVX2 static void reverse32_n(uint8_t *dst, size_t dst_stride,
+                             const uint8_t *src, size_t src_stride,
+                             size_t n) {
+  const __m256i rev = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5,
+                                       4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10,
+                                       9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+  for (size_t k = 0; k < n; k++) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(src + k * src_stride));
+    v = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, rev), 0x4e);
+    _mm256_storeu_si256((__m256i *)(dst + k * dst_stride), v);
+  }
+}
+
+#undef AVX2
+
+static int have_avx2(void) {
+  return (uint256_cpu_features() & UINT256_CPU_AVX2) != 0;
+}
+
+#endif // UINT256_BYTES_AVX2
+
+// The big-endian batches are one 256-bit byte reversal per record when
+// AVX2 is available; otherwise, and for the little-endian batches,
+// they loop over the single-value conversions.
+void uint256_load_be_n(UInt256 *dst, const uint8_t *buf, size_t stride,
+                       size_t n) {
+#ifdef UINT256_BYTES_AVX2
+  if (have_avx2()) {
+    reverse32_n((uint8_t *)dst, sizeof(UInt256), buf, stride, n);
+    return;
+  }
+#endif
+  for (size_t k = 0; k < n; k++) {
+    dst[k] = uint256_load_be(buf + k * stride);
+  }
+}
+
+void uint256_load_le_n(UInt256 *dst, const uint8_t *buf, size_t stride,
+                       size_t n) {
+  for (size_t k = 0; k < n; k++) {
+    dst[k] = uint256_load_le(buf + k * stride);
+  }
+}
+
+void uint256_store_be_n(uint8_t *buf, size_t stride, const UInt256 *src,
+                        size_t n) {
+#ifdef UINT256_BYTES_AVX2
+  if (have_avx2()) {
+    reverse32_n(buf, stride, (const uint8_t *)src, sizeof(UInt256), n);
+    return;
+  }
+#endif
+  for (size_t k = 0; k < n; k++) {
+    uint256_store_be(buf + k * stride, src[k]);
+  }
+}
+
+void uint256_store_le_n(uint8_t *buf, size_t stride, const UInt256 *src,
+                        size_t n) {
+  for (size_t k = 0; k < n; k++) {
+    uint256_store_le(buf + k * stride, src[k]);
+  }
+}
@@ -0,0 +1,38 @@
+#ifndef UINT256_BYTES_H
+#define UINT256_BYTES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "uint256.h"
+
+// Conversion between UInt256 values and raw 32-byte buffers, in
+// big-endian (most significant byte first, as in network and disk
+// formats) or little-endian byte order. Buffers need no particular
+// alignment.
+
+// Load a value from 32 big-endian bytes.
+UInt256 uint256_load_be( const uint8_t *buf );
+
+// Load a value from 32 little-endian bytes.
+UInt256 uint256_load_le( const uint8_t *buf );
+
+// Store a value as 32 big-endian bytes.
+void uint256_store_be( uint8_t *buf, UInt256 val );
+
+// Store a value as 32 little-endian bytes.
+void uint256_store_le( uint8_t *buf, UInt256 val );
+
+// Batch versions for a column of fixed-size records: the 32-byte field
+// of record k starts at buf + k * stride, for k in [0, n). A stride of
+// 32 is a packed array of fields. For the stores, stride must be at
+// least 32 so that the fields don't overlap.
+void uint256_load_be_n( UInt256 *dst, const uint8_t *buf, size_t stride,
+                        size_t n );
+void uint256_load_le_n( UInt256 *dst, const uint8_t *buf, size_t stride,
+                        size_t n );
+void uint256_store_be_n( uint8_t *buf, size_t stride, const UInt256 *src,
+                         size_t n );
+void uint256_store_le_n( uint8_t *buf, size_t stride, const UInt256 *src,
+                         size_t n );
+
+#endif // UINT256_BYTES_H
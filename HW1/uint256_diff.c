@@ -0,0 +1,870 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "int256.h"
+#include "uint256.h"
+#include "uint256_acc.h"
+#include "uint256_barrett.h"
+#include "uint256_batch.h"
+#include "uint256_bytes.h"
+#include "uint256_dispatch.h"
+#include "uint256_gcd.h"
+#include "uint256_mont.h"
+#include "uint256_root.h"
+
+// Differential tests for the UInt256 library.
+//
+// Usage: uint256_diff [iterations] [seed]
+//
+// Every group of operations is run on `iterations` sets of random
+// operands (fewer for the slow ones), and each result is compared with
+// a reference computed with the compiler's unsigned __int128. A 256-bit reference value is
+// a pair of 128-bit halves, so the linear operations, shifts, bit
+// queries and multiplication are checked at full width; division,
+// roots, gcd and the modular operations use operands narrow enough
+// for a single 128-bit value.
+//
+// Operand bit lengths are drawn uniformly (and one operand in 8 is all
+// ones below its length), so small values, long carry chains and limb
+// boundaries come up far more often than with uniform 256-bit values.
+// The whole run is repeated for every backend the CPU supports. The
+// operands come from splitmix64 rather than uint256_rng, so that the
+// inputs don't depend on the code under test.
+
+#define DEFAULT_ITERS 1000000L
+#define MAX_FAILURES 10
+
+#ifdef __SIZEOF_INT128__
+
+__extension__ typedef unsigned __int128 u128;
+__extension__ typedef __int128 s128;
+
+#define U128_MAX (~(u128)0)
+
+// A 256-bit reference value.
+typedef struct {
+  u128 lo, hi;
+} Wide;
+
+static uint64_t gen_state;
+static long results; // number of results compared
+static long failures;
+
+// splitmix64
+static uint64_t next64(void) {
+  uint64_t z = (gen_state += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static Wide wide(u128 lo, u128 hi) {
+  Wide w;
+  w.lo = lo;
+  w.hi = hi;
+  return w;
+}
+
+static UInt256 to_uint256(Wide w) {
+  UInt256 val;
+  for (int i = 0; i < 4; i++) {
+    val.data[i] = (uint32_t)(w.lo >> (32 * i));
+    val.data[i + 4] = (uint32_t)(w.hi >> (32 * i));
+  }
+  return val;
+}
+
+static Wide from_uint256(UInt256 val) {
+  Wide w = {0, 0};
+  for (int i = 3; i >= 0; i--) {
+    w.lo = (w.lo << 32) | val.data[i];
+    w.hi = (w.hi << 32) | val.data[i + 4];
+  }
+  return w;
+}
+
+// A random value of at most maxbits bits (maxbits <= 256).
+static Wide random_wide(unsigned maxbits) {
+  uint64_t ctl = next64();
+  unsigned len = (unsigned)((ctl >> 8) % (maxbits + 1));
+  Wide w;
+  if ((ctl & 7) == 0) {
+    w = wide(U128_MAX, U128_MAX);
+  } else {
+    w.lo = ((u128)next64() << 64) | next64();
+    w.hi = len > 128 ? ((u128)next64() << 64) | next64() : 0;
+  }
+  if (len <= 128) {
+    w.hi = 0;
+    if (len < 128) {
+      w.lo &= ((u128)1 << len) - 1;
+    }
+    if (len > 0) {
+      w.lo |= (u128)1 << (len - 1);
+    }
+  } else {
+    if (len < 256) {
+      w.hi &= ((u128)1 << (len - 128)) - 1;
+    }
+    w.hi |= (u128)1 << (len - 129);
+  }
+  return w;
+}
+
+static u128 random_u128(unsigned maxbits) {
+  return random_wide(maxbits).lo;
+}
+
+// Return x + y + *carry, and set *carry to the carry out.
+static u128 add_carry(u128 x, u128 y, unsigned *carry) {
+  u128 s = x + y;
+  unsigned c = s < x;
+  u128 t = s + *carry;
+  c += t < s;
+  *carry = c;
+  return t;
+}
+
+static Wide wide_add(Wide a, Wide b) {
+  unsigned carry = 0;
+  Wide r;
+  r.lo = add_carry(a.lo, b.lo, &carry);
+  r.hi = a.hi + b.hi + carry;
+  return r;
+}
+
+static Wide wide_sub(Wide a, Wide b) {
+  Wide r;
+  r.lo = a.lo - b.lo;
+  r.hi = a.hi - b.hi - (a.lo < b.lo);
+  return r;
+}
+
+static Wide wide_shl(Wide a, unsigned s) {
+  if (s == 0) {
+    return a;
+  }
+  if (s >= 256) {
+    return wide(0, 0);
+  }
+  if (s >= 128) {
+    return wide(0, a.lo << (s - 128));
+  }
+  return wide(a.lo << s, (a.hi << s) | (a.lo >> (128 - s)));
+}
+
+static Wide wide_shr(Wide a, unsigned s) {
+  if (s == 0) {
+    return a;
+  }
+  if (s >= 256) {
+    return wide(0, 0);
+  }
+  if (s >= 128) {
+    return wide(a.hi >> (s - 128), 0);
+  }
+  return wide((a.lo >> s) | (a.hi << (128 - s)), a.hi >> s);
+}
+
+static int wide_cmp(Wide a, Wide b) {
+  if (a.hi != b.hi) {
+    return a.hi < b.hi ? -1 : 1;
+  }
+  if (a.lo != b.lo) {
+    return a.lo < b.lo ? -1 : 1;
+  }
+  return 0;
+}
+
+// The full 256-bit product of two 128-bit values.
+static Wide mul128(u128 a, u128 b) {
+  uint64_t a0 = (uint64_t)a, a1 = (uint64_t)(a >> 64);
+  uint64_t b0 = (uint64_t)b, b1 = (uint64_t)(b >> 64);
+  u128 p00 = (u128)a0 * b0, p01 = (u128)a0 * b1;
+  u128 p10 = (u128)a1 * b0, p11 = (u128)a1 * b1;
+  u128 mid = (p00 >> 64) + (uint64_t)p01 + (uint64_t)p10;
+  return wide((mid << 64) | (uint64_t)p00,
+              p11 + (p01 >> 64) + (p10 >> 64) + (mid >> 64));
+}
+
+// The product modulo 2^256.
+static Wide wide_mul(Wide a, Wide b) {
+  Wide r = mul128(a.lo, b.lo);
+  r.hi += a.lo * b.hi + a.hi * b.lo;
+  return r;
+}
+
+// The full 512-bit product, from four 128x128 products.
+static void wide_mul_full(Wide a, Wide b, Wide *hi, Wide *lo) {
+  Wide ll = mul128(a.lo, b.lo), lh = mul128(a.lo, b.hi);
+  Wide hl = mul128(a.hi, b.lo), hh = mul128(a.hi, b.hi);
+  unsigned c1 = 0, c2 = 0;
+  u128 w1 = add_carry(ll.hi, lh.lo, &c1);
+  w1 = add_carry(w1, hl.lo, &c2);
+  unsigned c3 = c1 + c2, c4 = 0;
+  u128 w2 = add_carry(lh.hi, hl.hi, &c4);
+  unsigned c5 = 0;
+  w2 = add_carry(w2, hh.lo, &c5);
+  unsigned c6 = 0;
+  u128 t = (u128)c3;
+  w2 = add_carry(w2, t, &c6);
+  *lo = wide(ll.lo, w1);
+  *hi = wide(w2, hh.hi + c4 + c5 + c6);
+}
+
+static unsigned wide_popcount(Wide a) {
+  return __builtin_popcountll((uint64_t)a.lo) +
+         __builtin_popcountll((uint64_t)(a.lo >> 64)) +
+         __builtin_popcountll((uint64_t)a.hi) +
+         __builtin_popcountll((uint64_t)(a.hi >> 64));
+}
+
+static unsigned clz128(u128 x) {
+  uint64_t hi = (uint64_t)(x >> 64);
+  if (hi != 0) {
+    return __builtin_clzll(hi);
+  }
+  uint64_t lo = (uint64_t)x;
+  return lo != 0 ? 64 + __builtin_clzll(lo) : 128;
+}
+
+static unsigned ctz128(u128 x) {
+  uint64_t lo = (uint64_t)x;
+  if (lo != 0) {
+    return __builtin_ctzll(lo);
+  }
+  uint64_t hi = (uint64_t)(x >> 64);
+  return hi != 0 ? 64 + __builtin_ctzll(hi) : 128;
+}
+
+static unsigned wide_clz(Wide a) {
+  return a.hi != 0 ? clz128(a.hi) : 128 + clz128(a.lo);
+}
+
+static unsigned wide_ctz(Wide a) {
+  return a.lo != 0 ? ctz128(a.lo) : 128 + ctz128(a.hi);
+}
+
+static u128 gcd128(u128 a, u128 b) {
+  while (b != 0) {
+    u128 t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+// Inverse of a modulo m, or 0 if there is none (2 <= m < 2^126, so
+// the signed coefficients can't overflow).
+static u128 modinv128(u128 a, u128 m) {
+  s128 r0 = (s128)(a % m), r1 = (s128)m, x0 = 1, x1 = 0;
+  while (r1 != 0) {
+    s128 q = r0 / r1, t;
+    t = r0 - q * r1;
+    r0 = r1;
+    r1 = t;
+    t = x0 - q * x1;
+    x0 = x1;
+    x1 = t;
+  }
+  if (r0 != 1) {
+    return 0;
+  }
+  return (u128)(x0 < 0 ? x0 + (s128)m : x0);
+}
+
+// Return 1 if r^n <= x.
+static int pow_le(u128 r, unsigned n, u128 x) {
+  u128 p = 1;
+  for (unsigned i = 0; i < n; i++) {
+    if (__builtin_mul_overflow(p, r, &p) || p > x) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// floor(x^(1/n)), from a floating-point estimate.
+static u128 iroot128(u128 x, unsigned n) {
+  if (x == 0 || n == 1) {
+    return x;
+  }
+  long double est = x == 1 ? 1 : powl((long double)x, 1.0L / n);
+  u128 r = est >= 0x1p127L ? U128_MAX >> 1 : (u128)est;
+  while (r > 0 && !pow_le(r, n, x)) {
+    r--;
+  }
+  while (pow_le(r + 1, n, x)) {
+    r++;
+  }
+  return r;
+}
+
+static u128 powmod128(u128 base, u128 exp, u128 m) {
+  u128 r = 1 % m;
+  base %= m;
+  while (exp != 0) {
+    if (exp & 1) {
+      r = r * base % m;
+    }
+    base = base * base % m;
+    exp >>= 1;
+  }
+  return r;
+}
+
+static void print_wide(const char *label, Wide w) {
+  fprintf(stderr, "  %-5s 0x%016llx%016llx%016llx%016llx\n", label,
+          (unsigned long long)(w.hi >> 64), (unsigned long long)w.hi,
+          (unsigned long long)(w.lo >> 64), (unsigned long long)w.lo);
+}
+
+// Report a mismatch, and give up once there have been too many.
+static void fail(const char *op, Wide a, Wide b, Wide got, Wide want) {
+  fprintf(stderr, "%s: mismatch (backend %s)\n", op,
+          uint256_backend_name(uint256_get_backend()));
+  print_wide("a", a);
+  print_wide("b", b);
+  print_wide("got", got);
+  print_wide("want", want);
+  if (++failures >= MAX_FAILURES) {
+    fprintf(stderr, "too many failures, giving up\n");
+    exit(1);
+  }
+}
+
+static void check(const char *op, UInt256 got, Wide want, Wide a, Wide b) {
+  UInt256 w = to_uint256(want);
+  results++;
+  if (memcmp(&got, &w, sizeof(UInt256)) != 0) {
+    fail(op, a, b, from_uint256(got), want);
+  }
+}
+
+static void check_int(const char *op, long got, long want, Wide a, Wide b) {
+  results++;
+  if (got != want) {
+    fail(op, a, b, wide((u128)got, 0), wide((u128)want, 0));
+  }
+}
+
+static void diff_add_sub(long n) {
+  for (long i = 0; i < n; i++) {
+    Wide a = random_wide(256), b = random_wide(256);
+    UInt256 x = to_uint256(a), y = to_uint256(b), r;
+    check("add", uint256_add(x, y), wide_add(a, b), a, b);
+    check("sub", uint256_sub(x, y), wide_sub(a, b), a, b);
+    check("negate", uint256_negate(x), wide_sub(wide(0, 0), a), a, b);
+    uint256_add_to(&r, &x, &y);
+    check("add_to", r, wide_add(a, b), a, b);
+    uint256_sub_to(&r, &x, &y);
+    check("sub_to", r, wide_sub(a, b), a, b);
+    uint256_negate_to(&r, &x);
+    check("negate_to", r, wide_sub(wide(0, 0), a), a, b);
+  }
+}
+
+static void diff_mul(long n) {
+  for (long i = 0; i < n; i++) {
+    Wide a = random_wide(256), b = random_wide(256), hi, lo;
+    UInt256 x = to_uint256(a), y = to_uint256(b), rhi, rlo;
+    check("mul", uint256_mul(x, y), wide_mul(a, b), a, b);
+    uint256_mul_to(&rlo, &x, &y);
+    check("mul_to", rlo, wide_mul(a, b), a, b);
+    wide_mul_full(a, b, &hi, &lo);
+    uint256_mul_wide(x, y, &rhi, &rlo);
+    check("mul_wide (hi)", rhi, hi, a, b);
+    check("mul_wide (lo)", rlo, lo, a, b);
+    check("sqr", uint256_sqr(x), wide_mul(a, a), a, a);
+    wide_mul_full(a, a, &hi, &lo);
+    uint256_sqr_wide(x, &rhi, &rlo);
+    check("sqr_wide (hi)", rhi, hi, a, a);
+    check("sqr_wide (lo)", rlo, lo, a, a);
+  }
+}
+
+static void diff_scalar(long n) {
+  for (long i = 0; i < n; i++) {
+    Wide a = random_wide(256);
+    uint64_t k = (uint64_t)random_u128(64);
+    uint32_t k32 = (uint32_t)k, addend = (uint32_t)next64();
+    Wide wk = wide(k, 0), wk32 = wide(k32, 0);
+    UInt256 x = to_uint256(a);
+    check("mul_u32", uint256_mul_u32(x, k32), wide_mul(a, wk32), a, wk32);
+    check("mul_add_u32", uint256_mul_add_u32(x, k32, addend),
+          wide_add(wide_mul(a, wk32), wide(addend, 0)), a, wk32);
+    check("add_u64", uint256_add_u64(x, k), wide_add(a, wk), a, wk);
+    check("sub_u64", uint256_sub_u64(x, k), wide_sub(a, wk), a, wk);
+    check_int("cmp_u64", uint256_cmp_u64(x, k), wide_cmp(a, wk), a, wk);
+  }
+}
+
+static void diff_divmod(long n) {
+  for (long i = 0; i < n; i++) {
+    u128 num = random_u128(128), den = random_u128(128);
+    if (den == 0) {
+      den = 1;
+    }
+    Wide a = wide(num, 0), b = wide(den, 0);
+    UInt256 q, r;
+    uint256_divmod(to_uint256(a), to_uint256(b), &q, &r);
+    check("divmod (quot)", q, wide(num / den, 0), a, b);
+    check("divmod (rem)", r, wide(num % den, 0), a, b);
+
+    uint32_t d32 = (uint32_t)den;
+    if (d32 == 0) {
+      d32 = 1;
+    }
+    uint32_t r32;
+    q = uint256_divmod_u32(to_uint256(a), d32, &r32);
+    check("divmod_u32 (quot)", q, wide(num / d32, 0), a, wide(d32, 0));
+    check_int("divmod_u32 (rem)", r32, (long)(num % d32), a, wide(d32, 0));
+  }
+}
+
+// A shift count: mostly less than 256, but any count is allowed, so
+// a quarter go past the end of the value and some are huge.
+static unsigned random_shift(void) {
+  uint64_t r = next64();
+  switch (r & 3) {
+  case 0:
+    return (unsigned)(r >> 32);
+  case 1:
+    return 256 + (unsigned)(r >> 2 & 255);
+  default:
+    return (unsigned)(r >> 2 & 255);
+  }
+}
+
+static void diff_shift(long n) {
+  for (long i = 0; i < n; i++) {
+    Wide a = random_wide(256);
+    unsigned s = random_shift();
+    Wide ws = wide(s, 0);
+    UInt256 x = to_uint256(a), r;
+    check("lshift", uint256_lshift(x, s), wide_shl(a, s), a, ws);
+    uint256_lshift_to(&r, &x, s);
+    check("lshift_to", r, wide_shl(a, s), a, ws);
+    check("rshift", uint256_rshift(x, s), wide_shr(a, s), a, ws);
+    unsigned t = s % 256;
+    Wide rotl = t == 0 ? a : wide(wide_shl(a, t).lo | wide_shr(a, 256 - t).lo,
+                                  wide_shl(a, t).hi | wide_shr(a, 256 - t).hi);
+    check("rotl", uint256_rotl(x, s), rotl, a, ws);
+    check("rotr", uint256_rotr(x, 256 - t), rotl, a, ws);
+  }
+}
+
+static void diff_bitwise(long n) {
+  for (long i = 0; i < n; i++) {
+    Wide a = random_wide(256), b = random_wide(256);
+    if ((next64() & 3) == 0) {
+      b = a; // make equal operands common for cmp
+    }
+    UInt256 x = to_uint256(a), y = to_uint256(b);
+    check("and", uint256_and(x, y), wide(a.lo & b.lo, a.hi & b.hi), a, b);
+    check("or", uint256_or(x, y), wide(a.lo | b.lo, a.hi | b.hi), a, b);
+    check("xor", uint256_xor(x, y), wide(a.lo ^ b.lo, a.hi ^ b.hi), a, b);
+    check("not", uint256_not(x), wide(~a.lo, ~a.hi), a, b);
+    check_int("cmp", uint256_cmp(x, y), wide_cmp(a, b), a, b);
+    check_int("is_zero", uint256_is_zero(x), a.lo == 0 && a.hi == 0, a, b);
+    check_int("popcount", uint256_popcount(x), wide_popcount(a), a, b);
+    check_int("clz", uint256_clz(x), wide_clz(a), a, b);
+    check_int("ctz", uint256_ctz(x), wide_ctz(a), a, b);
+    check_int("bit_length", uint256_bit_length(x), 256 - wide_clz(a), a, b);
+    unsigned bit = (unsigned)(next64() & 255);
+    check_int("is_bit_set", uint256_is_bit_set(x, bit),
+              (int)(wide_shr(a, bit).lo & 1), a, wide(bit, 0));
+    check_int("get_bits", uint256_get_bits(x, bit / 32),
+              (uint32_t)wide_shr(a, bit / 32 * 32).lo, a, wide(bit / 32, 0));
+  }
+}
+
+static void diff_bytes(long n) {
+  for (long i = 0; i < n; i++) {
+    Wide a = random_wide(256);
+    uint8_t be[32], le[32], buf[32];
+    for (int j = 0; j < 16; j++) {
+      le[j] = (uint8_t)(a.lo >> (8 * j));
+      le[j + 16] = (uint8_t)(a.hi >> (8 * j));
+    }
+    for (int j = 0; j < 32; j++) {
+      be[j] = le[31 - j];
+    }
+    check("load_be", uint256_load_be(be), a, a, a);
+    check("load_le", uint256_load_le(le), a, a, a);
+    uint256_store_be(buf, to_uint256(a));
+    check_int("store_be", memcmp(buf, be, 32) == 0, 1, a, a);
+    uint256_store_le(buf, to_uint256(a));
+    check_int("store_le", memcmp(buf, le, 32) == 0, 1, a, a);
+  }
+}
+
+// Hex and decimal digits of a reference value, most significant first.
+static void ref_hex(Wide a, char *buf) {
+  int len = 0;
+  char tmp[65];
+  do {
+    tmp[len++] = "0123456789abcdef"[a.lo & 15];
+    a = wide_shr(a, 4);
+  } while (a.lo != 0 || a.hi != 0);
+  for (int i = 0; i < len; i++) {
+    buf[i] = tmp[len - 1 - i];
+  }
+  buf[len] = '\0';
+}
+
+static void ref_dec(u128 a, char *buf) {
+  int len = 0;
+  char tmp[40];
+  do {
+    tmp[len++] = (char)('0' + a % 10);
+    a /= 10;
+  } while (a != 0);
+  for (int i = 0; i < len; i++) {
+    buf[i] = tmp[len - 1 - i];
+  }
+  buf[len] = '\0';
+}
+
+static void diff_strings(long n) {
+  char want[80], got[80];
+  for (long i = 0; i < n; i++) {
+    Wide a = random_wide(256);
+    UInt256 x = to_uint256(a);
+    ref_hex(a, want);
+    check("create_from_hex", uint256_create_from_hex(want), a, a, a);
+    uint256_format_as_hex_into(x, got, sizeof(got));
+    check_int("format_as_hex_into", strcmp(got, want) == 0, 1, a, a);
+    char *s = uint256_format_as_hex(x);
+    check_int("format_as_hex", strcmp(s, want) == 0, 1, a, a);
+    free(s);
+
+    Wide d = wide(random_u128(128), 0);
+    ref_dec(d.lo, want);
+    check("create_from_dec", uint256_create_from_dec(want), d, d, d);
+    UInt256 parsed;
+    check_int("parse_dec", uint256_parse_dec(want, strlen(want), &parsed), 1,
+              d, d);
+    check("parse_dec", parsed, d, d, d);
+    s = uint256_format_as_dec(to_uint256(d));
+    check_int("format_as_dec", strcmp(s, want) == 0, 1, d, d);
+    free(s);
+  }
+}
+
+static void diff_roots(long n) {
+  for (long i = 0; i < n; i++) {
+    Wide a = wide(random_u128(128), 0);
+    unsigned k = 3 + (unsigned)(next64() % 40);
+    check("isqrt", uint256_isqrt(to_uint256(a)), wide(iroot128(a.lo, 2), 0),
+          a, a);
+    check("iroot", uint256_iroot(to_uint256(a), k), wide(iroot128(a.lo, k), 0),
+          a, wide(k, 0));
+  }
+}
+
+static void diff_gcd(long n) {
+  for (long i = 0; i < n; i++) {
+    u128 g = random_u128(32);
+    Wide a = wide(random_u128(96) * g, 0), b = wide(random_u128(96) * g, 0);
+    UInt256 x = to_uint256(a), y = to_uint256(b), inv;
+    Wide want = wide(gcd128(a.lo, b.lo), 0);
+    check("gcd", uint256_gcd(x, y), want, a, b);
+    check("gcd_lehmer", uint256_gcd_lehmer(x, y), want, a, b);
+    if (b.lo >= 2 && (b.lo >> 126) == 0) {
+      u128 ref = modinv128(a.lo, b.lo);
+      int ok = uint256_modinv(x, y, &inv);
+      check_int("modinv (status)", ok, ref != 0, a, b);
+      check("modinv", inv, wide(ref, 0), a, b);
+    }
+  }
+}
+
+// Modular arithmetic with a random modulus of up to 64 bits, so that
+// products of reduced values fit in 128 bits.
+static void diff_modular(long n) {
+  for (long i = 0; i < n; i++) {
+    u128 m = random_u128(64) | 1;
+    if (m == 1) {
+      m = 3;
+    }
+    u128 a = random_u128(64) % m, b = random_u128(64) % m;
+    u128 e = random_u128(64);
+    Wide wm = wide(m, 0), wa = wide(a, 0), wb = wide(b, 0);
+    UInt256MontCtx mont;
+    uint256_mont_init(&mont, to_uint256(wm));
+    UInt256 ma = uint256_mont_to(&mont, to_uint256(wa));
+    UInt256 mb = uint256_mont_to(&mont, to_uint256(wb));
+    check("mont_mul", uint256_mont_from(&mont, uint256_mont_mul(&mont, ma, mb)),
+          wide(a * b % m, 0), wa, wb);
+    check("mont_add", uint256_mont_add(&mont, to_uint256(wa), to_uint256(wb)),
+          wide((a + b) % m, 0), wa, wb);
+    check("mont_sub", uint256_mont_sub(&mont, to_uint256(wa), to_uint256(wb)),
+          wide((a + m - b) % m, 0), wa, wb);
+    check("mont_pow",
+          uint256_mont_from(&mont, uint256_mont_pow(&mont, ma,
+                                                    to_uint256(wide(e, 0)))),
+          wide(powmod128(a, e, m), 0), wa, wide(e, 0));
+
+    // Barrett accepts any nonzero modulus; use up to 128 bits
+    u128 bm = random_u128(128) | 1;
+    UInt256BarrettCtx barrett;
+    uint256_barrett_init(&barrett, to_uint256(wide(bm, 0)));
+    u128 x = random_u128(64), y = random_u128(64);
+    check("barrett_mulmod",
+          uint256_barrett_mulmod(&barrett, to_uint256(wide(x, 0)),
+                                 to_uint256(wide(y, 0))),
+          wide(x * y % bm, 0), wide(x, 0), wide(y, 0));
+    Wide v = wide(random_u128(128), 0);
+    check("barrett_reduce",
+          uint256_barrett_reduce(&barrett, to_uint256(wide(0, 0)), to_uint256(v)),
+          wide(v.lo % bm, 0), v, wide(bm, 0));
+  }
+}
+
+// Batch operations, 64 elements at a time (an iteration per element).
+// A signed value in (-2^127, 2^127), sign-extended (so that the s128
+// reference division can't overflow).
+static Wide random_signed(void) {
+  u128 v = random_u128(127);
+  if (next64() & 1) {
+    v = -v;
+  }
+  return wide(v, (s128)v < 0 ? U128_MAX : 0);
+}
+
+// Arithmetic right shift: ~(~a >> s) for negative a (so all ones for
+// shifts of 256 or more).
+static Wide wide_sar(Wide a, unsigned s) {
+  if ((s128)a.hi >= 0) {
+    return wide_shr(a, s);
+  }
+  Wide r = wide_shr(wide(~a.lo, ~a.hi), s);
+  return wide(~r.lo, ~r.hi);
+}
+
+static void ref_signed_dec(s128 a, char *buf) {
+  if (a < 0) {
+    *buf++ = '-';
+  }
+  ref_dec(a < 0 ? -(u128)a : (u128)a, buf);
+}
+
+// Int256 operations. Compare and shift are checked at full width (a
+// reference compare flips the sign bits); multiplication, division and
+// decimal conversion use sign-extended 128-bit operands, with products
+// formed from the magnitudes.
+static void diff_signed(long n) {
+  char want[48];
+  for (long i = 0; i < n; i++) {
+    Wide a = random_wide(256), b = random_wide(256);
+    if ((next64() & 3) == 0) {
+      b = a;
+    }
+    Int256 x = int256_from_uint256(to_uint256(a));
+    Int256 y = int256_from_uint256(to_uint256(b));
+    u128 bias = (u128)1 << 127;
+    check_int("int256_cmp", int256_cmp(x, y),
+              wide_cmp(wide(a.lo, a.hi ^ bias), wide(b.lo, b.hi ^ bias)), a, b);
+    unsigned s = random_shift();
+    check("int256_sar", int256_to_uint256(int256_sar(x, s)), wide_sar(a, s), a,
+          wide(s, 0));
+
+    Wide c = random_signed(), d = random_signed();
+    s128 sc = (s128)c.lo, sd = (s128)d.lo;
+    Int256 u = int256_from_uint256(to_uint256(c));
+    Int256 v = int256_from_uint256(to_uint256(d));
+    Wide prod = mul128(sc < 0 ? -c.lo : c.lo, sd < 0 ? -d.lo : d.lo);
+    if ((sc < 0) != (sd < 0)) {
+      prod = wide_sub(wide(0, 0), prod);
+    }
+    Int256 hi;
+    UInt256 lo;
+    int256_mul_wide(u, v, &hi, &lo);
+    check("int256_mul_wide (lo)", lo, prod, c, d);
+    check("int256_mul_wide (hi)", int256_to_uint256(hi),
+          (s128)prod.hi < 0 ? wide(U128_MAX, U128_MAX) : wide(0, 0), c, d);
+    check("int256_mul", int256_to_uint256(int256_mul(u, v)), prod, c, d);
+
+    if (sd == 0) {
+      sd = 1;
+      d = wide(1, 0);
+      v = int256_create_from_i64(1);
+    }
+    Int256 q, r;
+    int256_divmod(u, v, &q, &r);
+    s128 qq = sc / sd, rr = sc % sd;
+    check("int256_divmod (quot)", int256_to_uint256(q),
+          wide(qq, qq < 0 ? U128_MAX : 0), c, d);
+    check("int256_divmod (rem)", int256_to_uint256(r),
+          wide(rr, rr < 0 ? U128_MAX : 0), c, d);
+
+    ref_signed_dec(sc, want);
+    check("int256_create_from_dec",
+          int256_to_uint256(int256_create_from_dec(want)), c, c, c);
+    char *got = int256_format_as_dec(u);
+    check_int("int256_format_as_dec", strcmp(got, want) == 0, 1, c, c);
+    free(got);
+  }
+}
+
+static void diff_batch(long n) {
+  enum { N = 64 };
+  Wide a[N], b[N];
+  UInt256 x[N], y[N], r[N];
+  int c[N];
+  unsigned shifts[N];
+  for (long done = 0; done < n; done += N) {
+    for (int j = 0; j < N; j++) {
+      a[j] = random_wide(256);
+      b[j] = (next64() & 3) == 0 ? a[j] : random_wide(256);
+      x[j] = to_uint256(a[j]);
+      y[j] = to_uint256(b[j]);
+      shifts[j] = random_shift();
+    }
+    uint256_add_n(r, x, y, N);
+    for (int j = 0; j < N; j++) {
+      check("add_n", r[j], wide_add(a[j], b[j]), a[j], b[j]);
+    }
+    uint256_sub_n(r, x, y, N);
+    for (int j = 0; j < N; j++) {
+      check("sub_n", r[j], wide_sub(a[j], b[j]), a[j], b[j]);
+    }
+    uint256_cmp_n(c, x, y, N);
+    for (int j = 0; j < N; j++) {
+      check_int("cmp_n", c[j], wide_cmp(a[j], b[j]), a[j], b[j]);
+    }
+    uint256_lshift_n(r, x, shifts, N);
+    for (int j = 0; j < N; j++) {
+      check("lshift_n", r[j], wide_shl(a[j], shifts[j]), a[j],
+            wide(shifts[j], 0));
+    }
+    uint256_rshift_n(r, x, shifts, N);
+    for (int j = 0; j < N; j++) {
+      check("rshift_n", r[j], wide_shr(a[j], shifts[j]), a[j],
+            wide(shifts[j], 0));
+    }
+  }
+}
+
+// Accumulator sums of 64 values at a time, with random signs (an
+// iteration per value).
+static void diff_acc(long n) {
+  enum { N = 64 };
+  UInt256 vals[N];
+  for (long done = 0; done < n; done += N) {
+    UInt256Acc acc, other;
+    uint256_acc_init(&acc);
+    uint256_acc_init(&other);
+    Wide want = {0, 0};
+    for (int j = 0; j < N; j++) {
+      Wide v = random_wide(256);
+      vals[j] = to_uint256(v);
+      uint64_t ctl = next64() & 3;
+      if (ctl == 0) {
+        uint256_acc_sub(&acc, vals[j]);
+        want = wide_sub(want, v);
+      } else if (ctl == 1) {
+        uint256_acc_add(&other, vals[j]);
+        want = wide_add(want, v);
+      } else {
+        uint256_acc_add(&acc, vals[j]);
+        want = wide_add(want, v);
+      }
+    }
+    uint256_acc_merge(&acc, &other);
+    check("acc", uint256_acc_get(&acc), want, want, want);
+    uint256_acc_add_n(&acc, vals, N);
+    for (int j = 0; j < N; j++) {
+      want = wide_add(want, from_uint256(vals[j]));
+    }
+    check("acc_add_n", uint256_acc_get(&acc), want, want, want);
+  }
+}
+
+typedef struct {
+  const char *name;
+  void (*run)(long n);
+  int cost; // run iterations / cost times, to keep the slow ones short
+} DiffOp;
+
+static const DiffOp diff_ops[] = {
+  {"add/sub/negate", diff_add_sub, 1},
+  {"mul/sqr", diff_mul, 1},
+  {"scalar", diff_scalar, 1},
+  {"divmod", diff_divmod, 1},
+  {"shift/rotate", diff_shift, 1},
+  {"bitwise/compare/query", diff_bitwise, 1},
+  {"bytes", diff_bytes, 1},
+  {"hex/dec strings", diff_strings, 8},
+  {"isqrt/iroot", diff_roots, 16},
+  {"gcd/modinv", diff_gcd, 16},
+  {"mont/barrett", diff_modular, 16},
+  {"batch", diff_batch, 1},
+  {"acc", diff_acc, 1},
+  {"int256", diff_signed, 4},
+};
+
+int main(int argc, char **argv) {
+  long iters = DEFAULT_ITERS;
+  uint64_t seed = 1;
+  if (argc > 1) {
+    iters = strtol(argv[1], NULL, 10);
+    if (iters <= 0) {
+      fprintf(stderr, "Usage: uint256_diff [iterations] [seed]\n");
+      return 1;
+    }
+  }
+  if (argc > 2) {
+    seed = strtoull(argv[2], NULL, 0);
+  }
+
+  UInt256Backend saved = uint256_get_backend();
+  for (int be = 0; be < UINT256_NUM_BACKENDS; be++) {
+    if (!uint256_set_backend((UInt256Backend)be)) {
+      continue;
+    }
+    printf("backend %s, seed %llu\n", uint256_backend_name((UInt256Backend)be),
+           (unsigned long long)seed);
+    gen_state = seed;
+    for (size_t i = 0; i < sizeof(diff_ops) / sizeof(diff_ops[0]); i++) {
+      long n = iters / diff_ops[i].cost;
+      if (n == 0) {
+        n = 1;
+      }
+      long before = results;
+      double start = now_ns();
+      diff_ops[i].run(n);
+      double elapsed = now_ns() - start;
+      printf("%-24s %12ld results %10.2f M/s\n", diff_ops[i].name,
+             results - before, (results - before) / elapsed * 1e3);
+    }
+  }
+  uint256_set_backend(saved);
+
+  if (failures > 0) {
+    printf("%ld mismatches\n", failures);
+    return 1;
+  }
+  printf("all results match\n");
+  return 0;
+}
+
+#else // !__SIZEOF_INT128__
+
+int main(void) {
+  printf("uint256_diff needs unsigned __int128; nothing to do\n");
+  return 0;
+}
+
+#endif // __SIZEOF_INT128__
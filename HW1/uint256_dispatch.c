@@ -0,0 +1,216 @@
+#include "uint256_dispatch.h"
+#include <stdint.h>
+#include "uint256_kernels.h"
+#include "uint256_limbs.h"
+
+// The BMI2/ADX kernels and the CPU feature checks need GCC-style
+// target attributes and cpuid.h. The kernels are compiled without
+// -mbmi2/-madx, so the rest of the library still runs on any x86-64;
+// the CPU check below decides whether they are ever called.
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(UINT256_PORTABLE)
+#define UINT256_DISPATCH_X86 1
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+const UInt256Kernels *uint256_kernels = &uint256_generic_kernels;
+
+static UInt256Backend current_backend = UINT256_BACKEND_GENERIC;
+
+#ifdef UINT256_DISPATCH_X86
+
+#define BMI2_ADX __attribute__((target("bmi2,adx")))
+
+// The kernels work on the value as four 64-bit words; on x86-64 that
+// is the same memory as the eight 32-bit limbs. Words are read with
+// get_word and results go out through store_words (uint256_limbs.h).
+// Operands are loaded in full before anything is stored, so r may
+// alias a or b.
+BMI2_ADX static void add_bmi2_adx(uint32_t r[8], const uint32_t a[8],
+                                  const uint32_t b[8]) {
+  unsigned long long s0, s1, s2, s3;
+  unsigned char c = _addcarryx_u64(0, get_word(a, 0), get_word(b, 0), &s0);
+  c = _addcarryx_u64(c, get_word(a, 1), get_word(b, 1), &s1);
+  c = _addcarryx_u64(c, get_word(a, 2), get_word(b, 2), &s2);
+  _addcarryx_u64(c, get_word(a, 3), get_word(b, 3), &s3);
+  store_words(r, s0, s1, s2, s3);
+}
+
+// ADX has no borrow-chain counterpart of ADCX, so this is a plain SBB
+// chain over the 64-bit words.
+BMI2_ADX static void sub_bmi2_adx(uint32_t r[8], const uint32_t a[8],
+                                  const uint32_t b[8]) {
+  unsigned long long d0, d1, d2, d3;
+  unsigned char c = _subborrow_u64(0, get_word(a, 0), get_word(b, 0), &d0);
+  c = _subborrow_u64(c, get_word(a, 1), get_word(b, 1), &d1);
+  c = _subborrow_u64(c, get_word(a, 2), get_word(b, 2), &d2);
+  _subborrow_u64(c, get_word(a, 3), get_word(b, 3), &d3);
+  store_words(r, d0, d1, d2, d3);
+}
+
+// Truncated 4x4-word schoolbook product, one row per word of a.
+// MULX leaves the flags alone, so within a row two independent carry
+// chains can run side by side: ADCX adds the low halves of the partial
+// products (carry in CF) and ADOX adds the high halves one word further
+// up (carry in OF). Compilers don't keep two flag chains live from the
+// intrinsics, so this is written in assembly. Partial products that
+// fall entirely above 2^256 are never formed, and the high half of the
+// last product in each row is discarded. Only the final row, which has
+// no chain left to disturb, uses IMUL (it clobbers CF and OF).
+BMI2_ADX static void mul_bmi2_adx(uint32_t r[8], const uint32_t a[8],
+                                  const uint32_t b[8]) {
+  unsigned long long x[4], y[4];
+  for (int i = 0; i < 4; i++) {
+    x[i] = get_word(a, i);
+    y[i] = get_word(b, i);
+  }
+  unsigned long long r0, r1, r2, r3, lo, hi;
+  __asm__("movq %[a0], %%rdx\n\t"
+          "mulxq %[b0], %[r0], %[r1]\n\t"
+          "mulxq %[b1], %[lo], %[r2]\n\t"
+          "addq %[lo], %[r1]\n\t"
+          "mulxq %[b2], %[lo], %[r3]\n\t"
+          "adcq %[lo], %[r2]\n\t"
+          "mulxq %[b3], %[lo], %[hi]\n\t"
+          "adcq %[lo], %[r3]\n\t"
+
+          "movq %[a1], %%rdx\n\t"
+          "xorl %k[lo], %k[lo]\n\t" // clears CF and OF
+          "mulxq %[b0], %[lo], %[hi]\n\t"
+          "adcxq %[lo], %[r1]\n\t"
+          "adoxq %[hi], %[r2]\n\t"
+          "mulxq %[b1], %[lo], %[hi]\n\t"
+          "adcxq %[lo], %[r2]\n\t"
+          "adoxq %[hi], %[r3]\n\t"
+          "mulxq %[b2], %[lo], %[hi]\n\t"
+          "adcxq %[lo], %[r3]\n\t"
+
+          "movq %[a2], %%rdx\n\t"
+          "xorl %k[lo], %k[lo]\n\t"
+          "mulxq %[b0], %[lo], %[hi]\n\t"
+          "adcxq %[lo], %[r2]\n\t"
+          "adoxq %[hi], %[r3]\n\t"
+          "mulxq %[b1], %[lo], %[hi]\n\t"
+          "adcxq %[lo], %[r3]\n\t"
+
+          "movq %[a3], %%rdx\n\t"
+          "imulq %[b0], %%rdx\n\t"
+          "addq %%rdx, %[r3]"
+          : [r0] "=&r"(r0), [r1] "=&r"(r1), [r2] "=&r"(r2), [r3] "=&r"(r3),
+            [lo] "=&r"(lo), [hi] "=&r"(hi)
+          : [a0] "m"(x[0]), [a1] "m"(x[1]), [a2] "m"(x[2]), [a3] "m"(x[3]),
+            [b0] "m"(y[0]), [b1] "m"(y[1]), [b2] "m"(y[2]), [b3] "m"(y[3])
+          : "rdx", "cc");
+  store_words(r, r0, r1, r2, r3);
+}
+
+// The shared barrel shifter from uint256_limbs.h, compiled for BMI2:
+// the variable shifts become SHLX/SHRX and the selects ANDN, which
+// don't touch the flags or need the count in CL.
+BMI2_ADX static void lshift_bmi2_adx(uint32_t r[8], const uint32_t a[8],
+                                     unsigned shift) {
+  lshift_words(r, a, shift);
+}
+
+static const UInt256Kernels bmi2_adx_kernels = {
+    add_bmi2_adx,
+    sub_bmi2_adx,
+    mul_bmi2_adx,
+    lshift_bmi2_adx,
+};
+
+#endif // UINT256_DISPATCH_X86
+
+// Check CPUID leaf 7 for BMI2 (MULX, SHLX) and ADX (ADCX, ADOX).
+// AVX2 also needs the OS to save the YMM registers, which
+// __builtin_cpu_supports checks along with the CPUID bit.
+static unsigned detect_cpu_features(void) {
+  unsigned features = 0;
+#ifdef UINT256_DISPATCH_X86
+  unsigned eax, ebx, ecx, edx;
+  if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_BMI2) &&
+      (ebx & bit_ADX)) {
+    features |= UINT256_CPU_BMI2_ADX;
+  }
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    features |= UINT256_CPU_AVX2;
+  }
+#endif
+  return features;
+}
+
+// Return the UINT256_CPU_* flags for the features this CPU supports.
+// The CPU is only checked once; the answer can't change while the
+// program is running.
+unsigned uint256_cpu_features(void) {
+  static unsigned features;
+  static int detected = 0;
+  if (!detected) {
+    features = detect_cpu_features();
+    detected = 1;
+  }
+  return features;
+}
+
+// Return the kernel table for a backend, or NULL if it can't run here.
+static const UInt256Kernels *backend_kernels(UInt256Backend backend) {
+  switch (backend) {
+  case UINT256_BACKEND_GENERIC:
+    return &uint256_generic_kernels;
+#ifdef UINT256_DISPATCH_X86
+  case UINT256_BACKEND_BMI2_ADX:
+    return (uint256_cpu_features() & UINT256_CPU_BMI2_ADX) ? &bmi2_adx_kernels
+                                                            : NULL;
+#endif
+  default:
+    return NULL;
+  }
+}
+
+// Check the CPU features and select the fastest supported backend.
+void uint256_dispatch_init(void) {
+  if (!uint256_set_backend(UINT256_BACKEND_BMI2_ADX)) {
+    uint256_set_backend(UINT256_BACKEND_GENERIC);
+  }
+}
+
+#ifdef __GNUC__
+__attribute__((constructor)) static void dispatch_startup(void) {
+  uint256_dispatch_init();
+}
+#endif
+
+// Return 1 if the given backend can run on this CPU, 0 otherwise.
+int uint256_backend_supported(UInt256Backend backend) {
+  return backend_kernels(backend) != NULL;
+}
+
+// Select the given backend. Returns 1 if successful, 0 if the backend
+// is not supported on this CPU.
+int uint256_set_backend(UInt256Backend backend) {
+  const UInt256Kernels *kernels = backend_kernels(backend);
+  if (kernels == NULL) {
+    return 0;
+  }
+  uint256_kernels = kernels;
+  current_backend = backend;
+  return 1;
+}
+
+// Return the backend currently in use.
+UInt256Backend uint256_get_backend(void) {
+  return current_backend;
+}
+
+// Return a short name for the given backend.
+const char *uint256_backend_name(UInt256Backend backend) {
+  switch (backend) {
+  case UINT256_BACKEND_GENERIC:
+    return "generic";
+  case UINT256_BACKEND_BMI2_ADX:
+    return "bmi2-adx";
+  default:
+    return "unknown";
+  }
+}
@@ -0,0 +1,42 @@
+#ifndef UINT256_DISPATCH_H
+#define UINT256_DISPATCH_H
+
+// Runtime selection of the kernels behind uint256_add, uint256_sub,
+// uint256_mul and uint256_lshift (and their _to variants).
+//
+// The CPU is checked once, at program startup, and the fastest backend
+// it supports is selected automatically. The functions below are only
+// needed to inspect that choice or to force a particular backend (e.g.
+// to compare backends in tests or benchmarks). Changing the backend
+// while other threads are doing arithmetic is not safe.
+
+typedef enum {
+  // Plain C, runs everywhere
+  UINT256_BACKEND_GENERIC,
+  // x86-64 with BMI2 and ADX: MULX and the ADCX/ADOX dual carry chains
+  UINT256_BACKEND_BMI2_ADX,
+  UINT256_NUM_BACKENDS
+} UInt256Backend;
+
+// Check the CPU features and select the fastest supported backend.
+// This runs automatically before main; calling it again just repeats
+// the selection (undoing any uint256_set_backend).
+void uint256_dispatch_init( void );
+
+// Return 1 if the given backend can run on this CPU, 0 otherwise.
+int uint256_backend_supported( UInt256Backend backend );
+
+// Select the given backend.
+//
+// Returns:
+//   1 if successful, 0 if the backend is not supported on this CPU
+//   (in which case the current backend is unchanged)
+int uint256_set_backend( UInt256Backend backend );
+
+// Return the backend currently in use.
+UInt256Backend uint256_get_backend( void );
+
+// Return a short name for the given backend (e.g. "generic").
+const char *uint256_backend_name( UInt256Backend backend );
+
+#endif // UINT256_DISPATCH_H
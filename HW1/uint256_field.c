@@ -0,0 +1,186 @@
+#include "uint256_field.h"
+#include <stdint.h>
+#include "uint256_limbs.h"
+
+const UInt256Field uint256_field_secp256k1 = {
+    "secp256k1",
+    {{0xfffffc2fU, 0xfffffffeU, 0xffffffffU, 0xffffffffU, 0xffffffffU,
+      0xffffffffU, 0xffffffffU, 0xffffffffU}},
+    uint256_secp256k1_reduce,
+};
+
+const UInt256Field uint256_field_p256 = {
+    "p256",
+    {{0xffffffffU, 0xffffffffU, 0xffffffffU, 0x00000000U, 0x00000000U,
+      0x00000000U, 0x00000001U, 0xffffffffU}},
+    uint256_p256_reduce,
+};
+
+const UInt256Field uint256_field_p25519 = {
+    "p25519",
+    {{0xffffffedU, 0xffffffffU, 0xffffffffU, 0xffffffffU, 0xffffffffU,
+      0xffffffffU, 0xffffffffU, 0x7fffffffU}},
+    uint256_p25519_reduce,
+};
+
+// Reduce hi*2^256 + lo modulo p, where 2^256 == c (mod p) for a small
+// constant c = c1*2^32 + c0. This covers pseudo-Mersenne primes
+// p = 2^256 - c directly, and 2^255 - 19 with c = 38.
+static UInt256 reduce_pseudo_mersenne(UInt256 hi, UInt256 lo, uint32_t c0,
+                                      uint32_t c1, const UInt256 *p) {
+  uint32_t t[10];
+
+  // first fold: t = lo + hi*c (at most 320 bits)
+  uint64_t carry = 0;
+  for (int i = 0; i < 8; i++) {
+    uint64_t s = (uint64_t)hi.data[i] * c0 + lo.data[i] + carry;
+    t[i] = (uint32_t)s;
+    carry = s >> 32;
+  }
+  t[8] = (uint32_t)carry;
+  t[9] = 0;
+  if (c1 != 0) {
+    carry = 0;
+    for (int i = 0; i < 8; i++) {
+      uint64_t s = (uint64_t)hi.data[i] * c1 + t[i + 1] + carry;
+      t[i + 1] = (uint32_t)s;
+      carry = s >> 32;
+    }
+    t[9] = (uint32_t)carry;
+  }
+
+  // second fold: the 64 bits above 2^256 times c is at most 128 bits
+  uint32_t h[2] = {t[8], t[9]};
+  uint32_t c[2] = {c0, c1};
+  uint32_t hc[4] = {0};
+  for (int i = 0; i < 2; i++) {
+    carry = 0;
+    for (int j = 0; j < 2; j++) {
+      uint64_t s = (uint64_t)h[i] * c[j] + hc[i + j] + carry;
+      hc[i + j] = (uint32_t)s;
+      carry = s >> 32;
+    }
+    hc[i + 2] = (uint32_t)carry;
+  }
+
+  UInt256 r;
+  carry = 0;
+  for (int i = 0; i < 8; i++) {
+    uint64_t s = (uint64_t)t[i] + (i < 4 ? hc[i] : 0) + carry;
+    r.data[i] = (uint32_t)s;
+    carry = s >> 32;
+  }
+
+  // a final wrap past 2^256 leaves r below 2^128, so adding c again
+  // can't carry
+  if (carry) {
+    uint64_t s = (uint64_t)r.data[0] + c0;
+    r.data[0] = (uint32_t)s;
+    s = (uint64_t)r.data[1] + c1 + (s >> 32);
+    r.data[1] = (uint32_t)s;
+    for (int i = 2; i < 8 && (s >> 32); i++) {
+      s = (uint64_t)r.data[i] + 1;
+      r.data[i] = (uint32_t)s;
+    }
+  }
+
+  // r < 2^256, which is less than 3p for all of the supported primes
+  while (geq_limbs(r.data, p->data)) {
+    sub_limbs(r.data, r.data, p->data);
+  }
+  return r;
+}
+
+// Reduce the 512-bit value hi*2^256 + lo modulo the secp256k1 prime.
+// 2^256 == 2^32 + 977 (mod p).
+UInt256 uint256_secp256k1_reduce(UInt256 hi, UInt256 lo) {
+  return reduce_pseudo_mersenne(hi, lo, 977U, 1U,
+                                &uint256_field_secp256k1.modulus);
+}
+
+// Reduce the 512-bit value hi*2^256 + lo modulo 2^255 - 19.
+// 2^256 == 2*19 (mod p).
+UInt256 uint256_p25519_reduce(UInt256 hi, UInt256 lo) {
+  return reduce_pseudo_mersenne(hi, lo, 38U, 0U,
+                                &uint256_field_p25519.modulus);
+}
+
+// Reduce the 512-bit value hi*2^256 + lo modulo the P-256 prime.
+// This is the word-oriented Solinas reduction from FIPS 186: with the
+// 32-bit words of the input written c0..c15, the result is congruent
+// to s1 + 2*s2 + 2*s3 + s4 + s5 - d1 - d2 - d3 - d4, where each term is
+// a 256-bit value assembled from the input words. The terms are summed
+// column by column in a signed accumulator.
+UInt256 uint256_p256_reduce(UInt256 hi, UInt256 lo) {
+  const uint32_t *p256 = uint256_field_p256.modulus.data;
+  int64_t c[16];
+  for (int i = 0; i < 8; i++) {
+    c[i] = lo.data[i];
+    c[i + 8] = hi.data[i];
+  }
+
+  int64_t col[8];
+  col[0] = c[0] + c[8] + c[9] - c[11] - c[12] - c[13] - c[14];
+  col[1] = c[1] + c[9] + c[10] - c[12] - c[13] - c[14] - c[15];
+  col[2] = c[2] + c[10] + c[11] - c[13] - c[14] - c[15];
+  col[3] = c[3] + 2 * c[11] + 2 * c[12] + c[13] - c[15] - c[8] - c[9];
+  col[4] = c[4] + 2 * c[12] + 2 * c[13] + c[14] - c[9] - c[10];
+  col[5] = c[5] + 2 * c[13] + 2 * c[14] + c[15] - c[10] - c[11];
+  col[6] = c[6] + 3 * c[14] + 2 * c[15] + c[13] - c[8] - c[9];
+  col[7] = c[7] + 3 * c[15] + c[8] - c[10] - c[11] - c[12] - c[13];
+
+  // propagate the signed carries; the value is then k*2^256 + r
+  UInt256 r;
+  int64_t carry = 0;
+  for (int i = 0; i < 8; i++) {
+    int64_t s = col[i] + carry;
+    r.data[i] = (uint32_t)s;
+    carry = (s - (int64_t)r.data[i]) / 4294967296LL;
+  }
+  int k = (int)carry;
+
+  // bring k to zero by adding or subtracting p (k is a small integer)
+  while (k < 0) {
+    k += add_limbs(r.data, r.data, p256);
+  }
+  while (k > 0) {
+    k -= sub_limbs(r.data, r.data, p256);
+  }
+  while (geq_limbs(r.data, p256)) {
+    sub_limbs(r.data, r.data, p256);
+  }
+  return r;
+}
+
+// Compute (a + b) mod p. Both operands must be less than p.
+UInt256 uint256_field_add(const UInt256Field *field, UInt256 a, UInt256 b) {
+  UInt256 r;
+  uint32_t carry = add_limbs(r.data, a.data, b.data);
+  if (carry || geq_limbs(r.data, field->modulus.data)) {
+    sub_limbs(r.data, r.data, field->modulus.data);
+  }
+  return r;
+}
+
+// Compute (a - b) mod p. Both operands must be less than p.
+UInt256 uint256_field_sub(const UInt256Field *field, UInt256 a, UInt256 b) {
+  UInt256 r;
+  if (sub_limbs(r.data, a.data, b.data)) {
+    add_limbs(r.data, r.data, field->modulus.data);
+  }
+  return r;
+}
+
+// Compute (a * b) mod p.
+UInt256 uint256_field_mul(const UInt256Field *field, UInt256 a, UInt256 b) {
+  UInt256 hi, lo;
+  uint256_mul_wide(a, b, &hi, &lo);
+  return field->reduce(hi, lo);
+}
+
+// Compute (a * a) mod p.
+UInt256 uint256_field_sqr(const UInt256Field *field, UInt256 a) {
+  UInt256 hi, lo;
+  uint256_sqr_wide(a, &hi, &lo);
+  return field->reduce(hi, lo);
+}
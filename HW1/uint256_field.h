@@ -0,0 +1,49 @@
+#ifndef UINT256_FIELD_H
+#define UINT256_FIELD_H
+
+#include "uint256.h"
+
+// Arithmetic modulo fixed, special-form primes used in elliptic-curve
+// cryptography. Each named field has a hard-coded reduction routine
+// that exploits the shape of its prime, which is considerably cheaper
+// than generic Montgomery reduction (see uint256_mont.h).
+//
+// Field elements are ordinary UInt256 values in the range [0, p).
+typedef struct {
+  const char *name;
+  UInt256 modulus;
+  // reduce the 512-bit value hi*2^256 + lo modulo the field prime
+  UInt256 (*reduce)( UInt256 hi, UInt256 lo );
+} UInt256Field;
+
+// p = 2^256 - 2^32 - 977 (secp256k1)
+extern const UInt256Field uint256_field_secp256k1;
+
+// p = 2^256 - 2^224 + 2^192 + 2^96 - 1 (NIST P-256)
+extern const UInt256Field uint256_field_p256;
+
+// p = 2^255 - 19 (Curve25519)
+extern const UInt256Field uint256_field_p25519;
+
+// Reduce the 512-bit value hi*2^256 + lo modulo the secp256k1 prime.
+UInt256 uint256_secp256k1_reduce( UInt256 hi, UInt256 lo );
+
+// Reduce the 512-bit value hi*2^256 + lo modulo the P-256 prime.
+UInt256 uint256_p256_reduce( UInt256 hi, UInt256 lo );
+
+// Reduce the 512-bit value hi*2^256 + lo modulo 2^255 - 19.
+UInt256 uint256_p25519_reduce( UInt256 hi, UInt256 lo );
+
+// Compute (a + b) mod p. Both operands must be less than p.
+UInt256 uint256_field_add( const UInt256Field *field, UInt256 a, UInt256 b );
+
+// Compute (a - b) mod p. Both operands must be less than p.
+UInt256 uint256_field_sub( const UInt256Field *field, UInt256 a, UInt256 b );
+
+// Compute (a * b) mod p. The operands may be any 256-bit values.
+UInt256 uint256_field_mul( const UInt256Field *field, UInt256 a, UInt256 b );
+
+// Compute (a * a) mod p. The operand may be any 256-bit value.
+UInt256 uint256_field_sqr( const UInt256Field *field, UInt256 a );
+
+#endif // UINT256_FIELD_H
@@ -0,0 +1,270 @@
+#include "uint256_gcd.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+// The binary GCD works on four 64-bit words (least significant first),
+// so the shifts and subtractions in its inner loop take half as many
+// steps as they would on the 32-bit limbs.
+static void to_words(uint64_t w[4], const UInt256 *val) {
+  for (int i = 0; i < 4; i++) {
+    w[i] = (uint64_t)val->data[2 * i] | ((uint64_t)val->data[2 * i + 1] << 32);
+  }
+}
+
+static UInt256 from_words(const uint64_t w[4]) {
+  UInt256 val;
+  for (int i = 0; i < 4; i++) {
+    val.data[2 * i] = (uint32_t)w[i];
+    val.data[2 * i + 1] = (uint32_t)(w[i] >> 32);
+  }
+  return val;
+}
+
+static int words_zero(const uint64_t w[4]) {
+  return (w[0] | w[1] | w[2] | w[3]) == 0;
+}
+
+// Number of trailing zero bits in a nonzero value.
+static unsigned words_ctz(const uint64_t w[4]) {
+  int i = 0;
+  while (w[i] == 0) {
+    i++;
+  }
+  return 64 * i + __builtin_ctzll(w[i]);
+}
+
+// w >>= shift, for shift < 256.
+static void words_rshift(uint64_t w[4], unsigned shift) {
+  unsigned word_shift = shift / 64;
+  unsigned bits_shift = shift % 64;
+  for (unsigned i = 0; i < 4; i++) {
+    unsigned src = i + word_shift;
+    uint64_t lo = src < 4 ? w[src] : 0;
+    uint64_t hi = src + 1 < 4 ? w[src + 1] : 0;
+    // two steps keep bits_shift == 0 well defined
+    w[i] = (lo >> bits_shift) | ((hi << 1) << (63 - bits_shift));
+  }
+}
+
+// r = a - b, returning the borrow out of the top word.
+static uint64_t words_sub(uint64_t r[4], const uint64_t a[4],
+                          const uint64_t b[4]) {
+  uint64_t borrow = 0;
+  for (int i = 0; i < 4; i++) {
+    uint64_t d = a[i] - b[i];
+    uint64_t b1 = a[i] < b[i];
+    uint64_t b2 = d < borrow;
+    r[i] = d - borrow;
+    borrow = b1 | b2;
+  }
+  return borrow;
+}
+
+// Compute gcd(a, b) with the binary (Stein) algorithm.
+// Both values are kept odd after the common power of 2 is removed;
+// the difference of two odd values is even, so each step replaces the
+// larger one by |a - b| with its trailing zeros shifted out.
+UInt256 uint256_gcd(UInt256 a, UInt256 b) {
+  uint64_t u[4], v[4], d[4];
+  to_words(u, &a);
+  to_words(v, &b);
+  if (words_zero(u)) {
+    return b;
+  }
+  if (words_zero(v)) {
+    return a;
+  }
+
+  unsigned tz_u = words_ctz(u);
+  unsigned tz_v = words_ctz(v);
+  unsigned common = tz_u < tz_v ? tz_u : tz_v;
+  words_rshift(u, tz_u);
+  words_rshift(v, tz_v);
+
+  for (;;) {
+    // d = v - u; if that borrowed, u was the larger one, so the
+    // smaller value (v) becomes the new u and d is negated
+    if (words_sub(d, v, u)) {
+      for (int i = 0; i < 4; i++) {
+        u[i] = v[i];
+      }
+      uint64_t zero[4] = {0};
+      words_sub(d, zero, d);
+    }
+    if (words_zero(d)) {
+      break;
+    }
+    words_rshift(d, words_ctz(d));
+    for (int i = 0; i < 4; i++) {
+      v[i] = d[i];
+    }
+  }
+
+  UInt256 g = from_words(u);
+  return common == 0 ? g : uint256_lshift(g, common);
+}
+
+// Number of leading bits used for the single-precision Euclid steps.
+// With 62-bit digits every quantity in lehmer_cofactors (the digits,
+// the cofactors and their sums) fits in an int64_t.
+#define LEHMER_DIGIT_BITS 62
+
+// Lehmer's inner loop (Knuth, TAOCP vol. 2, Algorithm 4.5.2L).
+// For u >= v > 0, run Euclid's algorithm on the leading digits of u
+// and v for as long as the quotients are guaranteed to match those of
+// the full values, accumulating the steps in the cofactor matrix
+// [[a, b], [c, d]], so that the values after those steps are
+//   u' = a*u + b*v,  v' = c*u + d*v.
+// Returns the number of steps taken (0 if not even one step could be
+// made safely, in which case the caller does a full division step).
+// After an even number of steps a and d are >= 0 and b and c are <= 0;
+// after an odd number the signs are reversed.
+static int lehmer_cofactors(UInt256 u, UInt256 v, int64_t *a, int64_t *b,
+                            int64_t *c, int64_t *d) {
+  unsigned bits = uint256_bit_length(u);
+  unsigned shift = bits > LEHMER_DIGIT_BITS ? bits - LEHMER_DIGIT_BITS : 0;
+  UInt256 ut = uint256_rshift(u, shift);
+  UInt256 vt = uint256_rshift(v, shift);
+  int64_t uh = (int64_t)((uint64_t)ut.data[0] | ((uint64_t)ut.data[1] << 32));
+  int64_t vh = (int64_t)((uint64_t)vt.data[0] | ((uint64_t)vt.data[1] << 32));
+
+  int64_t ca = 1, cb = 0, cc = 0, cd = 1;
+  int steps = 0;
+  while (vh + cc != 0 && vh + cd != 0) {
+    int64_t q = (uh + ca) / (vh + cc);
+    if (q != (uh + cb) / (vh + cd)) {
+      break;
+    }
+    int64_t t = ca - q * cc;
+    ca = cc;
+    cc = t;
+    t = cb - q * cd;
+    cb = cd;
+    cd = t;
+    t = uh - q * vh;
+    uh = vh;
+    vh = t;
+    steps++;
+  }
+  *a = ca;
+  *b = cb;
+  *c = cc;
+  *d = cd;
+  return steps;
+}
+
+// Compute x * k, truncated to 256 bits.
+static UInt256 mul_u64(UInt256 x, uint64_t k) {
+  uint32_t k0 = (uint32_t)k, k1 = (uint32_t)(k >> 32);
+  UInt256 r;
+  uint64_t carry = 0;
+  for (int i = 0; i < 8; i++) {
+    uint64_t t = (uint64_t)x.data[i] * k0 + carry;
+    r.data[i] = (uint32_t)t;
+    carry = t >> 32;
+  }
+  if (k1 != 0) {
+    carry = 0;
+    for (int i = 1; i < 8; i++) {
+      uint64_t t = (uint64_t)x.data[i - 1] * k1 + r.data[i] + carry;
+      r.data[i] = (uint32_t)t;
+      carry = t >> 32;
+    }
+  }
+  return r;
+}
+
+// Compute a*x + b*y where a and b have opposite signs (or one is 0)
+// and the result is known to lie in [0, 2^256). Working modulo 2^256
+// the result comes out exact.
+static UInt256 combine(int64_t a, UInt256 x, int64_t b, UInt256 y) {
+  UInt256 ax = mul_u64(x, a < 0 ? -(uint64_t)a : (uint64_t)a);
+  UInt256 by = mul_u64(y, b < 0 ? -(uint64_t)b : (uint64_t)b);
+  return (a < 0 || b > 0) ? uint256_sub(by, ax) : uint256_sub(ax, by);
+}
+
+// Compute |a|*x + |b|*y (the result must fit in 256 bits).
+static UInt256 combine_abs(int64_t a, UInt256 x, int64_t b, UInt256 y) {
+  UInt256 ax = mul_u64(x, a < 0 ? -(uint64_t)a : (uint64_t)a);
+  UInt256 by = mul_u64(y, b < 0 ? -(uint64_t)b : (uint64_t)b);
+  return uint256_add(ax, by);
+}
+
+// Compute gcd(a, b) with Lehmer's algorithm.
+UInt256 uint256_gcd_lehmer(UInt256 a, UInt256 b) {
+  UInt256 u = a, v = b;
+  if (uint256_cmp(u, v) < 0) {
+    u = b;
+    v = a;
+  }
+  while (!uint256_is_zero(v)) {
+    int64_t ca, cb, cc, cd;
+    if (lehmer_cofactors(u, v, &ca, &cb, &cc, &cd) == 0) {
+      UInt256 r;
+      uint256_divmod(u, v, NULL, &r);
+      u = v;
+      v = r;
+    } else {
+      UInt256 nu = combine(ca, u, cb, v);
+      v = combine(cc, u, cd, v);
+      u = nu;
+    }
+  }
+  return u;
+}
+
+// Compute the inverse of a modulo m.
+// Euclid's algorithm is run on (m, a mod m) while tracking, for each
+// remainder r, a coefficient t with r == t*a (mod m). The coefficients
+// alternate in sign and never exceed m in magnitude, so only their
+// magnitudes are stored; the sign of the final one follows from the
+// number of steps taken.
+int uint256_modinv(UInt256 a, UInt256 m, UInt256 *inv) {
+  UInt256 zero = uint256_create_from_u32(0);
+  UInt256 one = uint256_create_from_u32(1);
+  *inv = zero;
+  if (uint256_is_zero(m)) {
+    return 0;
+  }
+
+  UInt256 u = m, v;
+  uint256_divmod(a, m, NULL, &v);
+  UInt256 tu = zero, tv = one; // magnitudes of the coefficients
+  unsigned steps = 0;
+
+  while (!uint256_is_zero(v)) {
+    int64_t ca, cb, cc, cd;
+    int n = lehmer_cofactors(u, v, &ca, &cb, &cc, &cd);
+    if (n == 0) {
+      UInt256 q, r;
+      uint256_divmod(u, v, &q, &r);
+      u = v;
+      v = r;
+      UInt256 t = uint256_add(tu, uint256_mul(q, tv));
+      tu = tv;
+      tv = t;
+      steps++;
+    } else {
+      UInt256 nu = combine(ca, u, cb, v);
+      v = combine(cc, u, cd, v);
+      u = nu;
+      UInt256 ntu = combine_abs(ca, tu, cb, tv);
+      tv = combine_abs(cc, tu, cd, tv);
+      tu = ntu;
+      steps += (unsigned)n;
+    }
+  }
+
+  // u is now gcd(a, m)
+  if (uint256_cmp(u, one) != 0) {
+    return 0;
+  }
+  // the coefficient of remainder number `steps` is positive when steps
+  // is odd (0, 1, -q1, 1 + q1*q2, ...); for m == 1 no steps are taken,
+  // and m - 0 wraps to the only residue, 0
+  *inv = (steps & 1) ? tu : uint256_sub(m, tu);
+  if (uint256_cmp(*inv, m) == 0) {
+    *inv = zero;
+  }
+  return 1;
+}
@@ -0,0 +1,29 @@
+#ifndef UINT256_GCD_H
+#define UINT256_GCD_H
+
+#include "uint256.h"
+
+// Greatest common divisor and modular inverse of UInt256 values.
+
+// Compute gcd(a, b) with the binary (Stein) algorithm: common factors
+// of 2 are removed with a single trailing-zero count and shift, and
+// every other step is a subtraction followed by such a shift.
+// gcd(0, b) == b, and gcd(0, 0) == 0.
+UInt256 uint256_gcd( UInt256 a, UInt256 b );
+
+// Compute gcd(a, b) with Lehmer's algorithm: most steps of Euclid's
+// algorithm are carried out on the leading 62 bits of the operands,
+// and their combined effect is applied to the full values in one go.
+// Gives the same result as uint256_gcd.
+UInt256 uint256_gcd_lehmer( UInt256 a, UInt256 b );
+
+// Compute the inverse of a modulo m (the x in [0, m) with a*x == 1
+// mod m), using the extended Euclidean algorithm with Lehmer's
+// speedup. The modulus may be even. a does not need to be reduced.
+//
+// Returns:
+//   1 if successful, 0 if there is no inverse (m is 0, or a and m
+//   have a common factor), in which case *inv is set to 0
+int uint256_modinv( UInt256 a, UInt256 m, UInt256 *inv );
+
+#endif // UINT256_GCD_H
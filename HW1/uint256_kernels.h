@@ -0,0 +1,37 @@
+// Internal kernel table for the core UInt256 arithmetic. The public
+// add/sub/mul/lshift functions call through uint256_kernels, which
+// uint256_dispatch.c points at the best backend for the running CPU.
+// Also the shared CPU feature check used by the batch module.
+// Not part of the public API.
+
+#ifndef UINT256_KERNELS_H
+#define UINT256_KERNELS_H
+
+#include <stdint.h>
+
+// Every kernel works on raw arrays of 8 little-endian 32-bit limbs and
+// allows r to alias any of the operands. lshift accepts any shift (256
+// or more gives 0).
+typedef struct {
+  void (*add)(uint32_t r[8], const uint32_t a[8], const uint32_t b[8]);
+  void (*sub)(uint32_t r[8], const uint32_t a[8], const uint32_t b[8]);
+  void (*mul)(uint32_t r[8], const uint32_t a[8], const uint32_t b[8]);
+  void (*lshift)(uint32_t r[8], const uint32_t a[8], unsigned shift);
+} UInt256Kernels;
+
+// Plain C kernels (defined in uint256.c); these run on any CPU.
+extern const UInt256Kernels uint256_generic_kernels;
+
+// The kernels currently in use (defined in uint256_dispatch.c).
+extern const UInt256Kernels *uint256_kernels;
+
+// CPU features that some module has a faster path for. Detection is
+// done once, in uint256_dispatch.c; every module asks it rather than
+// checking the CPU itself.
+#define UINT256_CPU_BMI2_ADX 0x1U
+#define UINT256_CPU_AVX2 0x2U
+
+// Return the UINT256_CPU_* flags for the features this CPU supports.
+unsigned uint256_cpu_features(void);
+
+#endif // UINT256_KERNELS_H
@@ -0,0 +1,160 @@
+// Internal helpers shared by the UInt256 modules: add, subtract,
+// compare and shift raw arrays of 8 little-endian 32-bit limbs, and
+// load and store them as four 64-bit words.
+// Not part of the public API.
+
+#ifndef UINT256_LIMBS_H
+#define UINT256_LIMBS_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Add two 8-limb values, storing the low 256 bits in r.
+// Returns the carry out of the most significant limb.
+static inline uint32_t add_limbs(uint32_t r[8], const uint32_t a[8],
+                                 const uint32_t b[8]) {
+  uint64_t carry = 0;
+  for (int i = 0; i < 8; i++) {
+    uint64_t t = (uint64_t)a[i] + b[i] + carry;
+    r[i] = (uint32_t)t;
+    carry = t >> 32;
+  }
+  return (uint32_t)carry;
+}
+
+// Subtract b from a, storing the low 256 bits in r.
+// Returns 1 if the subtraction borrowed (a < b), 0 otherwise.
+static inline uint32_t sub_limbs(uint32_t r[8], const uint32_t a[8],
+                                 const uint32_t b[8]) {
+  uint64_t borrow = 0;
+  for (int i = 0; i < 8; i++) {
+    uint64_t t = (uint64_t)a[i] - b[i] - borrow;
+    r[i] = (uint32_t)t;
+    borrow = (t >> 32) & 1;
+  }
+  return (uint32_t)borrow;
+}
+
+// Return 1 if a >= b, 0 otherwise.
+static inline int geq_limbs(const uint32_t a[8], const uint32_t b[8]) {
+  for (int i = 7; i >= 0; i--) {
+    if (a[i] != b[i]) {
+      return a[i] > b[i];
+    }
+  }
+  return 1;
+}
+
+// Word i (0 = least significant) of an array of 8 limbs, taken as a
+// 64-bit value.
+static inline uint64_t get_word(const uint32_t a[8], int i) {
+  return (uint64_t)a[2 * i] | ((uint64_t)a[2 * i + 1] << 32);
+}
+
+// Store four 64-bit words (w0 least significant) as the limbs of r.
+// A result is usually copied out with 16-byte loads right after it is
+// built, and a load is only forwarded from a single store that covers
+// all of it; a load that spans separate word or limb stores has to
+// wait for them to reach the cache, costing about ten cycles. So on
+// little-endian GCC-compatible compilers each half is written as one
+// 16-byte vector store. This is the one place that makes that choice;
+// code that builds a value from words should store it through here.
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+typedef uint64_t uint256_pair64 __attribute__((vector_size(16)));
+
+static inline void store_words(uint32_t r[8], uint64_t w0, uint64_t w1,
+                               uint64_t w2, uint64_t w3) {
+  uint256_pair64 lo = {w0, w1};
+  uint256_pair64 hi = {w2, w3};
+  memcpy(r, &lo, 16);
+  memcpy(r + 4, &hi, 16);
+}
+#else
+static inline void store_words(uint32_t r[8], uint64_t w0, uint64_t w1,
+                               uint64_t w2, uint64_t w3) {
+  const uint64_t w[4] = {w0, w1, w2, w3};
+  for (int i = 0; i < 4; i++) {
+    r[2 * i] = (uint32_t)w[i];
+    r[2 * i + 1] = (uint32_t)(w[i] >> 32);
+  }
+}
+#endif
+
+// Funnel shifts of a pair of 64-bit words (the x86 SHLD and SHRD
+// instructions): the high word shifted left with the top bits of the
+// low word shifted in, and the low word shifted right with the bottom
+// bits of the high word shifted in. bits must be less than 64; the
+// shifted-in word is shifted in two steps so that bits == 0 is well
+// defined.
+static inline uint64_t shld64(uint64_t hi, uint64_t lo, unsigned bits) {
+  return (hi << bits) | (lo >> 1 >> (63 - bits));
+}
+
+static inline uint64_t shrd64(uint64_t lo, uint64_t hi, unsigned bits) {
+  return (lo >> bits) | (hi << 1 << (63 - bits));
+}
+
+// Return a where mask is all ones and b where it is all zeros.
+static inline uint64_t pick(uint64_t mask, uint64_t a, uint64_t b) {
+  return (a & mask) | (b & ~mask);
+}
+
+// Return an all-ones mask if bit n of shift is set, zero otherwise.
+static inline uint64_t bit_mask(unsigned shift, unsigned n) {
+  return -(uint64_t)((shift >> n) & 1);
+}
+
+// Shift a left by any number of bits (256 or more gives 0).
+// The shift is done as a barrel shifter on four words held in
+// registers: bits 7 and 6 of the shift move whole words by 128 and 64
+// bits through masked selects, a mask clears everything for shifts of
+// 256 or more, and the rest is one funnel shift per word. There are no
+// branches or indexed loads. All of a is read before r is written, so
+// r may alias a.
+static inline void lshift_words(uint32_t r[8], const uint32_t a[8],
+                                unsigned shift) {
+  uint64_t keep = -(uint64_t)(shift < 256);
+  uint64_t x0 = get_word(a, 0) & keep, x1 = get_word(a, 1) & keep;
+  uint64_t x2 = get_word(a, 2) & keep, x3 = get_word(a, 3) & keep;
+  uint64_t m = bit_mask(shift, 7);
+  x3 = pick(m, x1, x3);
+  x2 = pick(m, x0, x2);
+  x1 &= ~m;
+  x0 &= ~m;
+  m = bit_mask(shift, 6);
+  x3 = pick(m, x2, x3);
+  x2 = pick(m, x1, x2);
+  x1 = pick(m, x0, x1);
+  x0 &= ~m;
+  unsigned bits = shift % 64;
+  store_words(r, x0 << bits, shld64(x1, x0, bits), shld64(x2, x1, bits),
+              shld64(x3, x2, bits));
+}
+
+// Shift a right by any number of bits, shifting in copies of fill
+// (0 for a logical shift, all ones or zeros by the sign for an
+// arithmetic one); shifts of 256 or more give all fill. The mirror
+// image of lshift_words, and r may likewise alias a.
+static inline void rshift_words(uint32_t r[8], const uint32_t a[8],
+                                unsigned shift, uint64_t fill) {
+  uint64_t m = -(uint64_t)(shift >= 256);
+  uint64_t x0 = pick(m, fill, get_word(a, 0));
+  uint64_t x1 = pick(m, fill, get_word(a, 1));
+  uint64_t x2 = pick(m, fill, get_word(a, 2));
+  uint64_t x3 = pick(m, fill, get_word(a, 3));
+  m = bit_mask(shift, 7);
+  x0 = pick(m, x2, x0);
+  x1 = pick(m, x3, x1);
+  x2 = pick(m, fill, x2);
+  x3 = pick(m, fill, x3);
+  m = bit_mask(shift, 6);
+  x0 = pick(m, x1, x0);
+  x1 = pick(m, x2, x1);
+  x2 = pick(m, x3, x2);
+  x3 = pick(m, fill, x3);
+  unsigned bits = shift % 64;
+  store_words(r, shrd64(x0, x1, bits), shrd64(x1, x2, bits),
+              shrd64(x2, x3, bits), shrd64(x3, fill, bits));
+}
+
+#endif // UINT256_LIMBS_H
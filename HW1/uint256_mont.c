@@ -0,0 +1,254 @@
+#include "uint256_mont.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "uint256_limbs.h"
+
+// Compute 2*a mod m, for a < m.
+static UInt256 double_mod(const UInt256MontCtx *ctx, UInt256 a) {
+  UInt256 r;
+  uint32_t carry = add_limbs(r.data, a.data, a.data);
+  if (carry || geq_limbs(r.data, ctx->modulus.data)) {
+    sub_limbs(r.data, r.data, ctx->modulus.data);
+  }
+  return r;
+}
+
+// Initialize a Montgomery context for the given modulus.
+int uint256_mont_init(UInt256MontCtx *ctx, UInt256 modulus) {
+  if ((modulus.data[0] & 1) == 0) {
+    return 0;
+  }
+  ctx->modulus = modulus;
+
+  // Newton iteration for m^-1 mod 2^32: m*m == 1 (mod 8) for odd m,
+  // and every step doubles the number of correct low bits (3, 6, 12,
+  // 24, 48).
+  uint32_t m0 = modulus.data[0];
+  uint32_t inv = m0;
+  for (int i = 0; i < 4; i++) {
+    inv *= 2 - m0 * inv;
+  }
+  ctx->n0inv = -inv;
+
+  // R mod m and R^2 mod m by repeated doubling starting from 1 (which
+  // is already reduced unless m == 1)
+  UInt256 x = uint256_create_from_u32(1);
+  if (!geq_limbs(x.data, modulus.data)) {
+    for (int i = 0; i < 256; i++) {
+      x = double_mod(ctx, x);
+    }
+    ctx->one = x;
+    for (int i = 0; i < 256; i++) {
+      x = double_mod(ctx, x);
+    }
+    ctx->r2 = x;
+  } else {
+    ctx->one = uint256_create_from_u32(0);
+    ctx->r2 = ctx->one;
+  }
+  return 1;
+}
+
+// Montgomery product of two values in Montgomery form: a*b*R^-1 mod m.
+// Coarsely integrated operand scanning (CIOS): each row multiplies one
+// limb of b into the accumulator and immediately cancels its lowest
+// limb with a multiple of m, so the accumulator never grows beyond
+// ten limbs.
+UInt256 uint256_mont_mul(const UInt256MontCtx *ctx, UInt256 a, UInt256 b) {
+  const uint32_t *n = ctx->modulus.data;
+  uint32_t t[10] = {0};
+
+  for (int i = 0; i < 8; i++) {
+    // t += a * b[i]
+    uint64_t carry = 0;
+    uint64_t bi = b.data[i];
+    for (int j = 0; j < 8; j++) {
+      uint64_t s = (uint64_t)a.data[j] * bi + t[j] + carry;
+      t[j] = (uint32_t)s;
+      carry = s >> 32;
+    }
+    uint64_t s = (uint64_t)t[8] + carry;
+    t[8] = (uint32_t)s;
+    t[9] = (uint32_t)(s >> 32);
+
+    // t = (t + q*m) / 2^32, with q chosen so the low limb cancels
+    uint64_t q = (uint32_t)(t[0] * ctx->n0inv);
+    s = q * n[0] + t[0];
+    carry = s >> 32;
+    for (int j = 1; j < 8; j++) {
+      s = q * n[j] + t[j] + carry;
+      t[j - 1] = (uint32_t)s;
+      carry = s >> 32;
+    }
+    s = (uint64_t)t[8] + carry;
+    t[7] = (uint32_t)s;
+    t[8] = t[9] + (uint32_t)(s >> 32);
+  }
+
+  // the result is less than 2m, so at most one subtraction is needed
+  UInt256 result;
+  for (int i = 0; i < 8; i++) {
+    result.data[i] = t[i];
+  }
+  if (t[8] || geq_limbs(result.data, n)) {
+    sub_limbs(result.data, result.data, n);
+  }
+  return result;
+}
+
+// Convert a value into Montgomery form (a*R mod m).
+UInt256 uint256_mont_to(const UInt256MontCtx *ctx, UInt256 a) {
+  // a*R^2*R^-1 = a*R; since r2 < m the product of any 256-bit a with
+  // it stays below R*m, so the result is still fully reduced
+  return uint256_mont_mul(ctx, a, ctx->r2);
+}
+
+// Convert a value out of Montgomery form (a*R^-1 mod m).
+UInt256 uint256_mont_from(const UInt256MontCtx *ctx, UInt256 a) {
+  return uint256_mont_mul(ctx, a, uint256_create_from_u32(1));
+}
+
+// Compute (a + b) mod m. Both operands must be less than m.
+UInt256 uint256_mont_add(const UInt256MontCtx *ctx, UInt256 a, UInt256 b) {
+  UInt256 r;
+  uint32_t carry = add_limbs(r.data, a.data, b.data);
+  if (carry || geq_limbs(r.data, ctx->modulus.data)) {
+    sub_limbs(r.data, r.data, ctx->modulus.data);
+  }
+  return r;
+}
+
+// Compute (a - b) mod m. Both operands must be less than m.
+UInt256 uint256_mont_sub(const UInt256MontCtx *ctx, UInt256 a, UInt256 b) {
+  UInt256 r;
+  if (sub_limbs(r.data, a.data, b.data)) {
+    add_limbs(r.data, r.data, ctx->modulus.data);
+  }
+  return r;
+}
+
+// Compute base^exp mod m (base and result in Montgomery form).
+UInt256 uint256_mont_pow(const UInt256MontCtx *ctx, UInt256 base,
+                         UInt256 exp) {
+  return uint256_mont_pow_window(ctx, base, exp, UINT256_MONT_POW_WINDOW);
+}
+
+// Return the `width` bits of exp starting at bit `pos` (width <= 32;
+// bits above bit 255 read as 0).
+static uint32_t exp_bits(UInt256 exp, unsigned pos, unsigned width) {
+  unsigned limb = pos / 32;
+  uint64_t bits = exp.data[limb];
+  if (limb < 7) {
+    bits |= (uint64_t)exp.data[limb + 1] << 32;
+  }
+  return (uint32_t)(bits >> (pos % 32)) & ((1U << width) - 1);
+}
+
+// Compute base^exp mod m with a sliding window (base and result in
+// Montgomery form).
+// The exponent is scanned from the top bit down. A 0 bit costs a
+// squaring; at a 1 bit, the longest run of at most `window` bits that
+// also ends with a 1 is taken as one odd digit, which costs a squaring
+// per bit and a single multiplication by the precomputed power.
+UInt256 uint256_mont_pow_window(const UInt256MontCtx *ctx, UInt256 base,
+                                UInt256 exp, unsigned window) {
+  assert(window >= 1 && window <= UINT256_MONT_MAX_WINDOW);
+  int top = (int)uint256_bit_length(exp) - 1;
+  if (top < 0) {
+    return ctx->one;
+  }
+
+  // odd[k] = base^(2k+1)
+  UInt256 odd[1 << (UINT256_MONT_MAX_WINDOW - 1)];
+  odd[0] = base;
+  if (window > 1) {
+    UInt256 base_sqr = uint256_mont_mul(ctx, base, base);
+    for (int k = 1; k < 1 << (window - 1); k++) {
+      odd[k] = uint256_mont_mul(ctx, odd[k - 1], base_sqr);
+    }
+  }
+
+  UInt256 result = ctx->one;
+  int started = 0; // squaring 1 is skipped until the first digit
+  int i = top;
+  while (i >= 0) {
+    if (!uint256_is_bit_set(exp, (unsigned)i)) {
+      result = uint256_mont_mul(ctx, result, result);
+      i--;
+      continue;
+    }
+    int low = i - (int)window + 1 > 0 ? i - (int)window + 1 : 0;
+    while (!uint256_is_bit_set(exp, (unsigned)low)) {
+      low++;
+    }
+    unsigned width = (unsigned)(i - low + 1);
+    uint32_t digit = exp_bits(exp, (unsigned)low, width);
+    if (started) {
+      for (unsigned k = 0; k < width; k++) {
+        result = uint256_mont_mul(ctx, result, result);
+      }
+      result = uint256_mont_mul(ctx, result, odd[digit >> 1]);
+    } else {
+      result = odd[digit >> 1];
+      started = 1;
+    }
+    i = low - 1;
+  }
+  return result;
+}
+
+// Build the table of powers of a fixed base.
+// Row i holds base^(d * 2^(window*i)) for d = 1 .. 2^window - 1; the
+// first entry of each row is the last entry of the previous row times
+// the base for that row, squared.
+int uint256_mont_fixed_base_init(UInt256MontFixedBase *fb,
+                                 const UInt256MontCtx *ctx, UInt256 base,
+                                 unsigned window) {
+  assert(window >= 1 && window <= UINT256_MONT_MAX_WINDOW);
+  unsigned row = (1U << window) - 1;
+  fb->ctx = *ctx;
+  fb->window = window;
+  fb->digits = (256 + window - 1) / window;
+  fb->table = malloc(sizeof(UInt256) * fb->digits * row);
+  if (fb->table == NULL) {
+    return 0;
+  }
+
+  UInt256 g = base; // base^(2^(window*i)) for the current row
+  for (unsigned i = 0; i < fb->digits; i++) {
+    UInt256 *entries = fb->table + i * row;
+    entries[0] = g;
+    for (unsigned d = 1; d < row; d++) {
+      entries[d] = uint256_mont_mul(ctx, entries[d - 1], g);
+    }
+    // base^(2^(window*(i+1))) = (base^((2^window - 1) * 2^(window*i))) * g
+    g = uint256_mont_mul(ctx, entries[row - 1], g);
+  }
+  return 1;
+}
+
+// Compute base^exp mod m with the precomputed table: one
+// multiplication per nonzero digit of the exponent.
+UInt256 uint256_mont_fixed_base_pow(const UInt256MontFixedBase *fb,
+                                    UInt256 exp) {
+  unsigned row = (1U << fb->window) - 1;
+  UInt256 result = fb->ctx.one;
+  int started = 0;
+  for (unsigned i = 0; i < fb->digits; i++) {
+    uint32_t digit = exp_bits(exp, i * fb->window, fb->window);
+    if (digit == 0) {
+      continue;
+    }
+    const UInt256 *entry = &fb->table[i * row + digit - 1];
+    result = started ? uint256_mont_mul(&fb->ctx, result, *entry) : *entry;
+    started = 1;
+  }
+  return result;
+}
+
+// Free the table of a fixed-base context.
+void uint256_mont_fixed_base_free(UInt256MontFixedBase *fb) {
+  free(fb->table);
+  fb->table = NULL;
+}
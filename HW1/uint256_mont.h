@@ -0,0 +1,103 @@
+#ifndef UINT256_MONT_H
+#define UINT256_MONT_H
+
+#include <stdint.h>
+#include "uint256.h"
+
+// Precomputed constants for Montgomery arithmetic modulo a fixed odd
+// modulus m, with Montgomery radix R = 2^256.
+//
+// Values "in Montgomery form" are stored as a*R mod m. Multiplying two
+// such values with uint256_mont_mul yields the Montgomery form of their
+// product without ever dividing by m, which is what makes repeated
+// modular multiplication against the same modulus cheap.
+typedef struct {
+  UInt256 modulus; // m (must be odd)
+  UInt256 one;     // R mod m, i.e. 1 in Montgomery form
+  UInt256 r2;      // R^2 mod m, used to convert into Montgomery form
+  uint32_t n0inv;  // -m^-1 mod 2^32
+} UInt256MontCtx;
+
+// Initialize a Montgomery context for the given modulus.
+//
+// Returns:
+//   1 if successful, 0 if the modulus is even (Montgomery reduction
+//   requires an odd modulus)
+int uint256_mont_init( UInt256MontCtx *ctx, UInt256 modulus );
+
+// Convert a value into Montgomery form (a*R mod m).
+// Any 256-bit value is accepted; the result is fully reduced.
+UInt256 uint256_mont_to( const UInt256MontCtx *ctx, UInt256 a );
+
+// Convert a value out of Montgomery form (a*R^-1 mod m).
+UInt256 uint256_mont_from( const UInt256MontCtx *ctx, UInt256 a );
+
+// Montgomery product of two values in Montgomery form: a*b*R^-1 mod m.
+// Both operands must be less than m.
+UInt256 uint256_mont_mul( const UInt256MontCtx *ctx, UInt256 a, UInt256 b );
+
+// Compute (a + b) mod m. Both operands must be less than m.
+// Works the same for plain and Montgomery-form values.
+UInt256 uint256_mont_add( const UInt256MontCtx *ctx, UInt256 a, UInt256 b );
+
+// Compute (a - b) mod m. Both operands must be less than m.
+// Works the same for plain and Montgomery-form values.
+UInt256 uint256_mont_sub( const UInt256MontCtx *ctx, UInt256 a, UInt256 b );
+
+// Compute base^exp mod m. The base must be in Montgomery form (and less
+// than m), the exponent is an ordinary integer, and the result is
+// returned in Montgomery form. Uses uint256_mont_pow_window with
+// UINT256_MONT_POW_WINDOW.
+UInt256 uint256_mont_pow( const UInt256MontCtx *ctx, UInt256 base, UInt256 exp );
+
+// Largest window size accepted by uint256_mont_pow_window and
+// uint256_mont_fixed_base_init.
+#define UINT256_MONT_MAX_WINDOW 6
+
+// Window size used by uint256_mont_pow; 5 minimizes the number of
+// multiplications for 256-bit exponents.
+#define UINT256_MONT_POW_WINDOW 5
+
+// Compute base^exp mod m like uint256_mont_pow, with sliding-window
+// exponentiation: the odd powers base^1, base^3, ..., base^(2^window-1)
+// are precomputed, and each run of up to `window` exponent bits that
+// starts and ends with a 1 costs one multiplication by a table entry
+// (every bit still costs a squaring). The window must be between 1 and
+// UINT256_MONT_MAX_WINDOW; window 1 is plain square-and-multiply.
+UInt256 uint256_mont_pow_window( const UInt256MontCtx *ctx, UInt256 base,
+                                 UInt256 exp, unsigned window );
+
+// Precomputed powers of a fixed base, for computing base^exp mod m for
+// many different exponents.
+//
+// The exponent is split into digits of `window` bits, and the table
+// holds base^(d * 2^(window*i)) for every digit position i and every
+// nonzero digit value d, so an exponentiation is one multiplication
+// per nonzero digit and no squarings at all. The table has
+// ceil(256/window) * (2^window - 1) entries (960 for window 4, i.e.
+// 30 KiB), and is allocated on the heap.
+typedef struct {
+  UInt256MontCtx ctx; // copy of the context the table was built for
+  unsigned window;    // digit size in bits
+  unsigned digits;    // number of digit positions, ceil(256/window)
+  UInt256 *table;     // entry (i, d) is at table[i*(2^window - 1) + d - 1]
+} UInt256MontFixedBase;
+
+// Build the table of powers of base (in Montgomery form, less than m).
+// The window must be between 1 and UINT256_MONT_MAX_WINDOW.
+//
+// Returns:
+//   1 if successful, 0 if the table could not be allocated
+int uint256_mont_fixed_base_init( UInt256MontFixedBase *fb,
+                                  const UInt256MontCtx *ctx, UInt256 base,
+                                  unsigned window );
+
+// Compute base^exp mod m (in Montgomery form) for the base the table
+// was built for.
+UInt256 uint256_mont_fixed_base_pow( const UInt256MontFixedBase *fb,
+                                     UInt256 exp );
+
+// Free the table of a fixed-base context.
+void uint256_mont_fixed_base_free( UInt256MontFixedBase *fb );
+
+#endif // UINT256_MONT_H
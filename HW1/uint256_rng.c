@@ -0,0 +1,298 @@
+#include "uint256_rng.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "uint256_kernels.h"
+#include "uint256_limbs.h"
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(UINT256_PORTABLE)
+#define UINT256_RNG_AVX2 1
+#include <immintrin.h>
+#endif
+
+// Philox4x32-10 constants: the round multipliers and the key schedule
+// increments (the golden ratio and sqrt(3) - 1).
+#define PHILOX_M0 0xd2511f53U
+#define PHILOX_M1 0xcd9e8d57U
+#define PHILOX_W0 0x9e3779b9U
+#define PHILOX_W1 0xbb67ae85U
+#define PHILOX_ROUNDS 10
+
+// Each value is two Philox blocks of four 32-bit words: block 2*i
+// gives limbs 0-3 of value i and block 2*i+1 gives limbs 4-7. The
+// 128-bit block counter is the block number (low 64 bits) and the
+// stream number (high 64 bits).
+
+// One Philox round on a block, with round key k0, k1.
+#define PHILOX_ROUND(c0, c1, c2, c3, k0, k1)                                   \
+  do {                                                                         \
+    uint64_t p0 = (uint64_t)PHILOX_M0 * c0;                                    \
+    uint64_t p1 = (uint64_t)PHILOX_M1 * c2;                                    \
+    c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;                                       \
+    c1 = (uint32_t)p1;                                                         \
+    c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;                                       \
+    c3 = (uint32_t)p0;                                                         \
+  } while (0)
+
+// Compute value number pos of the stream. Its two blocks differ only
+// in the lowest counter bit, and are run through the rounds together
+// so that their multiplies overlap.
+static UInt256 value_at(const UInt256Rng *rng, uint64_t pos) {
+  uint64_t block = 2 * pos;
+  uint32_t a0 = (uint32_t)block, a1 = (uint32_t)(block >> 32);
+  uint32_t a2 = (uint32_t)rng->stream, a3 = (uint32_t)(rng->stream >> 32);
+  uint32_t b0 = a0 + 1, b1 = a1, b2 = a2, b3 = a3;
+  uint32_t k0 = rng->key[0], k1 = rng->key[1];
+  for (int r = 0; r < PHILOX_ROUNDS; r++) {
+    PHILOX_ROUND(a0, a1, a2, a3, k0, k1);
+    PHILOX_ROUND(b0, b1, b2, b3, k0, k1);
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+  UInt256 val;
+  store_words(val.data, a0 | ((uint64_t)a1 << 32), a2 | ((uint64_t)a3 << 32),
+              b0 | ((uint64_t)b1 << 32), b2 | ((uint64_t)b3 << 32));
+  return val;
+}
+
+// The splitmix64 finalizer, used to hash seeds and stream numbers.
+static uint64_t mix64(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+// Initialize a generator from a seed, at the start of stream 0.
+void uint256_rng_init(UInt256Rng *rng, uint64_t seed) {
+  uint64_t k = mix64(seed);
+  rng->key[0] = (uint32_t)k;
+  rng->key[1] = (uint32_t)(k >> 32);
+  rng->stream = 0;
+  rng->counter = 0;
+}
+
+// Initialize child as a new stream derived from parent and an index.
+// The child stream number hashes the parent's together with the index;
+// the extra +1 keeps the child of stream 0, index 0 from being stream
+// 0 again.
+void uint256_rng_split(UInt256Rng *child, const UInt256Rng *parent,
+                       uint64_t index) {
+  child->key[0] = parent->key[0];
+  child->key[1] = parent->key[1];
+  child->stream =
+      mix64(mix64(parent->stream + 1) ^ (index * 0x9e3779b97f4a7c15ULL));
+  child->counter = 0;
+}
+
+// Return the next value of the stream.
+UInt256 uint256_rng_next(UInt256Rng *rng) {
+  return value_at(rng, rng->counter++);
+}
+
+#ifdef UINT256_RNG_AVX2
+
+#define AVX2 __attribute__((target("avx2")))
+
+// 32x32 -> 64-bit products of all eight lanes of a with m: VPMULUDQ
+// only multiplies the even lanes, so the odd lanes take a second one,
+// and the halves are blended back into lane order.
+AVX2 static inline void mulhilo8(__m256i a, __m256i m, __m256i *hi,
+                                 __m256i *lo) {
+  __m256i even = _mm256_mul_epu32(a, m);
+  __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+  *lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xaa);
+  *hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xaa);
+}
+
+// Compute values pos, ..., pos+4*count-1 into dst, eight Philox blocks
+// (four values) at a time, one block per 32-bit lane. Block l of a
+// group is the 16 bytes at offset 16*l of the output, so the four
+// counter words of each lane are transposed into place.
+AVX2 static void fill_avx2(const UInt256Rng *rng, UInt256 *dst, size_t count,
+                           uint64_t pos) {
+  const __m256i m0 = _mm256_set1_epi32((int)PHILOX_M0);
+  const __m256i m1 = _mm256_set1_epi32((int)PHILOX_M1);
+  const __m256i s2 = _mm256_set1_epi32((int)(uint32_t)rng->stream);
+  const __m256i s3 = _mm256_set1_epi32((int)(uint32_t)(rng->stream >> 32));
+  const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+  for (size_t g = 0; g < count; g++) {
+    uint64_t block = 2 * (pos + 4 * g);
+    __m256i c0 = _mm256_add_epi32(_mm256_set1_epi32((int)(uint32_t)block),
+                                  lane);
+    __m256i c1;
+    if ((uint32_t)block <= 0xffffffffU - 7) {
+      c1 = _mm256_set1_epi32((int)(uint32_t)(block >> 32));
+    } else {
+      // the low counter word wraps within this group
+      uint32_t hi[8];
+      for (int l = 0; l < 8; l++) {
+        hi[l] = (uint32_t)((block + (uint64_t)l) >> 32);
+      }
+      c1 = _mm256_loadu_si256((const __m256i *)hi);
+    }
+    __m256i c2 = s2, c3 = s3;
+    uint32_t k0 = rng->key[0], k1 = rng->key[1];
+
+    for (int r = 0; r < PHILOX_ROUNDS; r++) {
+      __m256i hi0, lo0, hi1, lo1;
+      mulhilo8(c0, m0, &hi0, &lo0);
+      mulhilo8(c2, m1, &hi1, &lo1);
+      c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1),
+                            _mm256_set1_epi32((int)k0));
+      c1 = lo1;
+      c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3),
+                            _mm256_set1_epi32((int)k1));
+      c3 = lo0;
+      k0 += PHILOX_W0;
+      k1 += PHILOX_W1;
+    }
+
+    __m256i t0 = _mm256_unpacklo_epi32(c0, c1);
+    __m256i t1 = _mm256_unpackhi_epi32(c0, c1);
+    __m256i t2 = _mm256_unpacklo_epi32(c2, c3);
+    __m256i t3 = _mm256_unpackhi_epi32(c2, c3);
+    __m256i u0 = _mm256_unpacklo_epi64(t0, t2); // blocks 0 and 4
+    __m256i u1 = _mm256_unpackhi_epi64(t0, t2); // blocks 1 and 5
+    __m256i u2 = _mm256_unpacklo_epi64(t1, t3); // blocks 2 and 6
+    __m256i u3 = _mm256_unpackhi_epi64(t1, t3); // blocks 3 and 7
+    __m256i *out = (__m256i *)(dst + 4 * g);
+    _mm256_storeu_si256(out, _mm256_permute2x128_si256(u0, u1, 0x20));
+    _mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(u2, u3, 0x20));
+    _mm256_storeu_si256(out + 2, _mm256_permute2x128_si256(u0, u1, 0x31));
+    _mm256_storeu_si256(out + 3, _mm256_permute2x128_si256(u2, u3, 0x31));
+  }
+}
+
+#undef AVX2
+
+static int have_avx2(void) {
+  return (uint256_cpu_features() & UINT256_CPU_AVX2) != 0;
+}
+
+#endif // UINT256_RNG_AVX2
+
+// Store values number pos, ..., pos+n-1 of the stream in dst.
+void uint256_rng_fill_at(const UInt256Rng *rng, UInt256 *dst, size_t n,
+                         uint64_t pos) {
+  size_t k = 0;
+#ifdef UINT256_RNG_AVX2
+  if (have_avx2()) {
+    fill_avx2(rng, dst, n / 4, pos);
+    k = n - n % 4;
+  }
+#endif
+  for (; k < n; k++) {
+    dst[k] = value_at(rng, pos + k);
+  }
+}
+
+// Store the next n values of the stream in dst.
+void uint256_rng_fill(UInt256Rng *rng, UInt256 *dst, size_t n) {
+  uint256_rng_fill_at(rng, dst, n, rng->counter);
+  rng->counter += n;
+}
+
+// The bound, prepared for the products of Lemire's method: most bounds
+// are much narrower than 256 bits, so only its nonzero 64-bit words
+// are multiplied in.
+typedef struct {
+  UInt256 val;
+  UInt256 threshold; // 2^256 mod bound, once it is needed
+  uint64_t words[4];
+  int nwords;
+} Bound;
+
+static void bound_init(Bound *b, UInt256 bound) {
+  b->val = bound;
+  b->nwords = 0;
+  for (int i = 0; i < 4; i++) {
+    b->words[i] = (uint64_t)bound.data[2 * i] |
+                  ((uint64_t)bound.data[2 * i + 1] << 32);
+    if (b->words[i] != 0) {
+      b->nwords = i + 1;
+    }
+  }
+}
+
+// 2^256 mod bound, computed as (2^256 - bound) mod bound.
+static void bound_init_threshold(Bound *b) {
+  uint256_divmod(uint256_negate(b->val), b->val, NULL, &b->threshold);
+}
+
+// Compute the 512-bit product x * bound as *hi:*lo.
+static void scale(UInt256 x, const Bound *b, UInt256 *hi, UInt256 *lo) {
+#ifdef __SIZEOF_INT128__
+  __extension__ typedef unsigned __int128 u128;
+  uint64_t xw[4], r[8] = {0};
+  for (int i = 0; i < 4; i++) {
+    xw[i] = (uint64_t)x.data[2 * i] | ((uint64_t)x.data[2 * i + 1] << 32);
+  }
+  for (int j = 0; j < b->nwords; j++) {
+    uint64_t carry = 0;
+    for (int i = 0; i < 4; i++) {
+      u128 t = (u128)xw[i] * b->words[j] + r[i + j] + carry;
+      r[i + j] = (uint64_t)t;
+      carry = (uint64_t)(t >> 64);
+    }
+    r[j + 4] = carry;
+  }
+  for (int i = 0; i < 4; i++) {
+    lo->data[2 * i] = (uint32_t)r[i];
+    lo->data[2 * i + 1] = (uint32_t)(r[i] >> 32);
+    hi->data[2 * i] = (uint32_t)r[i + 4];
+    hi->data[2 * i + 1] = (uint32_t)(r[i + 4] >> 32);
+  }
+#else
+  uint256_mul_wide(x, b->val, hi, lo);
+#endif
+}
+
+// Return floor(x * bound / 2^256) for a random x, redrawing x while
+// the low half of the product is below threshold = 2^256 mod bound.
+// Each result is then hit by exactly floor(2^256 / bound) values of x.
+static UInt256 below_with(UInt256Rng *rng, const Bound *b) {
+  UInt256 hi, lo;
+  do {
+    scale(uint256_rng_next(rng), b, &hi, &lo);
+  } while (uint256_cmp(lo, b->threshold) < 0);
+  return hi;
+}
+
+// Return a uniformly distributed value in [0, bound).
+// The threshold is below bound, so a low half of at least bound can be
+// accepted without computing it; that skips the division on almost
+// every draw when bound is small compared to 2^256.
+UInt256 uint256_rng_below(UInt256Rng *rng, UInt256 bound) {
+  assert(!uint256_is_zero(bound)); // undefined behavior
+  Bound b;
+  bound_init(&b, bound);
+  UInt256 hi, lo;
+  scale(uint256_rng_next(rng), &b, &hi, &lo);
+  if (uint256_cmp(lo, bound) >= 0) {
+    return hi;
+  }
+  bound_init_threshold(&b);
+  if (uint256_cmp(lo, b.threshold) >= 0) {
+    return hi;
+  }
+  return below_with(rng, &b);
+}
+
+// Store n values uniformly distributed in [0, bound) in dst, computing
+// the threshold once for all of them.
+// The candidates are generated in bulk with uint256_rng_fill, straight
+// into dst; rejected ones are redrawn from the values after them.
+void uint256_rng_below_n(UInt256Rng *rng, UInt256 *dst, size_t n,
+                         UInt256 bound) {
+  assert(!uint256_is_zero(bound)); // undefined behavior
+  Bound b;
+  bound_init(&b, bound);
+  bound_init_threshold(&b);
+  uint256_rng_fill(rng, dst, n);
+  for (size_t k = 0; k < n; k++) {
+    UInt256 hi, lo;
+    scale(dst[k], &b, &hi, &lo);
+    dst[k] = uint256_cmp(lo, b.threshold) < 0 ? below_with(rng, &b) : hi;
+  }
+}
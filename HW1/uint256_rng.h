@@ -0,0 +1,60 @@
+#ifndef UINT256_RNG_H
+#define UINT256_RNG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "uint256.h"
+
+// Seeded pseudo-random generation of uniform UInt256 values.
+//
+// The generator is counter-based (Philox4x32-10, from Salmon et al.,
+// "Parallel random numbers: as easy as 1, 2, 3", SC'11): value number
+// i of a stream is a keyed hash of i, so any part of a stream can be
+// generated directly, without generating what comes before it. Two
+// ways to generate in parallel follow from that:
+//  - uint256_rng_fill_at lets each thread fill its own slice of one
+//    big array, with the same result as filling it on one thread;
+//  - uint256_rng_split derives independent child streams, one per
+//    thread or task.
+// This is not a cryptographic generator.
+
+typedef struct {
+  uint32_t key[2];  // from the seed; shared by all split streams
+  uint64_t stream;  // which stream (0 for the one made by init)
+  uint64_t counter; // index of the next value in the stream
+} UInt256Rng;
+
+// Initialize a generator from a seed, at the start of stream 0.
+void uint256_rng_init( UInt256Rng *rng, uint64_t seed );
+
+// Initialize child as a new stream derived from parent and an index
+// (e.g. a thread number), at its start. Different indices, and
+// repeated splits of the children, give different streams (stream
+// numbers are hashed, so a collision has probability about 2^-64).
+// parent is not changed.
+void uint256_rng_split( UInt256Rng *child, const UInt256Rng *parent,
+                        uint64_t index );
+
+// Return the next value of the stream.
+UInt256 uint256_rng_next( UInt256Rng *rng );
+
+// Store the next n values of the stream in dst. Uses AVX2 when the CPU
+// supports it.
+void uint256_rng_fill( UInt256Rng *rng, UInt256 *dst, size_t n );
+
+// Store values number pos, ..., pos+n-1 of the stream in dst, without
+// changing rng.
+void uint256_rng_fill_at( const UInt256Rng *rng, UInt256 *dst, size_t n,
+                          uint64_t pos );
+
+// Return a uniformly distributed value in [0, bound), with no bias.
+// bound must not be 0. Uses Lemire's method: the high half of the
+// 512-bit product of a random value and bound is the result, and the
+// rare draws whose low half falls in the biased region are rejected.
+UInt256 uint256_rng_below( UInt256Rng *rng, UInt256 bound );
+
+// Store n values uniformly distributed in [0, bound) in dst.
+void uint256_rng_below_n( UInt256Rng *rng, UInt256 *dst, size_t n,
+                          UInt256 bound );
+
+#endif // UINT256_RNG_H
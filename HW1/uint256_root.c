@@ -0,0 +1,126 @@
+#include "uint256_root.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Both roots run Newton's iteration from a starting point at or above
+// the root. From there the iterates decrease monotonically until they
+// reach floor(root), and the first step that doesn't decrease marks
+// the answer, so the result is exact with no correction step.
+
+// floor(sqrt(v)) for a 64-bit value, digit by digit (two bits per
+// step).
+static uint64_t isqrt64(uint64_t v) {
+  if (v == 0) {
+    return 0;
+  }
+  uint64_t r = 0;
+  // the highest power of 4 that is <= v
+  uint64_t bit = 1ULL << ((63 - __builtin_clzll(v)) & ~1);
+  while (bit != 0) {
+    // branch-free: the digit is unpredictable, so a branch on it would
+    // mispredict half of the time
+    uint64_t t = r + bit;
+    uint64_t take = -(uint64_t)(v >= t);
+    v -= t & take;
+    r = (r >> 1) + (bit & take);
+    bit >>= 2;
+  }
+  return r;
+}
+
+// Compute floor(sqrt(val)).
+// With val = top * 2^shift + rest (shift even, top below 2^63),
+// sqrt(val) < sqrt(top + 1) * 2^(shift/2) <= (isqrt(top) + 1) *
+// 2^(shift/2), which is within about 2^-31 of the root, so Newton's
+// iteration (quadratic) finishes in two or three divisions.
+UInt256 uint256_isqrt(UInt256 val) {
+  unsigned bits = uint256_bit_length(val);
+  if (bits <= 64) {
+    uint64_t v = (uint64_t)val.data[0] | ((uint64_t)val.data[1] << 32);
+    UInt256 r = uint256_create_from_u32(0);
+    uint64_t s = isqrt64(v);
+    r.data[0] = (uint32_t)s;
+    r.data[1] = (uint32_t)(s >> 32);
+    return r;
+  }
+
+  unsigned shift = (bits - 63 + 1) & ~1U;
+  UInt256 top = uint256_rshift(val, shift);
+  uint64_t t = (uint64_t)top.data[0] | ((uint64_t)top.data[1] << 32);
+  UInt256 x = uint256_create_from_u32(0);
+  uint64_t s = isqrt64(t) + 1;
+  x.data[0] = (uint32_t)s;
+  x.data[1] = (uint32_t)(s >> 32);
+  x = uint256_lshift(x, shift / 2);
+
+  for (;;) {
+    // y = (x + val / x) / 2; x <= 2^129, so the sum can't overflow
+    UInt256 q;
+    uint256_divmod(val, x, &q, NULL);
+    UInt256 y = uint256_rshift(uint256_add(x, q), 1);
+    if (uint256_cmp(y, x) >= 0) {
+      return x;
+    }
+    x = y;
+  }
+}
+
+// Compute x^e into *out; returns 0 (leaving *out unspecified) if the
+// power doesn't fit in 256 bits. Left-to-right square-and-multiply:
+// every intermediate value divides the final power, so an overflow
+// along the way means the power itself overflows.
+static int pow_fits(UInt256 x, unsigned e, UInt256 *out) {
+  UInt256 r = uint256_create_from_u32(1);
+  for (int i = 31 - __builtin_clz(e); i >= 0; i--) {
+    UInt256 hi;
+    uint256_mul_wide(r, r, &hi, &r);
+    if (!uint256_is_zero(hi)) {
+      return 0;
+    }
+    if ((e >> i) & 1) {
+      uint256_mul_wide(r, x, &hi, &r);
+      if (!uint256_is_zero(hi)) {
+        return 0;
+      }
+    }
+  }
+  *out = r;
+  return 1;
+}
+
+// Compute floor(val^(1/n)).
+// The seed 2^ceil(bits/n) is at least the root and less than twice it
+// (above 2^((bits-1)/n), a lower bound on the root); each step is
+//   x' = ((n-1)*x + val / x^(n-1)) / n.
+// If x^(n-1) overflows, val / x^(n-1) is 0.
+UInt256 uint256_iroot(UInt256 val, unsigned n) {
+  assert(n != 0); // undefined behavior
+  UInt256 zero = uint256_create_from_u32(0);
+  if (n == 1 || uint256_is_zero(val)) {
+    return val;
+  }
+  if (n == 2) {
+    return uint256_isqrt(val);
+  }
+  if (n >= 256) {
+    // 2^n > val, so the root is 1
+    return uint256_create_from_u32(1);
+  }
+
+  unsigned bits = uint256_bit_length(val);
+  UInt256 x = uint256_lshift(uint256_create_from_u32(1), (bits + n - 1) / n);
+  for (;;) {
+    UInt256 p, q = zero;
+    if (pow_fits(x, n - 1, &p)) {
+      uint256_divmod(val, p, &q, NULL);
+    }
+    // x <= 2^128 and n < 256, so (n-1)*x + q can't overflow
+    UInt256 y = uint256_add(uint256_mul_u32(x, n - 1), q);
+    y = uint256_divmod_u32(y, n, NULL);
+    if (uint256_cmp(y, x) >= 0) {
+      return x;
+    }
+    x = y;
+  }
+}
@@ -0,0 +1,18 @@
+#ifndef UINT256_ROOT_H
+#define UINT256_ROOT_H
+
+#include "uint256.h"
+
+// Integer roots of UInt256 values.
+
+// Compute floor(sqrt(val)) with Newton's iteration, seeded from the bit
+// length and leading bits of val so that only a couple of steps (each
+// one division) are needed.
+UInt256 uint256_isqrt( UInt256 val );
+
+// Compute floor(val^(1/n)), the largest r with r^n <= val, with
+// Newton's iteration seeded from the bit length of val. n must not be
+// 0. n == 1 gives val, and any n >= 256 gives 1 (or 0 for val == 0).
+UInt256 uint256_iroot( UInt256 val, unsigned n );
+
+#endif // UINT256_ROOT_H
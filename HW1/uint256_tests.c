@@ -2,17 +2,37 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "int256.h"
 #include "uint256.h"
+#include "uint256_acc.h"
+#include "uint256_barrett.h"
+#include "uint256_batch.h"
+#include "uint256_bytes.h"
+#include "uint256_dispatch.h"
+#include "uint256_field.h"
+#include "uint256_gcd.h"
+#include "uint256_mont.h"
+#include "uint256_root.h"
+#include "uint256_rng.h"
 
 typedef struct {
   UInt256 zero;    // the value equal to 0
   UInt256 one;     // the value equal to 1
   UInt256 max;     // the value equal to (2^256)-1
   UInt256 msb_set; // the value equal to 2^255
+  // full-width operands with every limb nonzero:
+  // big_a = fedcba98765432100123456789abcdefdeadbeefcafebabe0badf00d8badf00d
+  // big_b = 1234567890abcdeffedcba0987654321aaaaaaaa55555555ffffffff00000001
+  UInt256 big_a;
+  UInt256 big_b;
+  // the operand from test_lshift:
+  // 727767d07ccff5fe25cd125b4523e8c7db1b8d1a2c8a2830284d72bb872c33a5
+  UInt256 pattern;
 } TestObjs;
 
 // Helper functions for implementing tests
 void set_all(UInt256 *val, uint32_t wordval);
+void fill_pseudo_random(UInt256 *vals, size_t n, uint32_t seed);
 
 #define ASSERT_SAME(expected, actual)                                          \
   do {                                                                         \
@@ -58,6 +78,46 @@ void test_sub2();
 void test_negate2();
 void test_lshift2(TestObjs *objs);
 void test_mul2(TestObjs *objs);
+void test_mul3(TestObjs *objs);
+void test_mul_wide(TestObjs *objs);
+void test_sqr(TestObjs *objs);
+void test_mont(TestObjs *objs);
+void test_field(TestObjs *objs);
+void test_divmod(TestObjs *objs);
+void test_create_from_dec(TestObjs *objs);
+void test_format_as_dec(TestObjs *objs);
+void test_format_as_hex_into(TestObjs *objs);
+void test_format_as_hex_batch(TestObjs *objs);
+void test_parse_hex(TestObjs *objs);
+void test_parse_dec(TestObjs *objs);
+void test_in_place_ops(TestObjs *objs);
+void test_carry_chain(TestObjs *objs);
+void test_batch_ops(TestObjs *objs);
+void test_dispatch_backends(TestObjs *objs);
+void test_rshift(TestObjs *objs);
+void test_rotate(TestObjs *objs);
+void test_bitwise_ops(TestObjs *objs);
+void test_cmp(TestObjs *objs);
+void test_bit_scan(TestObjs *objs);
+void test_gcd(TestObjs *objs);
+void test_modinv(TestObjs *objs);
+void test_barrett(TestObjs *objs);
+void test_mont_pow_window(TestObjs *objs);
+void test_mont_fixed_base(TestObjs *objs);
+void test_load_store_bytes(TestObjs *objs);
+void test_load_store_bytes_n(TestObjs *objs);
+void test_scalar_ops(TestObjs *objs);
+void test_acc(TestObjs *objs);
+void test_isqrt(TestObjs *objs);
+void test_iroot(TestObjs *objs);
+void test_rng(TestObjs *objs);
+void test_rng_below(TestObjs *objs);
+void test_int256_dec(TestObjs *objs);
+void test_int256_cmp(TestObjs *objs);
+void test_int256_sar(TestObjs *objs);
+void test_int256_mul(TestObjs *objs);
+void test_int256_divmod(TestObjs *objs);
+void test_shift_n(TestObjs *objs);
 
 int main(int argc, char **argv) {
   if (argc > 1)
@@ -85,6 +145,46 @@ int main(int argc, char **argv) {
   TEST(test_negate2);
   TEST(test_lshift2);
   TEST(test_mul2);
+  TEST(test_mul3);
+  TEST(test_mul_wide);
+  TEST(test_sqr);
+  TEST(test_mont);
+  TEST(test_field);
+  TEST(test_divmod);
+  TEST(test_create_from_dec);
+  TEST(test_format_as_dec);
+  TEST(test_format_as_hex_into);
+  TEST(test_format_as_hex_batch);
+  TEST(test_parse_hex);
+  TEST(test_parse_dec);
+  TEST(test_in_place_ops);
+  TEST(test_carry_chain);
+  TEST(test_batch_ops);
+  TEST(test_dispatch_backends);
+  TEST(test_rshift);
+  TEST(test_rotate);
+  TEST(test_bitwise_ops);
+  TEST(test_cmp);
+  TEST(test_bit_scan);
+  TEST(test_gcd);
+  TEST(test_modinv);
+  TEST(test_barrett);
+  TEST(test_mont_pow_window);
+  TEST(test_mont_fixed_base);
+  TEST(test_load_store_bytes);
+  TEST(test_load_store_bytes_n);
+  TEST(test_scalar_ops);
+  TEST(test_acc);
+  TEST(test_isqrt);
+  TEST(test_iroot);
+  TEST(test_rng);
+  TEST(test_rng_below);
+  TEST(test_int256_dec);
+  TEST(test_int256_cmp);
+  TEST(test_int256_sar);
+  TEST(test_int256_mul);
+  TEST(test_int256_divmod);
+  TEST(test_shift_n);
   TEST_FINI();
 }
 
@@ -95,6 +195,20 @@ void set_all(UInt256 *val, uint32_t wordval) {
   }
 }
 
+// Fill an array with deterministic pseudo-random values (a simple LCG),
+// mixing in limbs of all zeros and all ones so that carries and
+// borrows propagate through several limbs.
+void fill_pseudo_random(UInt256 *vals, size_t n, uint32_t seed) {
+  uint32_t x = seed;
+  for (size_t k = 0; k < n; ++k) {
+    for (unsigned i = 0; i < 8; ++i) {
+      x = x * 1664525U + 1013904223U;
+      uint32_t pick = x >> 29;
+      vals[k].data[i] = pick == 0 ? 0U : pick == 1 ? 0xFFFFFFFFU : x;
+    }
+  }
+}
+
 TestObjs *setup(void) {
   TestObjs *objs = (TestObjs *)malloc(sizeof(TestObjs));
 
@@ -108,6 +222,19 @@ TestObjs *setup(void) {
   uint32_t msb_set_data[8] = {0U, 0U, 0U, 0U, 0U, 0U, 0U, 0x80000000U};
   INIT_FROM_ARR(objs->msb_set, msb_set_data);
 
+  uint32_t big_a_data[8] = {0x8badf00dU, 0x0badf00dU, 0xcafebabeU,
+                            0xdeadbeefU, 0x89abcdefU, 0x01234567U,
+                            0x76543210U, 0xfedcba98U};
+  INIT_FROM_ARR(objs->big_a, big_a_data);
+  uint32_t big_b_data[8] = {0x00000001U, 0xffffffffU, 0x55555555U,
+                            0xaaaaaaaaU, 0x87654321U, 0xfedcba09U,
+                            0x90abcdefU, 0x12345678U};
+  INIT_FROM_ARR(objs->big_b, big_b_data);
+  uint32_t pattern_data[8] = {0x872c33a5U, 0x284d72bbU, 0x2c8a2830U,
+                              0xdb1b8d1aU, 0x4523e8c7U, 0x25cd125bU,
+                              0x7ccff5feU, 0x727767d0U};
+  INIT_FROM_ARR(objs->pattern, pattern_data);
+
   return objs;
 }
 
@@ -551,6 +678,18 @@ void test_lshift2(TestObjs *objs) {
   UInt256 shift_max = uint256_sub(objs->max, one);
   result = uint256_lshift(objs->max, 1);
   ASSERT_SAME(shift_max, result);
+
+  // any shift is allowed, and 256 or more shifts everything out
+  unsigned big_shifts[] = {256U, 257U, 320U, 511U, 512U, 1000U, ~0U};
+  for (size_t i = 0; i < sizeof(big_shifts) / sizeof(big_shifts[0]); i++) {
+    ASSERT_SAME(objs->zero, uint256_lshift(objs->max, big_shifts[i]));
+    ASSERT_SAME(objs->zero, uint256_rshift(objs->max, big_shifts[i]));
+    result = objs->max;
+    uint256_lshift_to(&result, &result, big_shifts[i]);
+    ASSERT_SAME(objs->zero, result);
+  }
+  result = uint256_lshift(objs->max, 255);
+  ASSERT_SAME(objs->msb_set, result);
 }
 
 void test_mul2(TestObjs *objs) {
@@ -567,4 +706,1968 @@ void test_mul2(TestObjs *objs) {
 
   result = uint256_mul(shift_32, shift_64);
   ASSERT_SAME(shift_96, result);
-}
\ No newline at end of file
+}
+
+void test_mul3(TestObjs *objs) {
+  UInt256 left = objs->big_a, right = objs->big_b, result;
+
+  // full-width operands, the product is truncated to the low 256 bits
+  uint32_t expected_arr[8] = {0x8badf00dU, 0x80000000U, 0x71c4c00eU,
+                              0x423e5436U, 0x4d978985U, 0x8152e2daU,
+                              0xa7faecfcU, 0x8f23516cU};
+  UInt256 expected;
+  INIT_FROM_ARR(expected, expected_arr);
+  result = uint256_mul(left, right);
+  ASSERT_SAME(expected, result);
+
+  // multiplication is commutative
+  result = uint256_mul(right, left);
+  ASSERT_SAME(expected, result);
+
+  // max * max = 1 (mod 2^256)
+  result = uint256_mul(objs->max, objs->max);
+  ASSERT_SAME(objs->one, result);
+
+  // max * 2^255 = 2^255 (mod 2^256)
+  result = uint256_mul(objs->max, objs->msb_set);
+  ASSERT_SAME(objs->msb_set, result);
+}
+
+void test_mul_wide(TestObjs *objs) {
+  UInt256 left = objs->big_a, right = objs->big_b, hi, lo;
+
+  uint32_t hi_arr[8] = {0xf3779ef6U, 0x507cf98cU, 0xd0bb09e1U, 0x642ac1aaU,
+                        0x9523494aU, 0x213cff75U, 0xcd77d743U, 0x121fa00aU};
+  uint32_t lo_arr[8] = {0x8badf00dU, 0x80000000U, 0x71c4c00eU, 0x423e5436U,
+                        0x4d978985U, 0x8152e2daU, 0xa7faecfcU, 0x8f23516cU};
+  UInt256 expected_hi, expected_lo;
+  INIT_FROM_ARR(expected_hi, hi_arr);
+  INIT_FROM_ARR(expected_lo, lo_arr);
+
+  uint256_mul_wide(left, right, &hi, &lo);
+  ASSERT_SAME(expected_hi, hi);
+  ASSERT_SAME(expected_lo, lo);
+
+  // the low half always matches the truncating multiply
+  ASSERT_SAME(uint256_mul(left, right), lo);
+
+  // max * max = 2^512 - 2^257 + 1
+  UInt256 max_minus_one = uint256_sub(objs->max, objs->one);
+  uint256_mul_wide(objs->max, objs->max, &hi, &lo);
+  ASSERT_SAME(max_minus_one, hi);
+  ASSERT_SAME(objs->one, lo);
+
+  // anything times zero is zero in both halves
+  uint256_mul_wide(left, objs->zero, &hi, &lo);
+  ASSERT_SAME(objs->zero, hi);
+  ASSERT_SAME(objs->zero, lo);
+}
+
+void test_sqr(TestObjs *objs) {
+  UInt256 val = objs->big_a, hi, lo, result;
+
+  uint32_t hi_arr[8] = {0x2673777dU, 0x3b195453U, 0x5f8f45ccU, 0xffcfc2a8U,
+                        0xff39ef85U, 0xe13060d8U, 0xc8dc5accU, 0xfdbac097U};
+  uint32_t lo_arr[8] = {0x70aa60a9U, 0x2d8b1a2eU, 0x723859a1U, 0xcf879c26U,
+                        0xf00a365fU, 0x40a8168aU, 0x37e0e836U, 0x2e1cb7e5U};
+  UInt256 expected_hi, expected_lo;
+  INIT_FROM_ARR(expected_hi, hi_arr);
+  INIT_FROM_ARR(expected_lo, lo_arr);
+
+  uint256_sqr_wide(val, &hi, &lo);
+  ASSERT_SAME(expected_hi, hi);
+  ASSERT_SAME(expected_lo, lo);
+
+  result = uint256_sqr(val);
+  ASSERT_SAME(expected_lo, result);
+
+  // max^2 = 2^512 - 2^257 + 1
+  UInt256 max_minus_one = uint256_sub(objs->max, objs->one);
+  uint256_sqr_wide(objs->max, &hi, &lo);
+  ASSERT_SAME(max_minus_one, hi);
+  ASSERT_SAME(objs->one, lo);
+  result = uint256_sqr(objs->max);
+  ASSERT_SAME(objs->one, result);
+
+  // (2^255)^2 = 2^510
+  uint256_sqr_wide(objs->msb_set, &hi, &lo);
+  ASSERT(0x40000000U == hi.data[7]);
+  ASSERT_SAME(objs->zero, lo);
+  result = uint256_sqr(objs->msb_set);
+  ASSERT_SAME(objs->zero, result);
+}
+
+void test_mont(TestObjs *objs) {
+  UInt256MontCtx ctx;
+  UInt256 result;
+
+  // even moduli are rejected
+  uint32_t two_data[8] = {2U};
+  UInt256 two;
+  INIT_FROM_ARR(two, two_data);
+  ASSERT(!uint256_mont_init(&ctx, two));
+
+  // p = 2^256 - 2^32 - 977 (the secp256k1 field prime)
+  UInt256 p = uint256_create_from_hex(
+      "fffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f");
+  ASSERT(uint256_mont_init(&ctx, p));
+
+  uint32_t one_arr[8] = {0x000003d1U, 0x00000001U};
+  UInt256 r_mod_p;
+  INIT_FROM_ARR(r_mod_p, one_arr);
+  ASSERT_SAME(r_mod_p, ctx.one);
+
+  // a is reduced on the way into Montgomery form
+  UInt256 a = objs->big_a, b = objs->big_b;
+  UInt256 am = uint256_mont_to(&ctx, a);
+  UInt256 bm = uint256_mont_to(&ctx, b);
+
+  // round trip
+  ASSERT_SAME(a, uint256_mont_from(&ctx, am));
+  ASSERT_SAME(b, uint256_mont_from(&ctx, bm));
+
+  uint32_t prod_arr[8] = {0xe1e66a33U, 0xb28ba278U, 0x5c126e7fU, 0x5a267afeU,
+                          0xdd6d0018U, 0xf0411be2U, 0xef9473a3U, 0x874cf1e9U};
+  UInt256 expected;
+  INIT_FROM_ARR(expected, prod_arr);
+  result = uint256_mont_from(&ctx, uint256_mont_mul(&ctx, am, bm));
+  ASSERT_SAME(expected, result);
+
+  uint32_t sum_arr[8] = {0x8badf3dfU, 0x0badf00dU, 0x20541014U, 0x8958699aU,
+                         0x11111111U, 0xffffff71U, 0x06ffffffU, 0x11111111U};
+  INIT_FROM_ARR(expected, sum_arr);
+  result = uint256_mont_from(&ctx, uint256_mont_add(&ctx, am, bm));
+  ASSERT_SAME(expected, result);
+
+  uint32_t diff_arr[8] = {0x74520c23U, 0xf4520ff0U, 0x8a569a97U, 0xcbfcebbaU,
+                          0xfdb97531U, 0xfdb974a1U, 0x1a579bdfU, 0x13579be0U};
+  INIT_FROM_ARR(expected, diff_arr);
+  result = uint256_mont_from(&ctx, uint256_mont_sub(&ctx, bm, am));
+  ASSERT_SAME(expected, result);
+
+  // a^65537 mod p
+  uint32_t pow_arr[8] = {0xff5d92d7U, 0x46644e99U, 0x05ac3190U, 0x17e23156U,
+                         0x0f1ae93dU, 0x1882ba8cU, 0x08708a53U, 0x51d20aedU};
+  INIT_FROM_ARR(expected, pow_arr);
+  result = uint256_mont_from(
+      &ctx, uint256_mont_pow(&ctx, am, uint256_create_from_u32(65537U)));
+  ASSERT_SAME(expected, result);
+
+  // Fermat: a^(p-1) == 1 (mod p), and x^0 == 1
+  UInt256 p_minus_one = uint256_sub(p, objs->one);
+  result = uint256_mont_from(&ctx, uint256_mont_pow(&ctx, am, p_minus_one));
+  ASSERT_SAME(objs->one, result);
+  result = uint256_mont_from(&ctx, uint256_mont_pow(&ctx, am, objs->zero));
+  ASSERT_SAME(objs->one, result);
+
+  // small modulus: 7 * 9 mod 11 = 8, 3 - 5 mod 11 = 9
+  UInt256 eleven = uint256_create_from_u32(11U);
+  ASSERT(uint256_mont_init(&ctx, eleven));
+  UInt256 x = uint256_mont_to(&ctx, uint256_create_from_u32(7U));
+  UInt256 y = uint256_mont_to(&ctx, uint256_create_from_u32(9U));
+  result = uint256_mont_from(&ctx, uint256_mont_mul(&ctx, x, y));
+  ASSERT_SAME(uint256_create_from_u32(8U), result);
+  x = uint256_create_from_u32(3U);
+  y = uint256_create_from_u32(5U);
+  result = uint256_mont_sub(&ctx, x, y);
+  ASSERT_SAME(uint256_create_from_u32(9U), result);
+}
+
+void test_field(TestObjs *objs) {
+  UInt256 a = objs->big_a, b = objs->big_b, expected, result;
+
+  // secp256k1
+  const UInt256Field *f = &uint256_field_secp256k1;
+  uint32_t k1_ab[8] = {0xe1e66a33U, 0xb28ba278U, 0x5c126e7fU, 0x5a267afeU,
+                       0xdd6d0018U, 0xf0411be2U, 0xef9473a3U, 0x874cf1e9U};
+  uint32_t k1_aa[8] = {0x851cd716U, 0xdd642b29U, 0x5f1b0e62U, 0x76fcc687U,
+                       0xfbf5176dU, 0xa983a236U, 0xaa07d0f6U, 0x4cb215f7U};
+  INIT_FROM_ARR(expected, k1_ab);
+  result = uint256_field_mul(f, a, b);
+  ASSERT_SAME(expected, result);
+  INIT_FROM_ARR(expected, k1_aa);
+  result = uint256_field_sqr(f, a);
+  ASSERT_SAME(expected, result);
+
+  // P-256
+  f = &uint256_field_p256;
+  uint32_t p256_ab[8] = {0xe79fa6e2U, 0x0b404360U, 0xa5d614d7U, 0x00033108U,
+                         0x6697eedaU, 0x3bf664caU, 0x11ea19ceU, 0xcdb3bc37U};
+  uint32_t p256_aa[8] = {0x2920bea8U, 0x2132488aU, 0x29cfe5d7U, 0x4f83d4f0U,
+                         0xdf1297caU, 0x331d45f9U, 0x0d8f0ed3U, 0x0df7185bU};
+  INIT_FROM_ARR(expected, p256_ab);
+  result = uint256_field_mul(f, a, b);
+  ASSERT_SAME(expected, result);
+  INIT_FROM_ARR(expected, p256_aa);
+  result = uint256_field_sqr(f, a);
+  ASSERT_SAME(expected, result);
+
+  // 2^255 - 19
+  f = &uint256_field_p25519;
+  uint32_t p25519_ab[8] = {0xaf6f8903U, 0x728d0aecU, 0x6d883780U,
+                           0x20971391U, 0x70d46a90U, 0x7060ce4eU,
+                           0x27c4e0f3U, 0x3fd51307U};
+  uint32_t p25519_aa[8] = {0x25ce22c8U, 0xf34d9e86U, 0xa17cb5f1U,
+                           0xc85e8124U, 0xd2a3c443U, 0xadd676c0U,
+                           0x0896629fU, 0x57d54e6dU};
+  INIT_FROM_ARR(expected, p25519_ab);
+  result = uint256_field_mul(f, a, b);
+  ASSERT_SAME(expected, result);
+  INIT_FROM_ARR(expected, p25519_aa);
+  result = uint256_field_sqr(f, a);
+  ASSERT_SAME(expected, result);
+
+  // edge cases for every field: (p-1)^2 = 1, p-1 + 1 = 0, 0 - 1 = p-1,
+  // and reducing p itself gives 0
+  const UInt256Field *fields[3] = {&uint256_field_secp256k1,
+                                   &uint256_field_p256, &uint256_field_p25519};
+  // (2^256 - 1)^2 mod p, the largest possible product
+  const char *max_sqr[3] = {
+      "1000007a0000e8900",
+      "2fffffffffffffffffffffffefffffffdffffffff0000000000000002", "559"};
+  for (int i = 0; i < 3; i++) {
+    f = fields[i];
+    UInt256 p_minus_one = uint256_sub(f->modulus, objs->one);
+    result = uint256_field_mul(f, p_minus_one, p_minus_one);
+    ASSERT_SAME(objs->one, result);
+    result = uint256_field_sqr(f, p_minus_one);
+    ASSERT_SAME(objs->one, result);
+    result = uint256_field_add(f, p_minus_one, objs->one);
+    ASSERT_SAME(objs->zero, result);
+    result = uint256_field_sub(f, objs->zero, objs->one);
+    ASSERT_SAME(p_minus_one, result);
+    result = f->reduce(objs->zero, f->modulus);
+    ASSERT_SAME(objs->zero, result);
+    expected = uint256_create_from_hex(max_sqr[i]);
+    result = uint256_field_mul(f, objs->max, objs->max);
+    ASSERT_SAME(expected, result);
+  }
+}
+
+void test_divmod(TestObjs *objs) {
+  UInt256 num, den, quot, rem, expected_quot, expected_rem;
+  uint32_t rem32;
+
+  num = objs->big_a;
+
+  // 256 / 128
+  den = uint256_create_from_hex("1234567890abcdeffedcba0987654321");
+  uint32_t q1[8] = {0x67ecac8eU, 0x37ef9bffU, 0xbde00014U, 0x00000007U,
+                    0x0000000eU};
+  uint32_t r1[8] = {0x3efc87bfU, 0x19abef91U, 0xc945020bU, 0x003fe166U};
+  INIT_FROM_ARR(expected_quot, q1);
+  INIT_FROM_ARR(expected_rem, r1);
+  uint256_divmod(num, den, &quot, &rem);
+  ASSERT_SAME(expected_quot, quot);
+  ASSERT_SAME(expected_rem, rem);
+
+  // 256 / 253
+  den = uint256_create_from_hex(
+      "1234567890abcdeffedcba0987654321aaaaaaaa55555555ffffffff00000001");
+  uint32_t r2[8] = {0x8badefffU, 0x0badf01bU, 0x2054100aU, 0x8958699fU,
+                    0x22222218U, 0x111118e2U, 0x8ceeeef0U, 0x00000000U};
+  INIT_FROM_ARR(expected_rem, r2);
+  uint256_divmod(num, den, &quot, &rem);
+  ASSERT_SAME(uint256_create_from_u32(14U), quot);
+  ASSERT_SAME(expected_rem, rem);
+
+  // 256 / 64, divisor top limb already normalized
+  den = uint256_create_from_hex("8000000000000001");
+  uint32_t q3[8] = {0x21efce2cU, 0xafb43d05U, 0x3a06d3a7U, 0x06d3a06dU,
+                    0xeca8641cU, 0xfdb97530U, 0x00000001U, 0x00000000U};
+  uint32_t r3[8] = {0x69be21e1U, 0x5bf9b308U};
+  INIT_FROM_ARR(expected_quot, q3);
+  INIT_FROM_ARR(expected_rem, r3);
+  uint256_divmod(num, den, &quot, &rem);
+  ASSERT_SAME(expected_quot, quot);
+  ASSERT_SAME(expected_rem, rem);
+
+  // 256 / 32 through both entry points
+  uint32_t q4[8] = {0x0927192cU, 0x655a5eeeU, 0x3ee1dc5cU, 0xa900ad18U,
+                    0x6a97569cU, 0xf093d62fU, 0x469ff98fU, 0x00000004U};
+  INIT_FROM_ARR(expected_quot, q4);
+  quot = uint256_divmod_u32(num, 1000000007U, &rem32);
+  ASSERT_SAME(expected_quot, quot);
+  ASSERT(0x294787d9U == rem32);
+  uint256_divmod(num, uint256_create_from_u32(1000000007U), &quot, &rem);
+  ASSERT_SAME(expected_quot, quot);
+  ASSERT_SAME(uint256_create_from_u32(0x294787d9U), rem);
+
+  // dividend smaller than divisor
+  uint256_divmod(objs->one, objs->max, &quot, &rem);
+  ASSERT_SAME(objs->zero, quot);
+  ASSERT_SAME(objs->one, rem);
+
+  // x / x = 1 remainder 0, max / 1 = max, and NULL outputs are allowed
+  uint256_divmod(objs->max, objs->max, &quot, &rem);
+  ASSERT_SAME(objs->one, quot);
+  ASSERT_SAME(objs->zero, rem);
+  uint256_divmod(objs->max, objs->one, &quot, NULL);
+  ASSERT_SAME(objs->max, quot);
+  uint256_divmod(objs->max, objs->msb_set, NULL, &rem);
+  ASSERT_SAME(uint256_sub(objs->msb_set, objs->one), rem);
+}
+
+void test_create_from_dec(TestObjs *objs) {
+  UInt256 result;
+
+  result = uint256_create_from_dec("0");
+  ASSERT_SAME(objs->zero, result);
+
+  result = uint256_create_from_dec("1");
+  ASSERT_SAME(objs->one, result);
+
+  // chunk boundaries: 9 and 10 digits
+  result = uint256_create_from_dec("999999999");
+  ASSERT_SAME(uint256_create_from_u32(999999999U), result);
+  result = uint256_create_from_dec("1000000000");
+  ASSERT_SAME(uint256_create_from_u32(1000000000U), result);
+  result = uint256_create_from_dec("1000000000000000000");
+  ASSERT_SAME(uint256_create_from_hex("de0b6b3a7640000"), result);
+
+  // leading zeros are harmless
+  result = uint256_create_from_dec("0000000000000000000042");
+  ASSERT_SAME(uint256_create_from_u32(42U), result);
+
+  result = uint256_create_from_dec(
+      "115792089237316195423570985008687907853269984665640564039457584007913"
+      "129639935");
+  ASSERT_SAME(objs->max, result);
+
+  result = uint256_create_from_dec(
+      "115277457729594790111051606095322955253787888243388381767888101133457"
+      "118064653");
+  ASSERT_SAME(uint256_create_from_hex("fedcba98765432100123456789abcdef"
+                                      "deadbeefcafebabe0badf00d8badf00d"),
+              result);
+
+  // 10^79 + 12345 doesn't fit, so it wraps modulo 2^256
+  result = uint256_create_from_dec("1000000000000000000000000000000000000000"
+                                   "0000000000000000000000000000000000012345");
+  uint32_t wrapped[8] = {0x00003039U, 0x00000000U, 0xae468000U, 0xa3903723U,
+                         0xcb2a027aU, 0xe161bf83U, 0xbdfccb24U, 0x5c976c9cU};
+  UInt256 expected;
+  INIT_FROM_ARR(expected, wrapped);
+  ASSERT_SAME(expected, result);
+}
+
+void test_format_as_dec(TestObjs *objs) {
+  char *s;
+
+  s = uint256_format_as_dec(objs->zero);
+  ASSERT(0 == strcmp("0", s));
+  free(s);
+
+  s = uint256_format_as_dec(objs->one);
+  ASSERT(0 == strcmp("1", s));
+  free(s);
+
+  // chunks after the first keep their leading zeros
+  s = uint256_format_as_dec(uint256_create_from_u32(1000000000U));
+  ASSERT(0 == strcmp("1000000000", s));
+  free(s);
+
+  s = uint256_format_as_dec(uint256_create_from_hex("de0b6b3a7640001"));
+  ASSERT(0 == strcmp("1000000000000000001", s));
+  free(s);
+
+  s = uint256_format_as_dec(objs->max);
+  ASSERT(0 == strcmp("1157920892373161954235709850086879078532699846656405"
+                     "64039457584007913129639935",
+                     s));
+  free(s);
+
+  // round trip
+  s = uint256_format_as_dec(objs->msb_set);
+  ASSERT_SAME(objs->msb_set, uint256_create_from_dec(s));
+  free(s);
+}
+
+void test_format_as_hex_into(TestObjs *objs) {
+  char buf[UINT256_HEX_BUFSIZE];
+  size_t len;
+
+  len = uint256_format_as_hex_into(objs->zero, buf, sizeof(buf));
+  ASSERT(1 == len);
+  ASSERT(0 == strcmp("0", buf));
+
+  len = uint256_format_as_hex_into(objs->max, buf, sizeof(buf));
+  ASSERT(64 == len);
+  ASSERT(0 ==
+         strcmp("ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+                buf));
+
+  // zeros inside and between limbs are kept, leading zeros are not
+  uint32_t arr[8] = {0x0000000fU, 0x00000000U, 0x00010000U};
+  UInt256 val;
+  INIT_FROM_ARR(val, arr);
+  len = uint256_format_as_hex_into(val, buf, sizeof(buf));
+  ASSERT(21 == len);
+  ASSERT(0 == strcmp("10000000000000000000f", buf));
+
+  // exactly enough room, and one byte too few
+  len = uint256_format_as_hex_into(val, buf, 22);
+  ASSERT(21 == len);
+  ASSERT(0 == strcmp("10000000000000000000f", buf));
+  len = uint256_format_as_hex_into(val, buf, 21);
+  ASSERT(21 == len);
+  ASSERT(0 == strcmp("", buf));
+  len = uint256_format_as_hex_into(val, NULL, 0);
+  ASSERT(21 == len);
+}
+
+void test_format_as_hex_batch(TestObjs *objs) {
+  UInt256 vals[4] = {objs->zero, objs->one, objs->msb_set,
+                     uint256_create_from_u32(0xabcU)};
+  const char *expected = "0\n1\n"
+                         "8000000000000000000000000000000000000000000000000000"
+                         "000000000000\nabc\n";
+  char buf[256];
+  size_t len;
+
+  len = uint256_format_as_hex_batch(vals, 4, buf, sizeof(buf));
+  ASSERT(strlen(expected) == len);
+  ASSERT(0 == strcmp(expected, buf));
+
+  // too small: only the values that fit are written
+  len = uint256_format_as_hex_batch(vals, 4, buf, 10);
+  ASSERT(strlen(expected) == len);
+  ASSERT(0 == strcmp("0\n1\n", buf));
+
+  len = uint256_format_as_hex_batch(vals, 0, buf, sizeof(buf));
+  ASSERT(0 == len);
+  ASSERT(0 == strcmp("", buf));
+}
+
+void test_parse_hex(TestObjs *objs) {
+  UInt256 result;
+
+  ASSERT(uint256_parse_hex("1", 1, &result));
+  ASSERT_SAME(objs->one, result);
+
+  // only len characters are read, the rest of the buffer is ignored
+  ASSERT(uint256_parse_hex("1fzzzz", 2, &result));
+  ASSERT_SAME(uint256_create_from_u32(0x1fU), result);
+
+  // upper and lower case digits
+  ASSERT(uint256_parse_hex("DeadBeef0", 9, &result));
+  uint32_t arr[8] = {0xeadbeef0U, 0xdU};
+  UInt256 expected;
+  INIT_FROM_ARR(expected, arr);
+  ASSERT_SAME(expected, result);
+
+  const char *max =
+      "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff";
+  ASSERT(uint256_parse_hex(max, 64, &result));
+  ASSERT_SAME(objs->max, result);
+
+  // more than 64 digits keeps the rightmost 64
+  ASSERT(uint256_parse_hex(
+      "18000000000000000000000000000000000000000000000000000000000000000",
+      65, &result));
+  ASSERT_SAME(objs->msb_set, result);
+
+  // invalid characters are reported and the result is zeroed
+  ASSERT(!uint256_parse_hex("12g4", 4, &result));
+  ASSERT_SAME(objs->zero, result);
+  ASSERT(!uint256_parse_hex("0x12", 4, &result));
+  ASSERT(!uint256_parse_hex(" 12", 3, &result));
+  ASSERT(!uint256_parse_hex("", 0, &result));
+  // ...even beyond the rightmost 64 digits
+  ASSERT(!uint256_parse_hex(
+      "z0000000000000000000000000000000000000000000000000000000000000000",
+      65, &result));
+
+  // uint256_create_from_hex maps invalid input to 0
+  result = uint256_create_from_hex("xyz");
+  ASSERT_SAME(objs->zero, result);
+}
+
+void test_parse_dec(TestObjs *objs) {
+  UInt256 result;
+
+  ASSERT(uint256_parse_dec("0", 1, &result));
+  ASSERT_SAME(objs->zero, result);
+
+  // only len characters are read, the rest of the buffer is ignored
+  ASSERT(uint256_parse_dec("1000000000xyz", 10, &result));
+  ASSERT_SAME(uint256_create_from_u32(1000000000U), result);
+
+  ASSERT(uint256_parse_dec(
+      "115792089237316195423570985008687907853269984665640564039457584007913"
+      "129639935",
+      78, &result));
+  ASSERT_SAME(objs->max, result);
+
+  // invalid characters are reported and the result is zeroed, whether
+  // they land in the short leading chunk or a later full one
+  ASSERT(!uint256_parse_dec("12a4", 4, &result));
+  ASSERT_SAME(objs->zero, result);
+  ASSERT(!uint256_parse_dec("1234567890/", 11, &result));
+  ASSERT(!uint256_parse_dec("-1", 2, &result));
+  ASSERT(!uint256_parse_dec(" 1", 2, &result));
+  ASSERT(!uint256_parse_dec("", 0, &result));
+
+  // uint256_create_from_dec maps invalid input to 0
+  result = uint256_create_from_dec("12:4");
+  ASSERT_SAME(objs->zero, result);
+}
+
+void test_in_place_ops(TestObjs *objs) {
+  UInt256 a = objs->big_a, b = objs->big_b, dst;
+
+  // separate destination: same results as the by-value API
+  uint256_add_to(&dst, &a, &b);
+  ASSERT_SAME(uint256_add(a, b), dst);
+  uint256_sub_to(&dst, &a, &b);
+  ASSERT_SAME(uint256_sub(a, b), dst);
+  uint256_negate_to(&dst, &a);
+  ASSERT_SAME(uint256_negate(a), dst);
+  uint256_mul_to(&dst, &a, &b);
+  ASSERT_SAME(uint256_mul(a, b), dst);
+  for (unsigned shift = 0; shift < 256; shift += 13) {
+    uint256_lshift_to(&dst, &a, shift);
+    ASSERT_SAME(uint256_lshift(a, shift), dst);
+  }
+
+  // dst aliases an operand
+  dst = a;
+  uint256_add_to(&dst, &dst, &b);
+  ASSERT_SAME(uint256_add(a, b), dst);
+  dst = b;
+  uint256_sub_to(&dst, &a, &dst);
+  ASSERT_SAME(uint256_sub(a, b), dst);
+  dst = a;
+  uint256_negate_to(&dst, &dst);
+  ASSERT_SAME(uint256_negate(a), dst);
+  dst = a;
+  uint256_mul_to(&dst, &dst, &b);
+  ASSERT_SAME(uint256_mul(a, b), dst);
+  dst = b;
+  uint256_mul_to(&dst, &a, &dst);
+  ASSERT_SAME(uint256_mul(a, b), dst);
+  dst = a;
+  uint256_lshift_to(&dst, &dst, 50);
+  ASSERT_SAME(uint256_lshift(a, 50), dst);
+
+  // all three the same value
+  dst = a;
+  uint256_add_to(&dst, &dst, &dst);
+  ASSERT_SAME(uint256_add(a, a), dst);
+  dst = a;
+  uint256_sub_to(&dst, &dst, &dst);
+  ASSERT_SAME(objs->zero, dst);
+  dst = a;
+  uint256_mul_to(&dst, &dst, &dst);
+  ASSERT_SAME(uint256_sqr(a), dst);
+
+  // wrap-around
+  dst = objs->max;
+  uint256_add_to(&dst, &dst, &objs->one);
+  ASSERT_SAME(objs->zero, dst);
+  uint256_sub_to(&dst, &dst, &objs->one);
+  ASSERT_SAME(objs->max, dst);
+}
+
+void test_carry_chain(TestObjs *objs) {
+  // a carry out of every limb in turn: (2^(32k) - 1) + 1 = 2^(32k), and
+  // a borrow through the same limbs going back
+  for (int k = 1; k <= 8; k++) {
+    UInt256 low_ones = objs->zero, power = objs->zero, neg = objs->zero;
+    for (int i = 0; i < 8; i++) {
+      if (i < k) {
+        low_ones.data[i] = 0xffffffffU;
+      } else {
+        neg.data[i] = 0xffffffffU;
+      }
+    }
+    if (k < 8) {
+      power.data[k] = 1U;
+    }
+    ASSERT_SAME(power, uint256_add(low_ones, objs->one));
+    ASSERT_SAME(power, uint256_add(objs->one, low_ones));
+    ASSERT_SAME(low_ones, uint256_sub(power, objs->one));
+    // -2^(32k) has every limb from k up set
+    ASSERT_SAME(neg, uint256_negate(power));
+
+    UInt256 dst = low_ones;
+    uint256_add_to(&dst, &dst, &objs->one);
+    ASSERT_SAME(power, dst);
+    uint256_sub_to(&dst, &dst, &objs->one);
+    ASSERT_SAME(low_ones, dst);
+  }
+
+  // a carry that stops in the high limb of a 64-bit pair, and one that
+  // leaves a pair from its high limb
+  uint32_t a_arr[8] = {0xffffffffU, 0U, 0xffffffffU, 0xffffffffU,
+                       0xffffffffU, 0U, 0U, 0U};
+  uint32_t a1_arr[8] = {0U, 1U, 0xffffffffU, 0xffffffffU,
+                        0xffffffffU, 0U, 0U, 0U};
+  uint32_t b_arr[8] = {0U, 0U, 0U, 0U, 0xffffffffU, 0xffffffffU, 0U, 0U};
+  uint32_t c_arr[8] = {0U, 0U, 0U, 0U, 0xffffffffU, 0U, 0U, 0U};
+  uint32_t bc_arr[8] = {0U, 0U, 0U, 0U, 0xfffffffeU, 0U, 1U, 0U};
+  UInt256 a, a1, b, c, bc;
+  INIT_FROM_ARR(a, a_arr);
+  INIT_FROM_ARR(a1, a1_arr);
+  INIT_FROM_ARR(b, b_arr);
+  INIT_FROM_ARR(c, c_arr);
+  INIT_FROM_ARR(bc, bc_arr);
+  ASSERT_SAME(a1, uint256_add(a, objs->one));
+  ASSERT_SAME(a, uint256_sub(a1, objs->one));
+  ASSERT_SAME(bc, uint256_add(b, c));
+  ASSERT_SAME(b, uint256_sub(bc, c));
+
+  // carries into and out of every limb at once
+  ASSERT_SAME(uint256_sub(objs->max, objs->one),
+              uint256_add(objs->max, objs->max));
+  ASSERT_SAME(objs->one, uint256_sub(objs->zero, objs->max));
+  ASSERT_SAME(objs->max, uint256_sub(objs->zero, objs->one));
+  ASSERT_SAME(objs->one, uint256_negate(objs->max));
+  ASSERT_SAME(objs->msb_set, uint256_negate(objs->msb_set));
+}
+
+void test_batch_ops(TestObjs *objs) {
+  enum { N = 37 };
+  UInt256 a[N], b[N], sum[N], diff[N];
+  int cmp[N];
+
+  fill_pseudo_random(a, N, 1U);
+  fill_pseudo_random(b, N, 2U);
+  // some fixed cases in both vector blocks and the scalar tail
+  a[3] = objs->max;
+  b[3] = objs->one;
+  a[9] = objs->zero;
+  b[9] = objs->one;
+  b[10] = a[10];
+  b[11] = a[11];
+  b[11].data[0] ^= 1U;
+  a[35] = objs->max;
+  b[35] = objs->one;
+
+  // every length up to N exercises each split between blocks and tail
+  for (size_t n = 0; n <= N; n++) {
+    uint256_add_n(sum, a, b, n);
+    uint256_sub_n(diff, a, b, n);
+    uint256_cmp_n(cmp, a, b, n);
+    for (size_t k = 0; k < n; k++) {
+      ASSERT_SAME(uint256_add(a[k], b[k]), sum[k]);
+      ASSERT_SAME(uint256_sub(a[k], b[k]), diff[k]);
+      int expected = 0;
+      for (int i = 7; i >= 0 && expected == 0; i--) {
+        if (a[k].data[i] != b[k].data[i]) {
+          expected = a[k].data[i] > b[k].data[i] ? 1 : -1;
+        }
+      }
+      ASSERT(expected == cmp[k]);
+    }
+  }
+  ASSERT_SAME(objs->zero, sum[3]);
+  ASSERT_SAME(objs->max, diff[9]);
+  ASSERT(0 == cmp[10]);
+
+  // dst aliasing an operand
+  UInt256 acc[N];
+  memcpy(acc, a, sizeof(acc));
+  uint256_add_n(acc, acc, b, N);
+  uint256_sub_n(acc, acc, b, N);
+  for (size_t k = 0; k < N; k++) {
+    ASSERT_SAME(a[k], acc[k]);
+  }
+
+  // structure-of-arrays form
+  UInt256Vec va, vb, vr;
+  ASSERT(uint256_vec_init(&va, N));
+  ASSERT(uint256_vec_init(&vb, N));
+  ASSERT(uint256_vec_init(&vr, N));
+  uint256_vec_load(&va, a);
+  uint256_vec_load(&vb, b);
+
+  UInt256 out[N];
+  uint256_vec_store(&va, out);
+  for (size_t k = 0; k < N; k++) {
+    ASSERT_SAME(a[k], out[k]);
+  }
+
+  uint256_vec_add(&vr, &va, &vb);
+  uint256_vec_store(&vr, out);
+  for (size_t k = 0; k < N; k++) {
+    ASSERT_SAME(sum[k], out[k]);
+  }
+
+  uint256_vec_sub(&vr, &va, &vb);
+  uint256_vec_store(&vr, out);
+  for (size_t k = 0; k < N; k++) {
+    ASSERT_SAME(diff[k], out[k]);
+  }
+
+  int vcmp[N];
+  uint256_vec_cmp(vcmp, &va, &vb);
+  for (size_t k = 0; k < N; k++) {
+    ASSERT(cmp[k] == vcmp[k]);
+  }
+
+  uint256_vec_cleanup(&va);
+  uint256_vec_cleanup(&vb);
+  uint256_vec_cleanup(&vr);
+}
+
+void test_dispatch_backends(TestObjs *objs) {
+  enum { N = 24 };
+  UInt256 a[N], b[N];
+  UInt256 sum[N], diff[N], prod[N], shl[N];
+
+  fill_pseudo_random(a, N, 3U);
+  fill_pseudo_random(b, N, 4U);
+  a[0] = objs->max;
+  b[0] = objs->max;
+  a[1] = objs->zero;
+  b[1] = objs->one;
+  a[2] = objs->msb_set;
+  b[2] = objs->msb_set;
+
+  // the generic backend is always available and gives the reference
+  ASSERT(uint256_backend_supported(UINT256_BACKEND_GENERIC));
+  ASSERT(uint256_set_backend(UINT256_BACKEND_GENERIC));
+  ASSERT(uint256_get_backend() == UINT256_BACKEND_GENERIC);
+  for (int k = 0; k < N; k++) {
+    sum[k] = uint256_add(a[k], b[k]);
+    diff[k] = uint256_sub(a[k], b[k]);
+    prod[k] = uint256_mul(a[k], b[k]);
+    shl[k] = uint256_lshift(a[k], (unsigned)(k * 11) % 256);
+  }
+  // (2^256-1)^2 == 1 (mod 2^256)
+  ASSERT_SAME(objs->one, prod[0]);
+
+  for (int be = 0; be < UINT256_NUM_BACKENDS; be++) {
+    UInt256Backend backend = (UInt256Backend)be;
+    if (!uint256_backend_supported(backend)) {
+      ASSERT(!uint256_set_backend(backend));
+      continue;
+    }
+    ASSERT(uint256_set_backend(backend));
+    ASSERT(uint256_get_backend() == backend);
+    for (int k = 0; k < N; k++) {
+      ASSERT_SAME(sum[k], uint256_add(a[k], b[k]));
+      ASSERT_SAME(diff[k], uint256_sub(a[k], b[k]));
+      ASSERT_SAME(prod[k], uint256_mul(a[k], b[k]));
+      ASSERT_SAME(shl[k], uint256_lshift(a[k], (unsigned)(k * 11) % 256));
+
+      // in-place forms, with the result aliasing an operand
+      UInt256 r = a[k];
+      uint256_mul_to(&r, &r, &b[k]);
+      ASSERT_SAME(prod[k], r);
+      r = b[k];
+      uint256_sub_to(&r, &a[k], &r);
+      ASSERT_SAME(diff[k], r);
+      r = a[k];
+      uint256_lshift_to(&r, &r, (unsigned)(k * 11) % 256);
+      ASSERT_SAME(shl[k], r);
+    }
+    for (unsigned shift = 0; shift < 600; shift += 63) {
+      UInt256 expected;
+      uint256_set_backend(UINT256_BACKEND_GENERIC);
+      expected = uint256_lshift(objs->max, shift);
+      uint256_set_backend(backend);
+      ASSERT_SAME(expected, uint256_lshift(objs->max, shift));
+    }
+  }
+
+  ASSERT(0 == strcmp("generic",
+                     uint256_backend_name(UINT256_BACKEND_GENERIC)));
+
+  // back to the automatic choice for any tests that follow
+  uint256_dispatch_init();
+}
+
+void test_rshift(TestObjs *objs) {
+  UInt256 result;
+
+  result = uint256_rshift(objs->one, 0);
+  ASSERT_SAME(objs->one, result);
+  result = uint256_rshift(objs->one, 1);
+  ASSERT_SAME(objs->zero, result);
+  result = uint256_rshift(objs->msb_set, 255);
+  ASSERT_SAME(objs->one, result);
+  result = uint256_rshift(objs->max, 255);
+  ASSERT_SAME(objs->one, result);
+
+  // shifts by 31 and 32 land just inside and exactly on a limb boundary
+  result = uint256_rshift(objs->max, 31);
+  for (int i = 0; i < 7; i++) {
+    ASSERT(result.data[i] == 0xFFFFFFFFU);
+  }
+  ASSERT(result.data[7] == 0x00000001U);
+  result = uint256_rshift(objs->max, 32);
+  for (int i = 0; i < 7; i++) {
+    ASSERT(result.data[i] == 0xFFFFFFFFU);
+  }
+  ASSERT(result.data[7] == 0U);
+
+  // every shift undoes the matching lshift of the top bit
+  for (unsigned shift = 0; shift < 256; shift++) {
+    result = uint256_rshift(objs->msb_set, shift);
+    ASSERT_SAME(objs->msb_set, uint256_lshift(result, shift));
+    ASSERT(uint256_popcount(result) == 1U);
+  }
+
+  // objs->pattern right by 50 bit(s)
+  UInt256 val = objs->pattern;
+  uint32_t expected_arr[8] = {0x8a0c0a13U, 0xe3468b22U, 0xfa31f6c6U,
+                              0x4496d148U, 0xfd7f8973U, 0xd9f41f33U,
+                              0x00001c9dU, 0x00000000U};
+  UInt256 expected;
+  INIT_FROM_ARR(expected, expected_arr);
+  result = uint256_rshift(val, 50U);
+  ASSERT_SAME(expected, result);
+  result = uint256_rshift(val, 255U);
+  ASSERT_SAME(objs->zero, result);
+}
+
+void test_rotate(TestObjs *objs) {
+  UInt256 val = objs->pattern;
+
+  uint32_t rotl50_arr[8] = {0x9f41f33fU, 0xce95c9ddU, 0xcaee1cb0U,
+                            0xa0c0a135U, 0x3468b228U, 0xa31f6c6eU,
+                            0x496d148fU, 0xd7f89734U};
+  uint32_t rotl100_arr[8] = {0x5cd125b4U, 0xccff5fe2U, 0x27767d07U,
+                             0x72c33a57U, 0x84d72bb8U, 0xc8a28302U,
+                             0xb1b8d1a2U, 0x523e8c7dU};
+  uint32_t rotr100_arr[8] = {0x7db1b8d1U, 0xb4523e8cU, 0xe25cd125U,
+                             0x07ccff5fU, 0x5727767dU, 0xb872c33aU,
+                             0x0284d72bU, 0xa2c8a283U};
+  UInt256 rotl50, rotl100, rotr100;
+  INIT_FROM_ARR(rotl50, rotl50_arr);
+  INIT_FROM_ARR(rotl100, rotl100_arr);
+  INIT_FROM_ARR(rotr100, rotr100_arr);
+
+  ASSERT_SAME(rotl50, uint256_rotl(val, 50U));
+  ASSERT_SAME(rotl100, uint256_rotl(val, 100U));
+  ASSERT_SAME(rotr100, uint256_rotr(val, 100U));
+  // only the shift mod 256 matters
+  ASSERT_SAME(val, uint256_rotl(val, 0U));
+  ASSERT_SAME(val, uint256_rotr(val, 0U));
+  ASSERT_SAME(val, uint256_rotl(val, 256U));
+  ASSERT_SAME(val, uint256_rotr(val, 256U));
+  ASSERT_SAME(val, uint256_rotr(val, 512U));
+  ASSERT_SAME(rotl100, uint256_rotl(val, 356U));
+  ASSERT_SAME(rotl100, uint256_rotr(val, 156U));
+  ASSERT_SAME(rotr100, uint256_rotr(val, 100U + 256U * 3U));
+
+  ASSERT_SAME(objs->one, uint256_rotl(objs->msb_set, 1U));
+  ASSERT_SAME(objs->msb_set, uint256_rotr(objs->one, 1U));
+  for (unsigned shift = 0; shift < 600; shift += 7) {
+    ASSERT_SAME(val, uint256_rotr(uint256_rotl(val, shift), shift));
+  }
+}
+
+void test_bitwise_ops(TestObjs *objs) {
+  uint32_t b_arr[8] = {0xffff0000U, 0x0000ffffU, 0x12345678U, 0x9abcdef0U,
+                       0x00000000U, 0xffffffffU, 0x0f0f0f0fU, 0x80000001U};
+  UInt256 a = objs->pattern, b;
+  INIT_FROM_ARR(b, b_arr);
+
+  UInt256 r_and = uint256_and(a, b);
+  UInt256 r_or = uint256_or(a, b);
+  UInt256 r_xor = uint256_xor(a, b);
+  UInt256 r_not = uint256_not(a);
+  for (int i = 0; i < 8; i++) {
+    ASSERT(r_and.data[i] == (a.data[i] & b_arr[i]));
+    ASSERT(r_or.data[i] == (a.data[i] | b_arr[i]));
+    ASSERT(r_xor.data[i] == (a.data[i] ^ b_arr[i]));
+    ASSERT(r_not.data[i] == ~a.data[i]);
+  }
+
+  ASSERT_SAME(objs->max, uint256_not(objs->zero));
+  ASSERT_SAME(objs->zero, uint256_xor(a, a));
+  ASSERT_SAME(a, uint256_and(a, objs->max));
+  ASSERT_SAME(objs->max, uint256_or(a, uint256_not(a)));
+  // ~x == -x - 1
+  ASSERT_SAME(uint256_not(a), uint256_sub(uint256_negate(a), objs->one));
+}
+
+void test_cmp(TestObjs *objs) {
+  ASSERT(uint256_cmp(objs->zero, objs->zero) == 0);
+  ASSERT(uint256_cmp(objs->zero, objs->one) == -1);
+  ASSERT(uint256_cmp(objs->one, objs->zero) == 1);
+  ASSERT(uint256_cmp(objs->max, objs->msb_set) == 1);
+  ASSERT(uint256_cmp(objs->msb_set, objs->max) == -1);
+  ASSERT(uint256_cmp(objs->max, objs->max) == 0);
+
+  // values that differ only in the lowest limb
+  UInt256 a = objs->msb_set, b = objs->msb_set;
+  a.data[0] = 2U;
+  b.data[0] = 1U;
+  ASSERT(uint256_cmp(a, b) == 1);
+  ASSERT(uint256_cmp(b, a) == -1);
+  // a higher limb outweighs the low one
+  b.data[6] = 1U;
+  ASSERT(uint256_cmp(a, b) == -1);
+
+  ASSERT(uint256_is_zero(objs->zero));
+  ASSERT(!uint256_is_zero(objs->one));
+  ASSERT(!uint256_is_zero(objs->msb_set));
+
+  enum { N = 16 };
+  UInt256 vals[N];
+  fill_pseudo_random(vals, N, 5U);
+  vals[7] = vals[6];
+  vals[8] = vals[6];
+  vals[8].data[3] ^= 1U;
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      // the most significant limb that differs decides
+      int expected = 0;
+      for (int k = 7; k >= 0 && expected == 0; k--) {
+        if (vals[i].data[k] != vals[j].data[k]) {
+          expected = vals[i].data[k] > vals[j].data[k] ? 1 : -1;
+        }
+      }
+      ASSERT(uint256_cmp(vals[i], vals[j]) == expected);
+    }
+  }
+}
+
+void test_bit_scan(TestObjs *objs) {
+  ASSERT(uint256_popcount(objs->zero) == 0U);
+  ASSERT(uint256_popcount(objs->one) == 1U);
+  ASSERT(uint256_popcount(objs->max) == 256U);
+
+  ASSERT(uint256_clz(objs->zero) == 256U);
+  ASSERT(uint256_ctz(objs->zero) == 256U);
+  ASSERT(uint256_bit_length(objs->zero) == 0U);
+  ASSERT(uint256_clz(objs->one) == 255U);
+  ASSERT(uint256_ctz(objs->one) == 0U);
+  ASSERT(uint256_bit_length(objs->one) == 1U);
+  ASSERT(uint256_clz(objs->msb_set) == 0U);
+  ASSERT(uint256_ctz(objs->msb_set) == 255U);
+  ASSERT(uint256_bit_length(objs->max) == 256U);
+
+  for (unsigned i = 0; i < 256; i++) {
+    UInt256 bit = uint256_lshift(objs->one, i);
+    ASSERT(uint256_clz(bit) == 255U - i);
+    ASSERT(uint256_ctz(bit) == i);
+    ASSERT(uint256_bit_length(bit) == i + 1U);
+    // setting every bit below doesn't change the bit length
+    UInt256 ones = uint256_or(bit, uint256_sub(bit, objs->one));
+    ASSERT(uint256_bit_length(ones) == i + 1U);
+    ASSERT(uint256_popcount(ones) == i + 1U);
+    ASSERT(uint256_ctz(ones) == 0U);
+  }
+
+  UInt256 val = objs->pattern;
+  ASSERT(uint256_popcount(val) == 130U);
+  ASSERT(uint256_bit_length(val) == 255U);
+  ASSERT(uint256_ctz(uint256_lshift(val, 77U)) == 77U);
+
+  // hex formatting sizes its output from the bit length
+  char buf[UINT256_HEX_BUFSIZE];
+  ASSERT(1U == uint256_format_as_hex_into(objs->zero, buf, sizeof(buf)));
+  ASSERT(0 == strcmp("0", buf));
+  ASSERT(64U == uint256_format_as_hex_into(objs->max, buf, sizeof(buf)));
+  ASSERT(1U == uint256_format_as_hex_into(objs->one, buf, sizeof(buf)));
+  ASSERT(64U == uint256_format_as_hex_into(objs->msb_set, buf, sizeof(buf)));
+  // 4 bits still fit one digit, 5 need two
+  UInt256 val4 = uint256_rshift(objs->msb_set, 252);
+  ASSERT(1U == uint256_format_as_hex_into(val4, buf, sizeof(buf)));
+  ASSERT(0 == strcmp("8", buf));
+  ASSERT(2U == uint256_format_as_hex_into(uint256_lshift(val4, 1), buf,
+                                          sizeof(buf)));
+  ASSERT(0 == strcmp("10", buf));
+}
+
+void test_gcd(TestObjs *objs) {
+  UInt256 (*const gcds[2])(UInt256, UInt256) = {uint256_gcd,
+                                                uint256_gcd_lehmer};
+  for (int k = 0; k < 2; k++) {
+    UInt256 (*gcd)(UInt256, UInt256) = gcds[k];
+    ASSERT_SAME(objs->zero, gcd(objs->zero, objs->zero));
+    ASSERT_SAME(objs->max, gcd(objs->zero, objs->max));
+    ASSERT_SAME(objs->max, gcd(objs->max, objs->zero));
+    ASSERT_SAME(objs->max, gcd(objs->max, objs->max));
+    ASSERT_SAME(objs->one, gcd(objs->max, objs->msb_set));
+    ASSERT_SAME(objs->one, gcd(objs->big_a, objs->big_b));
+    // 2^255 and 3*2^254 share a factor of 2^254
+    UInt256 three_254 = uint256_create_from_hex(
+        "c000000000000000000000000000000000000000000000000000000000000000");
+    ASSERT_SAME(uint256_rshift(objs->msb_set, 1),
+                gcd(objs->msb_set, three_254));
+
+    // big_a and big_b rounded down to multiples of 0xc0ffee1234567
+    UInt256 a = uint256_create_from_hex(
+        "fedcba98765432100123456789abcdefdeadbeefcafebabe0ba4385b58e0cd1b");
+    UInt256 b = uint256_create_from_hex(
+        "1234567890abcdeffedcba0987654321aaaaaaaa55555555fffb777a84705e93");
+    UInt256 expected = uint256_create_from_hex("c0ffee1234567");
+    ASSERT_SAME(expected, gcd(a, b));
+    ASSERT_SAME(expected, gcd(b, a));
+  }
+
+  // the two algorithms agree, and the result divides both operands
+  enum { N = 32 };
+  UInt256 a[N], b[N];
+  fill_pseudo_random(a, N, 7U);
+  fill_pseudo_random(b, N, 8U);
+  for (int i = 0; i < N; i++) {
+    // give half of the pairs a common factor
+    if (i % 2) {
+      a[i] = uint256_mul(uint256_rshift(a[i], 96), b[i]);
+      b[i] = uint256_mul(uint256_rshift(b[i], 160), b[i]);
+    }
+    UInt256 g = uint256_gcd(a[i], b[i]);
+    ASSERT_SAME(g, uint256_gcd_lehmer(a[i], b[i]));
+    UInt256 rem;
+    uint256_divmod(a[i], g, NULL, &rem);
+    ASSERT_SAME(objs->zero, rem);
+    uint256_divmod(b[i], g, NULL, &rem);
+    ASSERT_SAME(objs->zero, rem);
+  }
+}
+
+void test_modinv(TestObjs *objs) {
+  UInt256 inv, expected;
+
+  ASSERT(uint256_modinv(objs->big_a, objs->big_b, &inv));
+  expected = uint256_create_from_hex(
+      "10f68192803f1fa9f0e54d583032233969688e544c1a7f16acaf068ca31c2750");
+  ASSERT_SAME(expected, inv);
+  ASSERT(uint256_modinv(objs->pattern, objs->big_b, &inv));
+  expected = uint256_create_from_hex(
+      "107ce5a43d4ea6bc83f8aed0a62796d9e794a9f5372a213b024f2843d682aec9");
+  ASSERT_SAME(expected, inv);
+
+  // even modulus: b * b^-1 == 1 mod 2^255
+  ASSERT(uint256_modinv(objs->big_b, objs->msb_set, &inv));
+  expected = uint256_create_from_hex(
+      "7d91428aa2e87d829d036a5e06d3a06caaaaaaaaaaaaaaab0000000100000001");
+  ASSERT_SAME(expected, inv);
+  UInt256 prod = uint256_mul(objs->big_b, inv);
+  prod.data[7] &= 0x7fffffffU;
+  ASSERT_SAME(objs->one, prod);
+
+  // inverses in the named prime fields
+  const UInt256Field *fields[3] = {&uint256_field_secp256k1,
+                                   &uint256_field_p256, &uint256_field_p25519};
+  for (int i = 0; i < 3; i++) {
+    const UInt256Field *f = fields[i];
+    ASSERT(uint256_modinv(objs->big_a, f->modulus, &inv));
+    ASSERT(uint256_cmp(inv, f->modulus) < 0);
+    ASSERT_SAME(objs->one, uint256_field_mul(f, objs->big_a, inv));
+    // p - 1 is its own inverse
+    UInt256 p_minus_one = uint256_sub(f->modulus, objs->one);
+    ASSERT(uint256_modinv(p_minus_one, f->modulus, &inv));
+    ASSERT_SAME(p_minus_one, inv);
+  }
+
+  // no inverse: a common factor, a multiple of m, or m == 0
+  inv = objs->one;
+  ASSERT(!uint256_modinv(uint256_create_from_u32(6U),
+                         uint256_create_from_u32(9U), &inv));
+  ASSERT_SAME(objs->zero, inv);
+  inv = objs->one;
+  ASSERT(!uint256_modinv(objs->max, uint256_create_from_u32(5U), &inv));
+  ASSERT_SAME(objs->zero, inv);
+  inv = objs->one;
+  ASSERT(!uint256_modinv(objs->one, objs->zero, &inv));
+  ASSERT_SAME(objs->zero, inv);
+
+  // everything is invertible mod 1, and the only residue is 0
+  inv = objs->one;
+  ASSERT(uint256_modinv(objs->big_a, objs->one, &inv));
+  ASSERT_SAME(objs->zero, inv);
+  ASSERT(uint256_modinv(objs->one, objs->max, &inv));
+  ASSERT_SAME(objs->one, inv);
+}
+
+void test_barrett(TestObjs *objs) {
+  UInt256BarrettCtx ctx;
+  ASSERT(!uint256_barrett_init(&ctx, objs->zero));
+
+  // odd, even with the top bit set, small even, and even with low zero
+  // bits; expected values of (big_a*2^256 + big_b) mod m,
+  // big_a*pattern mod m and max*max mod m
+  const char *moduli[4] = {
+      "1234567890abcdeffedcba0987654321aaaaaaaa55555555ffffffff00000001",
+      "fedcba98765432100123456789abcdefdeadbeefcafebabe0badf00d8badf00c",
+      "3b9aca06",
+      "727767d07ccff5fe25cd125b4523e8c7db1b8d1a2c8a2830284d72bb872c3300"};
+  const char *reduced[4] = {
+      "f686d664f472624ef4d04ba7d531e8e79c559ad12bb33150ff76587df7eb484",
+      "13579be01a579bdffdb974a1fdb97531cbfcebba8a569a97f4520ff174520ff5",
+      "1612df55",
+      "b6a26f0762ffc6007e8cb0dc65c3e7cfcb447ab635b75b3e0e71a62bc62cc01"};
+  const char *products[4] = {
+      "ed48e578e485314bda8f4cd27bcd4718167a62c686fb2d18cf14458148c8b2a",
+      "727767d07ccff5fe25cd125b4523e8c7db1b8d1a2c8a2830284d72bb872c33a5",
+      "107936a9",
+      "2b16706156229cf88abe6ae39d410517697cc807fc1ebf73c0143de43ebe9b61"};
+  const char *max_sqr[4] = {
+      "57eac743dddac70b49838d5c8ad40378bf9981528b582ce28010be8638d5776",
+      "34236d82909096c828df7cb272983e21175a66239bcf6e9b50519aad74b3e629",
+      "232e5df5",
+      "41f87f5739ce88a927dec8f8eea1cb5b7760f1c05023fbe7a37e0225e5078201"};
+
+  enum { N = 16 };
+  UInt256 vals[N];
+  fill_pseudo_random(vals, N, 9U);
+  for (int i = 0; i < 4; i++) {
+    UInt256 m = uint256_create_from_hex(moduli[i]);
+    ASSERT(uint256_barrett_init(&ctx, m));
+    UInt256 expected = uint256_create_from_hex(reduced[i]);
+    UInt256 result = uint256_barrett_reduce(&ctx, objs->big_a, objs->big_b);
+    ASSERT_SAME(expected, result);
+    expected = uint256_create_from_hex(products[i]);
+    result = uint256_barrett_mulmod(&ctx, objs->big_a, objs->pattern);
+    ASSERT_SAME(expected, result);
+    expected = uint256_create_from_hex(max_sqr[i]);
+    result = uint256_barrett_mulmod(&ctx, objs->max, objs->max);
+    ASSERT_SAME(expected, result);
+
+    // a 256-bit value reduces to the same remainder as divmod gives
+    for (int j = 0; j < N; j++) {
+      UInt256 rem;
+      uint256_divmod(vals[j], m, NULL, &rem);
+      result = uint256_barrett_reduce(&ctx, objs->zero, vals[j]);
+      ASSERT_SAME(rem, result);
+    }
+    // m itself, m - 1 and m*2^256 - 1
+    UInt256 m_minus_one = uint256_sub(m, objs->one);
+    ASSERT_SAME(objs->zero, uint256_barrett_reduce(&ctx, objs->zero, m));
+    ASSERT_SAME(m_minus_one,
+                uint256_barrett_reduce(&ctx, objs->zero, m_minus_one));
+    ASSERT_SAME(m_minus_one,
+                uint256_barrett_reduce(&ctx, m_minus_one, objs->max));
+  }
+
+  // agrees with the special-form reduction for 2^255 - 19
+  const UInt256Field *f = &uint256_field_p25519;
+  ASSERT(uint256_barrett_init(&ctx, f->modulus));
+  for (int j = 0; j + 1 < N; j++) {
+    UInt256 expected = uint256_field_mul(f, vals[j], vals[j + 1]);
+    UInt256 result = uint256_barrett_mulmod(&ctx, vals[j], vals[j + 1]);
+    ASSERT_SAME(expected, result);
+  }
+
+  // powers of two and 1
+  ASSERT(uint256_barrett_init(&ctx, objs->msb_set));
+  UInt256 expected = objs->big_a;
+  expected.data[7] &= 0x7fffffffU;
+  ASSERT_SAME(expected,
+              uint256_barrett_reduce(&ctx, objs->big_b, objs->big_a));
+  ASSERT(uint256_barrett_init(&ctx, objs->one));
+  ASSERT_SAME(objs->zero, uint256_barrett_mulmod(&ctx, objs->max, objs->max));
+}
+
+void test_mont_pow_window(TestObjs *objs) {
+  // secp256k1 field prime
+  UInt256 p = uint256_create_from_hex(
+      "fffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f");
+  UInt256MontCtx ctx;
+  ASSERT(uint256_mont_init(&ctx, p));
+  UInt256 am = uint256_mont_to(&ctx, objs->big_a);
+  UInt256 p_minus_one = uint256_sub(p, objs->one);
+
+  // big_a^pattern, big_a^max and big_a^65537 mod p
+  UInt256 exps[3] = {objs->pattern, objs->max,
+                     uint256_create_from_u32(65537U)};
+  const char *expected_hex[3] = {
+      "582a89fd0f3dd7cfa11aa5a04eb7d54c5ccf0ba5e20611f7a9e5509e2eebb628",
+      "13c11392f061d5046c3ed3d122dfb57881061f2bf33c5ccc73aa44ee0667bbc3",
+      "51d20aed08708a531882ba8c0f1ae93d17e2315605ac319046644e99ff5d92d7"};
+
+  for (unsigned w = 1; w <= UINT256_MONT_MAX_WINDOW; w++) {
+    for (int i = 0; i < 3; i++) {
+      UInt256 expected = uint256_create_from_hex(expected_hex[i]);
+      UInt256 result = uint256_mont_from(
+          &ctx, uint256_mont_pow_window(&ctx, am, exps[i], w));
+      ASSERT_SAME(expected, result);
+    }
+    // Fermat, x^0 == 1, x^1 == x, and powers of 2 as exponents (a
+    // single digit followed by nothing but squarings)
+    UInt256 result = uint256_mont_pow_window(&ctx, am, p_minus_one, w);
+    ASSERT_SAME(ctx.one, result);
+    result = uint256_mont_pow_window(&ctx, am, objs->zero, w);
+    ASSERT_SAME(ctx.one, result);
+    result = uint256_mont_pow_window(&ctx, am, objs->one, w);
+    ASSERT_SAME(am, result);
+    UInt256 sq = am;
+    for (unsigned k = 1; k < 8; k++) {
+      sq = uint256_mont_mul(&ctx, sq, sq);
+      result = uint256_mont_pow_window(&ctx, am,
+                                       uint256_lshift(objs->one, k), w);
+      ASSERT_SAME(sq, result);
+    }
+  }
+
+  // uint256_mont_pow agrees, also for an even exponent and modulus 1
+  ASSERT_SAME(uint256_mont_pow_window(&ctx, am, objs->big_b, 1),
+              uint256_mont_pow(&ctx, am, objs->big_b));
+  ASSERT(uint256_mont_init(&ctx, objs->one));
+  ASSERT_SAME(objs->zero, uint256_mont_pow(&ctx, objs->zero, objs->max));
+
+  // an odd, non-prime modulus: big_a^pattern mod big_b
+  ASSERT(uint256_mont_init(&ctx, objs->big_b));
+  am = uint256_mont_to(&ctx, objs->big_a);
+  UInt256 expected = uint256_create_from_hex(
+      "c537b5562616e62641e6383292662f5a189d1c0a393b6c643d4970baf33d925");
+  UInt256 result =
+      uint256_mont_from(&ctx, uint256_mont_pow(&ctx, am, objs->pattern));
+  ASSERT_SAME(expected, result);
+}
+
+void test_mont_fixed_base(TestObjs *objs) {
+  UInt256 p = uint256_create_from_hex(
+      "fffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f");
+  UInt256MontCtx ctx;
+  ASSERT(uint256_mont_init(&ctx, p));
+  UInt256 am = uint256_mont_to(&ctx, objs->big_a);
+
+  enum { N = 8 };
+  UInt256 exps[N];
+  fill_pseudo_random(exps, N, 11U);
+  exps[0] = objs->zero;
+  exps[1] = objs->one;
+  exps[2] = objs->max;
+  exps[3] = objs->msb_set;
+
+  for (unsigned w = 1; w <= UINT256_MONT_MAX_WINDOW; w++) {
+    UInt256MontFixedBase fb;
+    ASSERT(uint256_mont_fixed_base_init(&fb, &ctx, am, w));
+    ASSERT(fb.digits * w >= 256U);
+    UInt256 expected = uint256_create_from_hex(
+        "582a89fd0f3dd7cfa11aa5a04eb7d54c5ccf0ba5e20611f7a9e5509e2eebb628");
+    ASSERT_SAME(expected,
+                uint256_mont_from(&ctx, uint256_mont_fixed_base_pow(
+                                            &fb, objs->pattern)));
+    for (int i = 0; i < N; i++) {
+      expected = uint256_mont_pow(&ctx, am, exps[i]);
+      ASSERT_SAME(expected, uint256_mont_fixed_base_pow(&fb, exps[i]));
+    }
+    uint256_mont_fixed_base_free(&fb);
+    ASSERT(fb.table == NULL);
+  }
+}
+
+void test_load_store_bytes(TestObjs *objs) {
+  // big_a as big-endian bytes, the same digits as its hex string
+  static const uint8_t be[32] = {
+      0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10, 0x01, 0x23, 0x45,
+      0x67, 0x89, 0xab, 0xcd, 0xef, 0xde, 0xad, 0xbe, 0xef, 0xca, 0xfe,
+      0xba, 0xbe, 0x0b, 0xad, 0xf0, 0x0d, 0x8b, 0xad, 0xf0, 0x0d};
+  uint8_t le[32];
+  for (int i = 0; i < 32; i++) {
+    le[i] = be[31 - i];
+  }
+
+  UInt256 val = uint256_load_be(be);
+  ASSERT_SAME(objs->big_a, val);
+  val = uint256_load_le(le);
+  ASSERT_SAME(objs->big_a, val);
+
+  uint8_t buf[33];
+  buf[32] = 0x5a; // must not be touched
+  uint256_store_be(buf, objs->big_a);
+  ASSERT(memcmp(buf, be, 32) == 0);
+  uint256_store_le(buf, objs->big_a);
+  ASSERT(memcmp(buf, le, 32) == 0);
+  ASSERT(buf[32] == 0x5a);
+
+  // unaligned buffers and the edge values round-trip
+  UInt256 vals[4] = {objs->zero, objs->one, objs->max, objs->msb_set};
+  for (int i = 0; i < 4; i++) {
+    uint256_store_be(buf + 1, vals[i]);
+    val = uint256_load_be(buf + 1);
+    ASSERT_SAME(vals[i], val);
+    uint256_store_le(buf + 1, vals[i]);
+    val = uint256_load_le(buf + 1);
+    ASSERT_SAME(vals[i], val);
+  }
+  uint256_store_be(buf, objs->one);
+  ASSERT(buf[31] == 1 && buf[0] == 0);
+  uint256_store_le(buf, objs->msb_set);
+  ASSERT(buf[31] == 0x80 && buf[0] == 0);
+}
+
+void test_load_store_bytes_n(TestObjs *objs) {
+  (void)objs;
+  // a column of 32-byte fields at offset 3 of 45-byte records
+  enum { N = 19, STRIDE = 45, OFFSET = 3 };
+  static uint8_t records[N * STRIDE];
+  static uint8_t copy[N * STRIDE];
+  UInt256 vals[N], loaded[N];
+  fill_pseudo_random(vals, N, 23U);
+  for (size_t k = 0; k < sizeof(records); k++) {
+    records[k] = (uint8_t)(k * 7 + 1);
+  }
+  memcpy(copy, records, sizeof(records));
+
+  uint256_store_be_n(records + OFFSET, STRIDE, vals, N);
+  for (int k = 0; k < N; k++) {
+    uint8_t *field = records + k * STRIDE + OFFSET;
+    UInt256 val = uint256_load_be(field);
+    ASSERT_SAME(vals[k], val);
+    // the bytes between fields are left alone
+    ASSERT(memcmp(records + k * STRIDE, copy + k * STRIDE, OFFSET) == 0);
+    ASSERT(memcmp(field + 32, copy + k * STRIDE + OFFSET + 32,
+                  STRIDE - OFFSET - 32) == 0);
+  }
+  uint256_load_be_n(loaded, records + OFFSET, STRIDE, N);
+  for (int k = 0; k < N; k++) {
+    ASSERT_SAME(vals[k], loaded[k]);
+  }
+
+  uint256_store_le_n(records + OFFSET, STRIDE, vals, N);
+  for (int k = 0; k < N; k++) {
+    UInt256 val = uint256_load_le(records + k * STRIDE + OFFSET);
+    ASSERT_SAME(vals[k], val);
+  }
+  uint256_load_le_n(loaded, records + OFFSET, STRIDE, N);
+  for (int k = 0; k < N; k++) {
+    ASSERT_SAME(vals[k], loaded[k]);
+  }
+
+  // a packed array (stride 32) in big-endian
+  uint8_t packed[N * 32];
+  uint256_store_be_n(packed, 32, vals, N);
+  uint256_load_be_n(loaded, packed, 32, N);
+  for (int k = 0; k < N; k++) {
+    ASSERT_SAME(vals[k], loaded[k]);
+    ASSERT(packed[k * 32 + 31] == (uint8_t)vals[k].data[0]);
+  }
+}
+
+void test_scalar_ops(TestObjs *objs) {
+  UInt256 result, expected;
+
+  result = uint256_mul_u32(objs->big_a, 0xdeadbeefU);
+  expected = uint256_create_from_hex(
+      "12345678ab8ff8ceedcba98738717133d2004e9c92f81ecef7d56506fe55c223");
+  ASSERT_SAME(expected, result);
+  result = uint256_mul_u32(objs->max, 0);
+  ASSERT_SAME(objs->zero, result);
+  result = uint256_mul_u32(objs->max, 1);
+  ASSERT_SAME(objs->max, result);
+  // 2^255 * 2 wraps to 0
+  result = uint256_mul_u32(objs->msb_set, 2);
+  ASSERT_SAME(objs->zero, result);
+
+  result = uint256_mul_add_u32(objs->big_a, 1000000000U, 999999999U);
+  expected = uint256_create_from_hex(
+      "8e38e38e3d64711c71c71c71bb1d453b38b20873225e122cc6c1cd2ce1d70bff");
+  ASSERT_SAME(expected, result);
+  result = uint256_mul_add_u32(objs->zero, 10, 7);
+  ASSERT(result.data[0] == 7U);
+
+  result = uint256_add_u64(objs->big_a, 0xfedcba9876543210ULL);
+  expected = uint256_create_from_hex(
+      "fedcba98765432100123456789abcdefdeadbeefcafebabf0a8aaaa60202221d");
+  ASSERT_SAME(expected, result);
+  // the carry ripples through every limb
+  result = uint256_add_u64(objs->max, 1);
+  ASSERT_SAME(objs->zero, result);
+  result = uint256_sub_u64(objs->big_a, 0xfedcba9876543210ULL);
+  expected = uint256_create_from_hex(
+      "fedcba98765432100123456789abcdefdeadbeefcafebabd0cd135751559bdfd");
+  ASSERT_SAME(expected, result);
+  result = uint256_sub_u64(objs->zero, 1);
+  ASSERT_SAME(objs->max, result);
+  result = uint256_sub_u64(objs->msb_set, 1);
+  expected = uint256_create_from_hex(
+      "7fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
+  ASSERT_SAME(expected, result);
+
+  ASSERT(uint256_cmp_u64(objs->zero, 0) == 0);
+  ASSERT(uint256_cmp_u64(objs->zero, 1) == -1);
+  ASSERT(uint256_cmp_u64(objs->one, 1) == 0);
+  ASSERT(uint256_cmp_u64(objs->one, 0) == 1);
+  ASSERT(uint256_cmp_u64(objs->max, UINT64_MAX) == 1);
+  ASSERT(uint256_cmp_u64(objs->msb_set, UINT64_MAX) == 1);
+  UInt256 val = objs->zero;
+  val.data[0] = 0x89abcdefU;
+  val.data[1] = 0x01234567U;
+  ASSERT(uint256_cmp_u64(val, 0x0123456789abcdefULL) == 0);
+  ASSERT(uint256_cmp_u64(val, 0x0123456789abcdf0ULL) == -1);
+  ASSERT(uint256_cmp_u64(val, 0x0123456689abcdefULL) == 1);
+
+  // agree with the general routines on random operands
+  enum { N = 32 };
+  UInt256 vals[N];
+  fill_pseudo_random(vals, N, 29U);
+  for (int i = 0; i + 1 < N; i++) {
+    uint32_t k = vals[i + 1].data[3];
+    uint64_t k64 = ((uint64_t)vals[i + 1].data[5] << 32) | vals[i + 1].data[6];
+    UInt256 kval = uint256_create_from_u32(k);
+    UInt256 k64val = kval;
+    k64val.data[0] = (uint32_t)k64;
+    k64val.data[1] = (uint32_t)(k64 >> 32);
+
+    expected = uint256_mul(vals[i], kval);
+    result = uint256_mul_u32(vals[i], k);
+    ASSERT_SAME(expected, result);
+    expected = uint256_add(vals[i], k64val);
+    result = uint256_add_u64(vals[i], k64);
+    ASSERT_SAME(expected, result);
+    expected = uint256_sub(vals[i], k64val);
+    result = uint256_sub_u64(vals[i], k64);
+    ASSERT_SAME(expected, result);
+    ASSERT(uint256_cmp_u64(vals[i], k64) == uint256_cmp(vals[i], k64val));
+    // the low two limbs alone, so the comparison is decided by them
+    UInt256 low = objs->zero;
+    low.data[0] = vals[i].data[0];
+    low.data[1] = vals[i].data[1];
+    ASSERT(uint256_cmp_u64(low, k64) == uint256_cmp(low, k64val));
+  }
+}
+
+void test_acc(TestObjs *objs) {
+  enum { N = 100 };
+  UInt256 vals[N];
+  fill_pseudo_random(vals, N, 31U);
+  vals[0] = objs->max;
+  vals[1] = objs->max;
+  vals[2] = objs->msb_set;
+
+  // reference: a chain of ordinary additions and subtractions
+  UInt256 sum = objs->zero, diff = objs->zero;
+  for (int i = 0; i < N; i++) {
+    sum = uint256_add(sum, vals[i]);
+    diff = i % 3 == 0 ? uint256_sub(diff, vals[i]) : uint256_add(diff, vals[i]);
+  }
+
+  UInt256Acc acc;
+  uint256_acc_init(&acc);
+  ASSERT_SAME(objs->zero, uint256_acc_get(&acc));
+  for (int i = 0; i < N; i++) {
+    uint256_acc_add(&acc, vals[i]);
+  }
+  ASSERT_SAME(sum, uint256_acc_get(&acc));
+  // reading doesn't disturb the accumulator
+  ASSERT_SAME(sum, uint256_acc_get(&acc));
+
+  uint256_acc_init(&acc);
+  for (int i = 0; i < N; i++) {
+    if (i % 3 == 0) {
+      uint256_acc_sub(&acc, vals[i]);
+    } else {
+      uint256_acc_add(&acc, vals[i]);
+    }
+  }
+  ASSERT_SAME(diff, uint256_acc_get(&acc));
+  uint256_acc_init(&acc);
+  uint256_acc_sub(&acc, objs->one);
+  ASSERT_SAME(objs->max, uint256_acc_get(&acc));
+
+  uint256_acc_init(&acc);
+  uint256_acc_add_n(&acc, vals, N);
+  ASSERT_SAME(sum, uint256_acc_get(&acc));
+  uint256_acc_add_n(&acc, vals, 0);
+  ASSERT_SAME(sum, uint256_acc_get(&acc));
+
+  // per-part accumulators merged in different orders
+  UInt256Acc parts[4], total;
+  for (int p = 0; p < 4; p++) {
+    uint256_acc_init(&parts[p]);
+    uint256_acc_add_n(&parts[p], vals + p * (N / 4), N / 4);
+  }
+  uint256_acc_init(&total);
+  for (int p = 3; p >= 0; p--) {
+    uint256_acc_merge(&total, &parts[p]);
+  }
+  ASSERT_SAME(sum, uint256_acc_get(&total));
+  uint256_acc_merge(&parts[0], &parts[1]);
+  uint256_acc_merge(&parts[2], &parts[3]);
+  uint256_acc_merge(&parts[0], &parts[2]);
+  ASSERT_SAME(sum, uint256_acc_get(&parts[0]));
+
+  // lanes full of deferred carries right up to the limit: the next
+  // additions must normalize first
+  uint256_acc_init(&acc);
+  for (int i = 0; i < 8; i++) {
+    acc.lanes[i] = 0xfffffffdffffffffULL;
+  }
+  acc.pending = UINT256_ACC_MAX_PENDING;
+  UInt256 start = uint256_acc_get(&acc);
+  uint256_acc_add_n(&acc, vals, N);
+  ASSERT(acc.pending == N);
+  ASSERT_SAME(uint256_add(start, sum), uint256_acc_get(&acc));
+  acc.pending = UINT256_ACC_MAX_PENDING;
+  uint256_acc_add(&acc, objs->one);
+  ASSERT(acc.pending == 1);
+  ASSERT_SAME(uint256_add(uint256_add(start, sum), objs->one),
+              uint256_acc_get(&acc));
+}
+
+void test_isqrt(TestObjs *objs) {
+  UInt256 result, expected;
+
+  result = uint256_isqrt(objs->zero);
+  ASSERT_SAME(objs->zero, result);
+  result = uint256_isqrt(objs->one);
+  ASSERT_SAME(objs->one, result);
+  result = uint256_isqrt(uint256_create_from_u32(15));
+  ASSERT(result.data[0] == 3U);
+  result = uint256_isqrt(uint256_create_from_u32(16));
+  ASSERT(result.data[0] == 4U);
+
+  result = uint256_isqrt(objs->big_a);
+  expected = uint256_create_from_hex("ff6e33c7bdd7c55837721f8a4199fd40");
+  ASSERT_SAME(expected, result);
+  result = uint256_isqrt(objs->max);
+  expected = uint256_create_from_hex("ffffffffffffffffffffffffffffffff");
+  ASSERT_SAME(expected, result);
+  result = uint256_isqrt(objs->msb_set);
+  expected = uint256_create_from_hex("b504f333f9de6484597d89b3754abe9f");
+  ASSERT_SAME(expected, result);
+
+  // exact squares and their neighbours, then floor semantics on random
+  // values of every size: r^2 <= val < (r+1)^2
+  enum { N = 64 };
+  UInt256 vals[N];
+  fill_pseudo_random(vals, N, 37U);
+  for (int i = 0; i < N; i++) {
+    UInt256 r = uint256_rshift(vals[i], 128 + (unsigned)i % 128);
+    UInt256 sq = uint256_mul(r, r);
+    result = uint256_isqrt(sq);
+    ASSERT_SAME(r, result);
+    if (!uint256_is_zero(r)) {
+      result = uint256_isqrt(uint256_sub(sq, objs->one));
+      ASSERT_SAME(uint256_sub(r, objs->one), result);
+    }
+
+    UInt256 v = uint256_rshift(vals[i], (unsigned)i * 4);
+    r = uint256_isqrt(v);
+    ASSERT(uint256_cmp(uint256_mul(r, r), v) <= 0);
+    UInt256 r1 = uint256_add(r, objs->one);
+    UInt256 hi, lo;
+    uint256_mul_wide(r1, r1, &hi, &lo);
+    ASSERT(!uint256_is_zero(hi) || uint256_cmp(lo, v) > 0);
+  }
+}
+
+void test_iroot(TestObjs *objs) {
+  UInt256 result, expected;
+
+  result = uint256_iroot(objs->big_a, 1);
+  ASSERT_SAME(objs->big_a, result);
+  result = uint256_iroot(objs->big_a, 2);
+  expected = uint256_isqrt(objs->big_a);
+  ASSERT_SAME(expected, result);
+  result = uint256_iroot(objs->big_a, 3);
+  expected = uint256_create_from_hex("2841f5b2998ff0eab0b03f");
+  ASSERT_SAME(expected, result);
+  result = uint256_iroot(objs->big_a, 5);
+  expected = uint256_create_from_hex("92e707a069a12");
+  ASSERT_SAME(expected, result);
+  result = uint256_iroot(objs->big_a, 17);
+  ASSERT(result.data[0] == 34122U);
+  result = uint256_iroot(objs->max, 3);
+  expected = uint256_create_from_hex("285145f31ae515c447bb56");
+  ASSERT_SAME(expected, result);
+  result = uint256_iroot(objs->max, 255);
+  ASSERT(result.data[0] == 2U);
+  result = uint256_iroot(objs->max, 256);
+  ASSERT_SAME(objs->one, result);
+  result = uint256_iroot(objs->msb_set, 255);
+  ASSERT(result.data[0] == 2U);
+  result = uint256_iroot(objs->zero, 7);
+  ASSERT_SAME(objs->zero, result);
+  result = uint256_iroot(objs->one, 1000);
+  ASSERT_SAME(objs->one, result);
+  // 3^40 is exact, and one less rounds down
+  UInt256 p = uint256_create_from_u32(1);
+  for (int i = 0; i < 40; i++) {
+    p = uint256_mul_u32(p, 3);
+  }
+  result = uint256_iroot(p, 40);
+  ASSERT(result.data[0] == 3U);
+  result = uint256_iroot(uint256_sub(p, objs->one), 40);
+  ASSERT(result.data[0] == 2U);
+
+  // floor semantics for a range of n: r^n <= val < (r+1)^n
+  enum { N = 16 };
+  UInt256 vals[N];
+  fill_pseudo_random(vals, N, 41U);
+  for (unsigned n = 3; n < 40; n += 3) {
+    for (int i = 0; i < N; i++) {
+      UInt256 r = uint256_iroot(vals[i], n);
+      UInt256 pw = uint256_create_from_u32(1), pw1 = pw;
+      UInt256 r1 = uint256_add(r, objs->one);
+      int over = 0;
+      for (unsigned k = 0; k < n; k++) {
+        pw = uint256_mul(pw, r);
+        UInt256 hi;
+        uint256_mul_wide(pw1, r1, &hi, &pw1);
+        over |= !uint256_is_zero(hi);
+      }
+      ASSERT(uint256_cmp(pw, vals[i]) <= 0);
+      ASSERT(over || uint256_cmp(pw1, vals[i]) > 0);
+    }
+  }
+}
+
+void test_rng(TestObjs *objs) {
+  (void)objs;
+  UInt256Rng rng, rng2;
+  UInt256 val, expected;
+
+  // fixed outputs for seed 42 (Philox4x32-10 checked against the
+  // Random123 known-answer vectors)
+  uint256_rng_init(&rng, 42);
+  val = uint256_rng_next(&rng);
+  expected = uint256_create_from_hex(
+      "df4e0532e090b72c6cb336dacd97eaa9814f552f63ab0e521c99eeecab6ad131");
+  ASSERT_SAME(expected, val);
+  ASSERT(rng.counter == 1);
+  for (int i = 1; i < 5; i++) {
+    uint256_rng_next(&rng);
+  }
+  val = uint256_rng_next(&rng);
+  expected = uint256_create_from_hex(
+      "d1ae1afa815071b2817d3ef78e609ff6ee6d06c0cc6d2e3ec328128e15da0ae3");
+  ASSERT_SAME(expected, val);
+
+  // fill, fill_at and next give the same stream, for lengths that
+  // cover whole groups of four and a tail
+  enum { N = 23 };
+  UInt256 seq[N], filled[N], part[N];
+  uint256_rng_init(&rng, 7);
+  for (int i = 0; i < N; i++) {
+    seq[i] = uint256_rng_next(&rng);
+  }
+  uint256_rng_init(&rng2, 7);
+  uint256_rng_fill(&rng2, filled, N);
+  ASSERT(rng2.counter == N);
+  for (int i = 0; i < N; i++) {
+    ASSERT_SAME(seq[i], filled[i]);
+  }
+  uint256_rng_fill_at(&rng2, part, 10, 13);
+  for (int i = 0; i < 10; i++) {
+    ASSERT_SAME(seq[13 + i], part[i]);
+  }
+
+  // a slice whose block numbers cross a 2^32 boundary
+  uint256_rng_init(&rng, 42);
+  uint256_rng_fill_at(&rng, part, 9, (1ULL << 31) - 5);
+  expected = uint256_create_from_hex(
+      "b32b74549fd54afd3e503dbc2048956581e14da321d591e64b0f39f3d15b0253");
+  ASSERT_SAME(expected, part[4]);
+  expected = uint256_create_from_hex(
+      "c2bdd2367ab44c84ae87d4e798b34b38e641df95992683867593e7b00b671054");
+  ASSERT_SAME(expected, part[6]);
+  rng.counter = (1ULL << 31) - 5;
+  for (int i = 0; i < 9; i++) {
+    val = uint256_rng_next(&rng);
+    ASSERT_SAME(part[i], val);
+  }
+
+  // split streams are fixed by the parent and index, and differ
+  uint256_rng_init(&rng, 42);
+  uint256_rng_split(&rng2, &rng, 3);
+  val = uint256_rng_next(&rng2);
+  expected = uint256_create_from_hex(
+      "680b7240419f066563491b54bc5f1cb40b89dc261ec892d77c38004a1741ce50");
+  ASSERT_SAME(expected, val);
+  UInt256Rng kids[4], grandkid;
+  UInt256 firsts[6];
+  for (int i = 0; i < 4; i++) {
+    uint256_rng_split(&kids[i], &rng, (uint64_t)i);
+    firsts[i] = uint256_rng_next(&kids[i]);
+  }
+  uint256_rng_split(&grandkid, &kids[0], 0);
+  firsts[4] = uint256_rng_next(&grandkid);
+  firsts[5] = uint256_rng_next(&rng);
+  for (int i = 0; i < 6; i++) {
+    for (int j = i + 1; j < 6; j++) {
+      ASSERT(uint256_cmp(firsts[i], firsts[j]) != 0);
+    }
+  }
+}
+
+void test_rng_below(TestObjs *objs) {
+  UInt256Rng rng;
+  uint256_rng_init(&rng, 42);
+
+  // Lemire: the high half of draw * bound (this draw is not rejected)
+  UInt256 bound = uint256_create_from_dec("1000000000000000000000000000000");
+  UInt256 val = uint256_rng_below(&rng, bound);
+  UInt256 expected = uint256_create_from_hex("b02809dcf3d059f35a52a25d3");
+  ASSERT_SAME(expected, val);
+
+  val = uint256_rng_below(&rng, objs->one);
+  ASSERT_SAME(objs->zero, val);
+  for (int i = 0; i < 16; i++) {
+    val = uint256_rng_below(&rng, objs->msb_set);
+    ASSERT(uint256_cmp(val, objs->msb_set) < 0);
+    val = uint256_rng_below(&rng, objs->big_b);
+    ASSERT(uint256_cmp(val, objs->big_b) < 0);
+    val = uint256_rng_below(&rng, objs->max);
+    ASSERT(uint256_cmp(val, objs->max) < 0);
+  }
+
+  // every value of a small range turns up about equally often
+  enum { N = 6000, BOUND = 6 };
+  static UInt256 vals[N];
+  int counts[BOUND] = {0};
+  uint256_rng_below_n(&rng, vals, N, uint256_create_from_u32(BOUND));
+  for (int i = 0; i < N; i++) {
+    ASSERT(vals[i].data[0] < BOUND);
+    for (int j = 1; j < 8; j++) {
+      ASSERT(vals[i].data[j] == 0);
+    }
+    counts[vals[i].data[0]]++;
+  }
+  for (int b = 0; b < BOUND; b++) {
+    ASSERT(counts[b] > 850 && counts[b] < 1150);
+  }
+
+  // a bound just above 2^255 rejects almost half of the draws, which
+  // must still give values in range
+  UInt256 big = uint256_add(objs->msb_set, objs->one);
+  uint256_rng_below_n(&rng, vals, 64, big);
+  int high = 0;
+  for (int i = 0; i < 64; i++) {
+    ASSERT(uint256_cmp(vals[i], big) < 0);
+    high += uint256_is_bit_set(vals[i], 254);
+  }
+  ASSERT(high > 16 && high < 48);
+}
+
+void test_int256_dec(TestObjs *objs) {
+  const char *min_dec = "-578960446186580977117854925043439539266349923328202"
+                        "82019728792003956564819968";
+  const char *max_dec = "578960446186580977117854925043439539266349923328202"
+                        "82019728792003956564819967";
+  Int256 min = int256_from_uint256(objs->msb_set);
+  Int256 max = int256_from_uint256(uint256_not(objs->msb_set));
+
+  // -1 is all ones, and small values are sign-extended
+  ASSERT_SAME(objs->max, int256_create_from_i64(-1));
+  ASSERT_SAME(objs->max, int256_create_from_dec("-1"));
+  ASSERT_SAME(objs->one, int256_create_from_i64(1));
+  ASSERT_SAME(int256_create_from_i64(INT64_MIN),
+              int256_create_from_dec("-9223372036854775808"));
+  ASSERT_SAME(objs->zero, int256_create_from_dec("-0"));
+
+  ASSERT_SAME(min, int256_create_from_dec(min_dec));
+  ASSERT_SAME(max, int256_create_from_dec(max_dec));
+
+  const char *values[] = {"0", "1", "-1", "-123456789012345678901234567890",
+                          "987654321098765432109876543210987654321", min_dec,
+                          max_dec};
+  for (int i = 0; i < 7; i++) {
+    char *s = int256_format_as_dec(int256_create_from_dec(values[i]));
+    ASSERT(0 == strcmp(values[i], s));
+    free(s);
+  }
+
+  ASSERT(int256_is_negative(min));
+  ASSERT(!int256_is_negative(max));
+  ASSERT(!int256_is_negative(int256_from_uint256(objs->zero)));
+
+  // |-2^255| = 2^255 is representable as a UInt256
+  ASSERT_SAME(objs->msb_set, int256_abs(min));
+  ASSERT_SAME(objs->one, int256_abs(int256_create_from_i64(-1)));
+  ASSERT_SAME(objs->pattern, int256_abs(int256_from_uint256(objs->pattern)));
+  ASSERT_SAME(objs->pattern,
+              int256_abs(int256_negate(int256_from_uint256(objs->pattern))));
+  ASSERT_SAME(min, int256_negate(min));
+}
+
+void test_int256_cmp(TestObjs *objs) {
+  Int256 min = int256_from_uint256(objs->msb_set);
+  Int256 max = int256_from_uint256(uint256_not(objs->msb_set));
+  Int256 neg1 = int256_create_from_i64(-1);
+  Int256 zero = int256_create_from_i64(0);
+  Int256 one = int256_create_from_i64(1);
+
+  // in order: min < ... < -2 < -1 < 0 < 1 < ... < max
+  Int256 sorted[] = {min,
+                     int256_create_from_dec("-1606938044258990275541962092341"
+                                            "162602522202993782792835301377"),
+                     int256_create_from_dec("-1606938044258990275541962092341"
+                                            "162602522202993782792835301376"),
+                     int256_create_from_i64(-2),
+                     neg1,
+                     zero,
+                     one,
+                     int256_from_uint256(objs->pattern),
+                     max};
+  int n = sizeof(sorted) / sizeof(sorted[0]);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      int expected = (i > j) - (i < j);
+      ASSERT(expected == int256_cmp(sorted[i], sorted[j]));
+    }
+  }
+}
+
+void test_int256_sar(TestObjs *objs) {
+  Int256 min = int256_from_uint256(objs->msb_set);
+  Int256 neg1 = int256_create_from_i64(-1);
+
+  // shifts of 256 or more leave only sign bits
+  for (unsigned s = 0; s < 600; s++) {
+    // nonnegative values shift like unsigned ones
+    ASSERT_SAME(uint256_rshift(objs->pattern, s),
+                int256_sar(int256_from_uint256(objs->pattern), s));
+    // negative ones shift in ones: sar(x) == ~(~x >> s)
+    ASSERT_SAME(uint256_not(uint256_rshift(uint256_not(objs->big_a), s)),
+                int256_sar(int256_from_uint256(objs->big_a), s));
+    ASSERT_SAME(neg1, int256_sar(neg1, s));
+  }
+
+  ASSERT_SAME(neg1, int256_sar(min, 255));
+  ASSERT_SAME(neg1, int256_sar(min, 256));
+  ASSERT_SAME(neg1, int256_sar(min, ~0U));
+  ASSERT_SAME(objs->zero,
+              int256_sar(int256_from_uint256(objs->pattern), ~0U));
+  ASSERT_SAME(int256_create_from_dec("-289480223093290488558927462521719769"
+                                     "63317496166410141009864396001978282409"
+                                     "984"),
+              int256_sar(min, 1));
+  // rounding is toward negative infinity
+  ASSERT_SAME(int256_create_from_i64(-3),
+              int256_sar(int256_create_from_i64(-5), 1));
+  ASSERT_SAME(int256_create_from_i64(-1),
+              int256_sar(int256_create_from_i64(-5), 3));
+  ASSERT_SAME(int256_create_from_i64(2),
+              int256_sar(int256_create_from_i64(5), 1));
+}
+
+void test_int256_mul(TestObjs *objs) {
+  Int256 min = int256_from_uint256(objs->msb_set);
+  Int256 neg1 = int256_create_from_i64(-1);
+  Int256 hi;
+  UInt256 lo;
+
+  ASSERT_SAME(int256_create_from_i64(-21),
+              int256_mul(int256_create_from_i64(-3), int256_create_from_i64(7)));
+  ASSERT_SAME(int256_create_from_i64(21),
+              int256_mul(int256_create_from_i64(-3), int256_create_from_i64(-7)));
+
+  // (-1)(-1) = 1
+  int256_mul_wide(neg1, neg1, &hi, &lo);
+  ASSERT_SAME(objs->zero, hi);
+  ASSERT_SAME(objs->one, lo);
+
+  // (-2)(3) = -6: the high half is all ones
+  int256_mul_wide(int256_create_from_i64(-2), int256_create_from_i64(3), &hi,
+                  &lo);
+  ASSERT_SAME(objs->max, hi);
+  ASSERT_SAME(int256_create_from_i64(-6), lo);
+
+  // (-2^255)^2 = 2^510
+  int256_mul_wide(min, min, &hi, &lo);
+  ASSERT_SAME(uint256_rshift(objs->msb_set, 1), hi);
+  ASSERT_SAME(objs->zero, lo);
+
+  // (-2^255)(-1) = 2^255 needs the high half to be positive
+  int256_mul_wide(min, neg1, &hi, &lo);
+  ASSERT_SAME(objs->zero, hi);
+  ASSERT_SAME(objs->msb_set, lo);
+
+  // a negative times a positive agrees with the unsigned product of the
+  // magnitudes, negated as a 512-bit value
+  Int256 a = int256_from_uint256(objs->big_a); // negative
+  Int256 b = int256_from_uint256(objs->pattern);
+  UInt256 mhi, mlo;
+  uint256_mul_wide(int256_abs(a), objs->pattern, &mhi, &mlo);
+  int256_mul_wide(a, b, &hi, &lo);
+  ASSERT_SAME(uint256_negate(mlo), lo);
+  if (uint256_is_zero(mlo)) {
+    ASSERT_SAME(uint256_negate(mhi), hi);
+  } else {
+    ASSERT_SAME(uint256_not(mhi), hi);
+  }
+  // and the low half is the wrapping product
+  ASSERT_SAME(lo, int256_mul(a, b));
+}
+
+void test_int256_divmod(TestObjs *objs) {
+  Int256 min = int256_from_uint256(objs->msb_set);
+  Int256 q, r;
+
+  // truncation toward zero; the remainder has the sign of num
+  static const int64_t cases[][4] = {
+      {7, 2, 3, 1},   {-7, 2, -3, -1}, {7, -2, -3, 1},
+      {-7, -2, 3, -1}, {-6, 3, -2, 0},  {1, -5, 0, 1},
+  };
+  for (int i = 0; i < 6; i++) {
+    int256_divmod(int256_create_from_i64(cases[i][0]),
+                  int256_create_from_i64(cases[i][1]), &q, &r);
+    ASSERT_SAME(int256_create_from_i64(cases[i][2]), q);
+    ASSERT_SAME(int256_create_from_i64(cases[i][3]), r);
+  }
+
+  // -2^255 / -1 wraps
+  int256_divmod(min, int256_create_from_i64(-1), &q, &r);
+  ASSERT_SAME(min, q);
+  ASSERT_SAME(objs->zero, r);
+  int256_divmod(min, int256_create_from_i64(1), &q, &r);
+  ASSERT_SAME(min, q);
+  ASSERT_SAME(objs->zero, r);
+
+  Int256 num = int256_create_from_dec(
+      "-1234567890123456789012345678901234567890123456789012345678901234567");
+  Int256 den = int256_create_from_dec("98765432109876543210987654321");
+  int256_divmod(num, den, &q, &r);
+  // num == q * den + r, with |r| < |den| and r of the sign of num
+  ASSERT_SAME(num, int256_add(int256_mul(q, den), r));
+  ASSERT(int256_is_negative(r));
+  ASSERT(uint256_cmp(int256_abs(r), int256_abs(den)) < 0);
+  char *s = int256_format_as_dec(q);
+  ASSERT(0 == strcmp("-12499999886093750001423828124994702148", s));
+  free(s);
+
+  // either output may be NULL
+  Int256 q2, r2;
+  int256_divmod(num, den, &q2, NULL);
+  int256_divmod(num, den, NULL, &r2);
+  ASSERT_SAME(q, q2);
+  ASSERT_SAME(r, r2);
+}
+
+void test_shift_n(TestObjs *objs) {
+  enum { N = 37 };
+  UInt256 a[N], shl[N], shr[N];
+  unsigned shifts[N];
+
+  fill_pseudo_random(a, N, 5U);
+  a[0] = objs->max;
+  a[1] = objs->msb_set;
+  a[4] = objs->one;
+  // whole words, partial words, 0, 255 and past the end of the value
+  for (size_t k = 0; k < N; k++) {
+    shifts[k] = (unsigned)(k * 29) % 300;
+  }
+  shifts[2] = 0;
+  shifts[3] = 64;
+  shifts[4] = 255;
+  shifts[5] = 256;
+  shifts[6] = ~0U;
+
+  for (size_t n = 0; n <= N; n++) {
+    uint256_lshift_n(shl, a, shifts, n);
+    uint256_rshift_n(shr, a, shifts, n);
+    for (size_t k = 0; k < n; k++) {
+      ASSERT_SAME(uint256_lshift(a[k], shifts[k]), shl[k]);
+      ASSERT_SAME(uint256_rshift(a[k], shifts[k]), shr[k]);
+    }
+  }
+  ASSERT_SAME(objs->msb_set, shl[4]);
+  ASSERT_SAME(objs->zero, shr[4]);
+  ASSERT_SAME(objs->zero, shl[5]);
+  ASSERT_SAME(objs->zero, shr[6]);
+
+  // dst aliasing src
+  UInt256 r[N];
+  memcpy(r, a, sizeof(r));
+  uint256_lshift_n(r, r, shifts, N);
+  for (size_t k = 0; k < N; k++) {
+    ASSERT_SAME(shl[k], r[k]);
+  }
+  memcpy(r, a, sizeof(r));
+  uint256_rshift_n(r, r, shifts, N);
+  for (size_t k = 0; k < N; k++) {
+    ASSERT_SAME(shr[k], r[k]);
+  }
+}
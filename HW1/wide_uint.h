@@ -0,0 +1,630 @@
+#ifndef WIDE_UINT_H
+#define WIDE_UINT_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "uint256.h"
+
+// Header-only C++17 fixed-width unsigned integers: WideUInt<Bits, Limb>
+// provides the operations of the C UInt256 type (uint256.h) for any
+// width that is a multiple of the limb size, with operator overloads.
+//
+// The value is stored as an array of limbs, least significant first,
+// just like UInt256::data. Per-limb loops are expanded at compile time
+// (see unroll below), and all arithmetic is constexpr, so operations
+// on constants are folded by the compiler. Division is the exception:
+// like uint256_divmod, its loops run over the divisor's significant
+// limbs, so their trip counts depend on the value. WideUInt<256>
+// (with the default 32-bit limbs) has the same layout as UInt256 and
+// converts to and from it with a plain copy.
+//
+// Like the unsigned built-in types, all arithmetic wraps modulo
+// 2^Bits. Shifting by Bits or more gives 0.
+
+namespace wide_uint_detail {
+
+// Unsigned type twice as wide as a limb, for products and carries.
+template <typename Limb> struct DoubleLimb;
+
+template <> struct DoubleLimb<uint32_t> {
+  using type = uint64_t;
+};
+
+#ifdef __SIZEOF_INT128__
+template <> struct DoubleLimb<uint64_t> {
+  __extension__ typedef unsigned __int128 type;
+};
+#endif
+
+template <typename F, std::size_t... I>
+constexpr void unroll_impl(F &f, std::index_sequence<I...>) {
+  (f(std::integral_constant<std::size_t, I>{}), ...);
+}
+
+// Call f(std::integral_constant<std::size_t, I>{}) for I = 0 .. N-1.
+// Each index is a separate call with a compile-time constant, so a
+// loop written with unroll is fully unrolled (and an index can be used
+// as a template argument via decltype(i)::value).
+template <std::size_t N, typename F> constexpr void unroll(F &&f) {
+  unroll_impl(f, std::make_index_sequence<N>{});
+}
+
+// Bit counts for a single nonzero limb (popcount allows 0).
+template <typename Limb> constexpr unsigned limb_clz(Limb x) {
+  if constexpr (sizeof(Limb) <= sizeof(unsigned)) {
+    return (unsigned)__builtin_clz(x) - (8 * (sizeof(unsigned) - sizeof(Limb)));
+  } else {
+    return (unsigned)__builtin_clzll(x);
+  }
+}
+
+template <typename Limb> constexpr unsigned limb_ctz(Limb x) {
+  if constexpr (sizeof(Limb) <= sizeof(unsigned)) {
+    return (unsigned)__builtin_ctz(x);
+  } else {
+    return (unsigned)__builtin_ctzll(x);
+  }
+}
+
+template <typename Limb> constexpr unsigned limb_popcount(Limb x) {
+  if constexpr (sizeof(Limb) <= sizeof(unsigned)) {
+    return (unsigned)__builtin_popcount(x);
+  } else {
+    return (unsigned)__builtin_popcountll(x);
+  }
+}
+
+// Value of a hex digit, or -1 if c is not one.
+constexpr int hex_value(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+} // namespace wide_uint_detail
+
+template <unsigned Bits, typename Limb = uint32_t> class WideUInt {
+  static_assert(std::is_same<Limb, uint32_t>::value ||
+                    std::is_same<Limb, uint64_t>::value,
+                "limbs must be uint32_t or uint64_t");
+
+public:
+  using limb_type = Limb;
+  static constexpr unsigned LIMB_BITS = 8 * sizeof(Limb);
+  static constexpr std::size_t NUM_LIMBS = Bits / LIMB_BITS;
+  static_assert(Bits > 0 && Bits % LIMB_BITS == 0,
+                "the width must be a multiple of the limb size");
+
+  // Limbs, least significant first.
+  Limb data[NUM_LIMBS];
+
+private:
+  using Wide = typename wide_uint_detail::DoubleLimb<Limb>::type;
+
+  template <typename F> static constexpr void each_limb(F &&f) {
+    wide_uint_detail::unroll<NUM_LIMBS>(f);
+  }
+
+public:
+  // Zero.
+  constexpr WideUInt() : data{} {}
+
+  // Create a value from a built-in unsigned integer.
+  constexpr WideUInt(uint64_t val) : data{} {
+    data[0] = (Limb)val;
+    if constexpr (LIMB_BITS < 64) {
+      if constexpr (NUM_LIMBS > 1) {
+        data[1] = (Limb)(val >> 32);
+      }
+    }
+  }
+
+  // Convert from the C UInt256 type (256-bit values only). With 32-bit
+  // limbs the layout is identical, and this is a 32-byte copy.
+  template <unsigned B = Bits, std::enable_if_t<B == 256, int> = 0>
+  constexpr WideUInt(const UInt256 &val) : data{} {
+    wide_uint_detail::unroll<8>([&](auto k) {
+      constexpr std::size_t K = decltype(k)::value;
+      data[K * 32 / LIMB_BITS] |= (Limb)val.data[K] << (K * 32 % LIMB_BITS);
+    });
+  }
+
+  // Convert to the C UInt256 type (256-bit values only).
+  template <unsigned B = Bits, std::enable_if_t<B == 256, int> = 0>
+  constexpr UInt256 to_c() const {
+    UInt256 val{};
+    wide_uint_detail::unroll<8>([&](auto k) {
+      constexpr std::size_t K = decltype(k)::value;
+      val.data[K] = (uint32_t)(data[K * 32 / LIMB_BITS] >> (K * 32 % LIMB_BITS));
+    });
+    return val;
+  }
+
+  template <unsigned B = Bits, std::enable_if_t<B == 256, int> = 0>
+  explicit constexpr operator UInt256() const {
+    return to_c();
+  }
+
+  // Create a value from a string of hex digits (upper or lower case).
+  // If there are more digits than fit, only the rightmost ones are
+  // used. An empty string or one with a non-hex character gives 0.
+  static constexpr WideUInt from_hex(std::string_view hex) {
+    WideUInt result;
+    if (hex.empty()) {
+      return result;
+    }
+    std::size_t count = 0;
+    for (std::size_t i = hex.size(); i-- > 0;) {
+      int digit = wide_uint_detail::hex_value(hex[i]);
+      if (digit < 0) {
+        return WideUInt();
+      }
+      if (count < Bits / 4) {
+        result.data[count * 4 / LIMB_BITS] |= (Limb)digit
+                                              << (count * 4 % LIMB_BITS);
+      }
+      count++;
+    }
+    return result;
+  }
+
+  // Create a value from a string of decimal digits. Values that don't
+  // fit are reduced modulo 2^Bits. A string with a character that is
+  // not a decimal digit gives 0.
+  static constexpr WideUInt from_dec(std::string_view dec) {
+    WideUInt result;
+    for (char c : dec) {
+      if (c < '0' || c > '9') {
+        return WideUInt();
+      }
+      result = result.mul_small(10, (Limb)(c - '0'));
+    }
+    return result;
+  }
+
+  // Return the hex digits of the value (lower case, no leading zeros).
+  std::string to_hex() const {
+    static const char digits[] = "0123456789abcdef";
+    unsigned n = (bit_length() + 3) / 4;
+    if (n == 0) {
+      return "0";
+    }
+    std::string s(n, '0');
+    for (unsigned i = 0; i < n; i++) {
+      s[n - 1 - i] = digits[(data[i * 4 / LIMB_BITS] >> (i * 4 % LIMB_BITS)) & 0xf];
+    }
+    return s;
+  }
+
+  // Return the decimal digits of the value (no leading zeros).
+  std::string to_dec() const {
+    // peel off 9 digits at a time with a single-limb division, filling
+    // the buffer from the end (log10(2) < 1/3, so Bits / 3 + 1 digits
+    // is always enough)
+    char buf[Bits / 3 + 1];
+    char *end = buf + sizeof(buf);
+    char *p = end;
+    WideUInt val = *this;
+    do {
+      Limb chunk = 0;
+      val = val.div_small(1000000000U, &chunk);
+      for (int i = 0; i < 9; i++) {
+        *--p = (char)('0' + chunk % 10);
+        chunk /= 10;
+        if (val.is_zero() && chunk == 0) {
+          break;
+        }
+      }
+    } while (!val.is_zero());
+    return std::string(p, end);
+  }
+
+  // Get the 32 bits at the given index (0 is the least significant).
+  constexpr uint32_t get_bits(unsigned index) const {
+    assert(index < Bits / 32);
+    return (uint32_t)(data[index * 32 / LIMB_BITS] >> (index * 32 % LIMB_BITS));
+  }
+
+  // Return true if the bit at the given index is set.
+  constexpr bool is_bit_set(unsigned index) const {
+    assert(index < Bits);
+    return (data[index / LIMB_BITS] >> (index % LIMB_BITS)) & 1;
+  }
+
+  constexpr bool is_zero() const {
+    Limb any = 0;
+    each_limb([&](auto i) { any |= data[i]; });
+    return any == 0;
+  }
+
+  // Return -1, 0 or 1 as *this is less than, equal to or greater than
+  // other.
+  constexpr int cmp(const WideUInt &other) const {
+    int result = 0;
+    each_limb([&](auto i) {
+      // limbs are visited from least significant up, so a higher limb
+      // that differs overrides the answer from the lower ones
+      if (data[i] != other.data[i]) {
+        result = data[i] > other.data[i] ? 1 : -1;
+      }
+    });
+    return result;
+  }
+
+  constexpr unsigned popcount() const {
+    unsigned n = 0;
+    each_limb([&](auto i) { n += wide_uint_detail::limb_popcount(data[i]); });
+    return n;
+  }
+
+  // Number of leading zero bits (Bits for 0). As in uint256_clz, every
+  // limb is visited: found masks off the counts below the first
+  // nonzero limb instead of breaking out of the loop.
+  constexpr unsigned clz() const {
+    unsigned count = 0, found = 0;
+    each_limb([&](auto i) {
+      Limb limb = data[NUM_LIMBS - 1 - i];
+      unsigned lz = limb != 0 ? wide_uint_detail::limb_clz(limb) : LIMB_BITS;
+      count += lz & ~found;
+      found |= -(unsigned)(limb != 0);
+    });
+    return count;
+  }
+
+  // Number of trailing zero bits (Bits for 0).
+  constexpr unsigned ctz() const {
+    unsigned count = 0, found = 0;
+    each_limb([&](auto i) {
+      Limb limb = data[i];
+      unsigned tz = limb != 0 ? wide_uint_detail::limb_ctz(limb) : LIMB_BITS;
+      count += tz & ~found;
+      found |= -(unsigned)(limb != 0);
+    });
+    return count;
+  }
+
+  // Position of the highest set bit plus one (0 for 0).
+  constexpr unsigned bit_length() const {
+    return Bits - clz();
+  }
+
+  friend constexpr WideUInt operator+(const WideUInt &a, const WideUInt &b) {
+    WideUInt r;
+    Limb carry = 0;
+    each_limb([&](auto i) {
+      Wide t = (Wide)a.data[i] + b.data[i] + carry;
+      r.data[i] = (Limb)t;
+      carry = (Limb)(t >> LIMB_BITS);
+    });
+    return r;
+  }
+
+  friend constexpr WideUInt operator-(const WideUInt &a, const WideUInt &b) {
+    WideUInt r;
+    Limb borrow = 0;
+    each_limb([&](auto i) {
+      Wide t = (Wide)a.data[i] - b.data[i] - borrow;
+      r.data[i] = (Limb)t;
+      borrow = (Limb)(t >> LIMB_BITS) & 1;
+    });
+    return r;
+  }
+
+  // Two's-complement negation.
+  friend constexpr WideUInt operator-(const WideUInt &a) {
+    return WideUInt() - a;
+  }
+
+  // Product truncated to Bits bits: partial products that would land
+  // entirely above the width are never formed.
+  friend constexpr WideUInt operator*(const WideUInt &a, const WideUInt &b) {
+    WideUInt r;
+    each_limb([&](auto i) {
+      constexpr std::size_t I = decltype(i)::value;
+      Limb carry = 0;
+      wide_uint_detail::unroll<NUM_LIMBS - I>([&](auto j) {
+        constexpr std::size_t J = decltype(j)::value;
+        Wide t = (Wide)a.data[I] * b.data[J] + r.data[I + J] + carry;
+        r.data[I + J] = (Limb)t;
+        carry = (Limb)(t >> LIMB_BITS);
+      });
+    });
+    return r;
+  }
+
+  friend constexpr WideUInt operator/(const WideUInt &a, const WideUInt &b) {
+    WideUInt q;
+    divmod(a, b, &q, nullptr);
+    return q;
+  }
+
+  friend constexpr WideUInt operator%(const WideUInt &a, const WideUInt &b) {
+    WideUInt r;
+    divmod(a, b, nullptr, &r);
+    return r;
+  }
+
+  friend constexpr WideUInt operator&(const WideUInt &a, const WideUInt &b) {
+    WideUInt r;
+    each_limb([&](auto i) { r.data[i] = a.data[i] & b.data[i]; });
+    return r;
+  }
+
+  friend constexpr WideUInt operator|(const WideUInt &a, const WideUInt &b) {
+    WideUInt r;
+    each_limb([&](auto i) { r.data[i] = a.data[i] | b.data[i]; });
+    return r;
+  }
+
+  friend constexpr WideUInt operator^(const WideUInt &a, const WideUInt &b) {
+    WideUInt r;
+    each_limb([&](auto i) { r.data[i] = a.data[i] ^ b.data[i]; });
+    return r;
+  }
+
+  friend constexpr WideUInt operator~(const WideUInt &a) {
+    WideUInt r;
+    each_limb([&](auto i) { r.data[i] = ~a.data[i]; });
+    return r;
+  }
+
+  friend constexpr WideUInt operator<<(const WideUInt &a, unsigned shift) {
+    WideUInt r;
+    if (shift >= Bits) {
+      return r;
+    }
+    std::size_t word_shift = shift / LIMB_BITS;
+    unsigned bits_shift = shift % LIMB_BITS;
+    each_limb([&](auto i) {
+      constexpr std::size_t I = decltype(i)::value;
+      if (I >= word_shift) {
+        r.data[I] = a.data[I - word_shift] << bits_shift;
+        if (I > word_shift) {
+          // two steps keep bits_shift == 0 well defined
+          r.data[I] |= (a.data[I - word_shift - 1] >> 1) >>
+                       (LIMB_BITS - 1 - bits_shift);
+        }
+      }
+    });
+    return r;
+  }
+
+  friend constexpr WideUInt operator>>(const WideUInt &a, unsigned shift) {
+    WideUInt r;
+    if (shift >= Bits) {
+      return r;
+    }
+    std::size_t word_shift = shift / LIMB_BITS;
+    unsigned bits_shift = shift % LIMB_BITS;
+    each_limb([&](auto i) {
+      constexpr std::size_t I = decltype(i)::value;
+      if (I + word_shift < NUM_LIMBS) {
+        r.data[I] = a.data[I + word_shift] >> bits_shift;
+        if (I + word_shift + 1 < NUM_LIMBS) {
+          r.data[I] |= (a.data[I + word_shift + 1] << 1)
+                       << (LIMB_BITS - 1 - bits_shift);
+        }
+      }
+    });
+    return r;
+  }
+
+  // Rotate left or right; the shift is taken modulo Bits.
+  constexpr WideUInt rotl(unsigned shift) const {
+    shift %= Bits;
+    return (*this << shift) | (*this >> (Bits - shift));
+  }
+
+  constexpr WideUInt rotr(unsigned shift) const {
+    shift %= Bits;
+    return (*this >> shift) | (*this << (Bits - shift));
+  }
+
+  friend constexpr bool operator==(const WideUInt &a, const WideUInt &b) {
+    Limb diff = 0;
+    each_limb([&](auto i) { diff |= a.data[i] ^ b.data[i]; });
+    return diff == 0;
+  }
+
+  friend constexpr bool operator!=(const WideUInt &a, const WideUInt &b) {
+    return !(a == b);
+  }
+
+  friend constexpr bool operator<(const WideUInt &a, const WideUInt &b) {
+    return a.cmp(b) < 0;
+  }
+
+  friend constexpr bool operator<=(const WideUInt &a, const WideUInt &b) {
+    return a.cmp(b) <= 0;
+  }
+
+  friend constexpr bool operator>(const WideUInt &a, const WideUInt &b) {
+    return a.cmp(b) > 0;
+  }
+
+  friend constexpr bool operator>=(const WideUInt &a, const WideUInt &b) {
+    return a.cmp(b) >= 0;
+  }
+
+  constexpr WideUInt &operator+=(const WideUInt &b) { return *this = *this + b; }
+  constexpr WideUInt &operator-=(const WideUInt &b) { return *this = *this - b; }
+  constexpr WideUInt &operator*=(const WideUInt &b) { return *this = *this * b; }
+  constexpr WideUInt &operator/=(const WideUInt &b) { return *this = *this / b; }
+  constexpr WideUInt &operator%=(const WideUInt &b) { return *this = *this % b; }
+  constexpr WideUInt &operator&=(const WideUInt &b) { return *this = *this & b; }
+  constexpr WideUInt &operator|=(const WideUInt &b) { return *this = *this | b; }
+  constexpr WideUInt &operator^=(const WideUInt &b) { return *this = *this ^ b; }
+  constexpr WideUInt &operator<<=(unsigned s) { return *this = *this << s; }
+  constexpr WideUInt &operator>>=(unsigned s) { return *this = *this >> s; }
+
+  // Divide num by den, storing the quotient in *quot and the remainder
+  // in *rem (either may be null). The divisor must not be 0.
+  // Schoolbook long division on limbs (Knuth, TAOCP vol. 2, Algorithm
+  // 4.3.1D), the same method as uint256_divmod. The quotient and
+  // multiply-subtract loops run over the n significant limbs of den,
+  // so unlike the other operations they are not unrolled.
+  static constexpr void divmod(const WideUInt &num, const WideUInt &den,
+                               WideUInt *quot, WideUInt *rem) {
+    assert(!den.is_zero());
+    WideUInt q;
+    std::size_t n = (den.bit_length() + LIMB_BITS - 1) / LIMB_BITS;
+
+    if (n == 1) {
+      Limb r = 0;
+      q = num.div_small(den.data[0], &r);
+      if (quot) {
+        *quot = q;
+      }
+      if (rem) {
+        *rem = WideUInt(r);
+      }
+      return;
+    }
+
+    // normalize so the divisor's top limb has its top bit set; u gets
+    // one extra limb for the bits shifted out of num
+    unsigned s = wide_uint_detail::limb_clz(den.data[n - 1]);
+    WideUInt v = den << s;
+    Limb u[NUM_LIMBS + 1] = {};
+    WideUInt lo = num << s;
+    each_limb([&](auto i) { u[i] = lo.data[i]; });
+    u[NUM_LIMBS] = s == 0 ? 0 : num.data[NUM_LIMBS - 1] >> (LIMB_BITS - s);
+
+    for (std::size_t j = NUM_LIMBS - n + 1; j-- > 0;) {
+      // estimate the quotient limb from the top two limbs, then correct
+      // it with the next one (after which it is at most one too large)
+      Wide top = ((Wide)u[j + n] << LIMB_BITS) | u[j + n - 1];
+      Wide qhat = top / v.data[n - 1];
+      Wide rhat = top % v.data[n - 1];
+      while ((qhat >> LIMB_BITS) != 0 ||
+             qhat * v.data[n - 2] > ((rhat << LIMB_BITS) | u[j + n - 2])) {
+        qhat--;
+        rhat += v.data[n - 1];
+        if ((rhat >> LIMB_BITS) != 0) {
+          break;
+        }
+      }
+
+      // u[j..j+n] -= qhat * v
+      Limb carry = 0, borrow = 0;
+      for (std::size_t i = 0; i < n; i++) {
+        Wide p = qhat * v.data[i] + carry;
+        carry = (Limb)(p >> LIMB_BITS);
+        Wide t = (Wide)u[i + j] - (Limb)p - borrow;
+        u[i + j] = (Limb)t;
+        borrow = (t >> LIMB_BITS) != 0;
+      }
+      Wide t = (Wide)u[j + n] - carry - borrow;
+      u[j + n] = (Limb)t;
+
+      if ((t >> LIMB_BITS) != 0) {
+        // qhat was one too large: add v back
+        qhat--;
+        Limb c = 0;
+        for (std::size_t i = 0; i < n; i++) {
+          Wide sum = (Wide)u[i + j] + v.data[i] + c;
+          u[i + j] = (Limb)sum;
+          c = (Limb)(sum >> LIMB_BITS);
+        }
+        u[j + n] += c;
+      }
+      q.data[j] = (Limb)qhat;
+    }
+
+    if (quot) {
+      *quot = q;
+    }
+    if (rem) {
+      // the limbs of u above the remainder have all been cleared
+      WideUInt r;
+      each_limb([&](auto i) { r.data[i] = u[i]; });
+      *rem = r >> s;
+    }
+  }
+
+private:
+  // Return *this * m + a, for single-limb m and a.
+  constexpr WideUInt mul_small(Limb m, Limb a) const {
+    WideUInt r;
+    Limb carry = a;
+    each_limb([&](auto i) {
+      Wide t = (Wide)data[i] * m + carry;
+      r.data[i] = (Limb)t;
+      carry = (Limb)(t >> LIMB_BITS);
+    });
+    return r;
+  }
+
+  // Return *this / d, storing the remainder in *rem, for a nonzero
+  // single-limb d.
+  constexpr WideUInt div_small(Limb d, Limb *rem) const {
+    WideUInt q;
+    Wide r = 0;
+    each_limb([&](auto i) {
+      constexpr std::size_t I = NUM_LIMBS - 1 - decltype(i)::value;
+      Wide cur = (r << LIMB_BITS) | data[I];
+      q.data[I] = (Limb)(cur / d);
+      r = cur % d;
+    });
+    *rem = (Limb)r;
+    return q;
+  }
+};
+
+// Compute the full product of two values, twice as wide as the inputs.
+template <unsigned Bits, typename Limb>
+constexpr WideUInt<2 * Bits, Limb> mul_wide(const WideUInt<Bits, Limb> &a,
+                                            const WideUInt<Bits, Limb> &b) {
+  using Wide = typename wide_uint_detail::DoubleLimb<Limb>::type;
+  constexpr std::size_t N = WideUInt<Bits, Limb>::NUM_LIMBS;
+  constexpr unsigned LIMB_BITS = WideUInt<Bits, Limb>::LIMB_BITS;
+  WideUInt<2 * Bits, Limb> r;
+  wide_uint_detail::unroll<N>([&](auto i) {
+    constexpr std::size_t I = decltype(i)::value;
+    Limb carry = 0;
+    wide_uint_detail::unroll<N>([&](auto j) {
+      constexpr std::size_t J = decltype(j)::value;
+      Wide t = (Wide)a.data[I] * b.data[J] + r.data[I + J] + carry;
+      r.data[I + J] = (Limb)t;
+      carry = (Limb)(t >> LIMB_BITS);
+    });
+    r.data[I + N] = carry;
+  });
+  return r;
+}
+
+// Truncate or zero-extend a value to another width.
+template <unsigned To, unsigned From, typename Limb>
+constexpr WideUInt<To, Limb> wide_uint_cast(const WideUInt<From, Limb> &a) {
+  WideUInt<To, Limb> r;
+  constexpr std::size_t N = WideUInt<To, Limb>::NUM_LIMBS <
+                                    WideUInt<From, Limb>::NUM_LIMBS
+                                ? WideUInt<To, Limb>::NUM_LIMBS
+                                : WideUInt<From, Limb>::NUM_LIMBS;
+  wide_uint_detail::unroll<N>([&](auto i) { r.data[i] = a.data[i]; });
+  return r;
+}
+
+using UInt128W = WideUInt<128>;
+using UInt256W = WideUInt<256>;
+using UInt512W = WideUInt<512>;
+using UInt1024W = WideUInt<1024>;
+
+static_assert(sizeof(WideUInt<256>) == sizeof(UInt256) &&
+                  std::is_trivially_copyable<WideUInt<256>>::value,
+              "WideUInt<256> must have the layout of UInt256");
+
+#endif // WIDE_UINT_H
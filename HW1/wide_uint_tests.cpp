@@ -0,0 +1,289 @@
+#include "tctest.h"
+#include <cstdlib>
+#include <string>
+
+#include "uint256.h"
+#include "wide_uint.h"
+
+typedef struct {
+  UInt256 big_a; // same operands as in uint256_tests.c
+  UInt256 big_b;
+  UInt256 pattern;
+  UInt512W a512; // big_a:big_b (big_a in the upper half)
+  UInt512W b512; // pattern:big_a
+} TestObjs;
+
+// Helper functions for implementing tests
+void fill_pseudo_random(UInt256 *vals, size_t n, uint32_t seed);
+
+#define ASSERT_SAME(expected, actual)                                          \
+  do {                                                                         \
+    for (int i = 0; i < 8; ++i)                                                \
+      ASSERT(expected.data[i] == actual.data[i]);                              \
+  } while (0)
+
+// Functions to create and cleanup the test fixture object
+TestObjs *setup(void);
+void cleanup(TestObjs *objs);
+
+// Declarations of test functions
+void test_constexpr(TestObjs *objs);
+void test_convert(TestObjs *objs);
+void test_hex_dec(TestObjs *objs);
+void test_matches_c_lib(TestObjs *objs);
+void test_wide_128(TestObjs *objs);
+void test_wide_512(TestObjs *objs);
+void test_wide_1024(TestObjs *objs);
+void test_limb64(TestObjs *objs);
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+    tctest_testname_to_execute = argv[1];
+
+  TEST_INIT();
+
+  TEST(test_constexpr);
+  TEST(test_convert);
+  TEST(test_hex_dec);
+  TEST(test_matches_c_lib);
+  TEST(test_wide_128);
+  TEST(test_wide_512);
+  TEST(test_wide_1024);
+  TEST(test_limb64);
+
+  TEST_FINI();
+}
+
+// Fill an array with deterministic pseudo-random values (the same LCG
+// as uint256_tests.c), mixing in limbs of all zeros and all ones.
+void fill_pseudo_random(UInt256 *vals, size_t n, uint32_t seed) {
+  uint32_t x = seed;
+  for (size_t k = 0; k < n; ++k) {
+    for (unsigned i = 0; i < 8; ++i) {
+      x = x * 1664525U + 1013904223U;
+      uint32_t pick = x >> 29;
+      vals[k].data[i] = pick == 0 ? 0U : pick == 1 ? 0xFFFFFFFFU : x;
+    }
+  }
+}
+
+TestObjs *setup(void) {
+  TestObjs *objs = new TestObjs;
+  objs->big_a = uint256_create_from_hex(
+      "fedcba98765432100123456789abcdefdeadbeefcafebabe0badf00d8badf00d");
+  objs->big_b = uint256_create_from_hex(
+      "1234567890abcdeffedcba0987654321aaaaaaaa55555555ffffffff00000001");
+  objs->pattern = uint256_create_from_hex(
+      "727767d07ccff5fe25cd125b4523e8c7db1b8d1a2c8a2830284d72bb872c33a5");
+  UInt512W a = wide_uint_cast<512>(UInt256W(objs->big_a));
+  UInt512W b = wide_uint_cast<512>(UInt256W(objs->big_b));
+  UInt512W p = wide_uint_cast<512>(UInt256W(objs->pattern));
+  objs->a512 = (a << 256) | b;
+  objs->b512 = (p << 256) | a;
+  return objs;
+}
+
+void cleanup(TestObjs *objs) {
+  delete objs;
+}
+
+// Values computed from constant operands are folded at compile time.
+constexpr UInt256W CA = UInt256W::from_hex(
+    "fedcba98765432100123456789abcdefdeadbeefcafebabe0badf00d8badf00d");
+constexpr UInt256W CB = UInt256W::from_hex(
+    "1234567890abcdeffedcba0987654321aaaaaaaa55555555ffffffff00000001");
+static_assert(CA + CB - CB == CA, "add/sub");
+static_assert(CA * CB / CB != CA, "the product wraps");
+static_assert((CA / CB) * CB + CA % CB == CA, "divmod");
+static_assert(CA / CB == UInt256W(0xe), "quotient");
+static_assert((-CA) + CA == UInt256W(), "negate");
+static_assert((UInt256W(1) << 255).bit_length() == 256, "bit_length");
+static_assert(UInt256W().clz() == 256 && UInt256W().ctz() == 256 &&
+                  UInt256W().bit_length() == 0,
+              "bit counts of 0");
+static_assert((WideUInt<256, uint64_t>(1) << 100).ctz() == 100 &&
+                  (WideUInt<256, uint64_t>(1) << 100).clz() == 155,
+              "bit counts with 64-bit limbs");
+static_assert((UInt256W(1) << 256).is_zero(), "shift >= Bits");
+static_assert(UInt256W::from_dec("1000000000000000000000") ==
+                  UInt256W(1000000000000000000ULL) * UInt256W(1000),
+              "from_dec");
+static_assert(mul_wide(CA, CB).get_bits(15) == 0x121fa00a, "mul_wide");
+
+void test_constexpr(TestObjs *) {
+  // the static_asserts above do the checking; make sure the folded
+  // constants are also usable at run time
+  constexpr UInt256W q = CA / CB;
+  ASSERT(q.get_bits(0) == 0xe);
+  for (unsigned i = 1; i < 8; i++) {
+    ASSERT(q.get_bits(i) == 0);
+  }
+}
+
+void test_convert(TestObjs *objs) {
+  UInt256W w(objs->big_a);
+  for (unsigned i = 0; i < 8; i++) {
+    ASSERT(w.data[i] == objs->big_a.data[i]);
+  }
+  UInt256 back = w.to_c();
+  ASSERT_SAME(objs->big_a, back);
+  UInt256 cast = static_cast<UInt256>(w);
+  ASSERT_SAME(objs->big_a, cast);
+
+  // the same through 64-bit limbs
+  WideUInt<256, uint64_t> w64(objs->big_b);
+  ASSERT(w64.data[0] == 0xffffffff00000001ULL);
+  ASSERT(w64.data[3] == 0x1234567890abcdefULL);
+  UInt256 back64 = w64.to_c();
+  ASSERT_SAME(objs->big_b, back64);
+}
+
+void test_hex_dec(TestObjs *objs) {
+  UInt256W a(objs->big_a);
+  ASSERT(a.to_hex() ==
+         "fedcba98765432100123456789abcdefdeadbeefcafebabe0badf00d8badf00d");
+  ASSERT(UInt256W().to_hex() == "0");
+  ASSERT(UInt256W().to_dec() == "0");
+  ASSERT(UInt256W(1000000000).to_dec() == "1000000000");
+  ASSERT(UInt256W::from_hex("xyz").is_zero());
+  ASSERT(UInt256W::from_hex("").is_zero());
+  ASSERT(UInt256W::from_dec("12a").is_zero());
+  // too many digits: only the rightmost 64 are used
+  ASSERT(UInt256W::from_hex("1fedcba98765432100123456789abcdefdeadbeefcafeba"
+                            "be0badf00d8badf00d") == a);
+
+  char *dec = uint256_format_as_dec(objs->big_a);
+  ASSERT(a.to_dec() == dec);
+  ASSERT(UInt256W::from_dec(dec) == a);
+  free(dec);
+}
+
+void test_matches_c_lib(TestObjs *) {
+  const size_t N = 64;
+  UInt256 vals[N];
+  fill_pseudo_random(vals, N, 17U);
+
+  for (size_t k = 0; k + 1 < N; k++) {
+    UInt256 x = vals[k], y = vals[k + 1];
+    UInt256W wx(x), wy(y);
+    unsigned s = (x.data[0] ^ y.data[1]) % 256;
+
+    UInt256 r;
+    r = uint256_add(x, y);
+    ASSERT_SAME(r, (wx + wy).to_c());
+    r = uint256_sub(x, y);
+    ASSERT_SAME(r, (wx - wy).to_c());
+    r = uint256_negate(x);
+    ASSERT_SAME(r, (-wx).to_c());
+    r = uint256_mul(x, y);
+    ASSERT_SAME(r, (wx * wy).to_c());
+    r = uint256_lshift(x, s);
+    ASSERT_SAME(r, (wx << s).to_c());
+    r = uint256_rshift(x, s);
+    ASSERT_SAME(r, (wx >> s).to_c());
+    r = uint256_rotl(x, s);
+    ASSERT_SAME(r, wx.rotl(s).to_c());
+    r = uint256_and(x, y);
+    ASSERT_SAME(r, (wx & wy).to_c());
+    r = uint256_or(x, y);
+    ASSERT_SAME(r, (wx | wy).to_c());
+    r = uint256_xor(x, y);
+    ASSERT_SAME(r, (wx ^ wy).to_c());
+    r = uint256_not(x);
+    ASSERT_SAME(r, (~wx).to_c());
+    ASSERT(uint256_cmp(x, y) == wx.cmp(wy));
+    ASSERT(uint256_popcount(x) == wx.popcount());
+    ASSERT(uint256_clz(x) == wx.clz());
+    ASSERT(uint256_ctz(x) == wx.ctz());
+    ASSERT(uint256_bit_length(x) == wx.bit_length());
+
+    UInt256 hi, lo;
+    uint256_mul_wide(x, y, &hi, &lo);
+    WideUInt<512> p = mul_wide(wx, wy);
+    ASSERT_SAME(lo, wide_uint_cast<256>(p).to_c());
+    ASSERT_SAME(hi, wide_uint_cast<256>(p >> 256).to_c());
+
+    if (!uint256_is_zero(y)) {
+      // also divide by a short divisor to cover the single-limb path
+      UInt256 q, rem;
+      uint256_divmod(x, y, &q, &rem);
+      ASSERT_SAME(q, (wx / wy).to_c());
+      ASSERT_SAME(rem, (wx % wy).to_c());
+      UInt256W ys = wy >> (s + 200 < 256 ? s + 200 : 255);
+      if (!ys.is_zero()) {
+        uint256_divmod(x, ys.to_c(), &q, &rem);
+        ASSERT_SAME(q, (wx / ys).to_c());
+        ASSERT_SAME(rem, (wx % ys).to_c());
+      }
+    }
+  }
+}
+
+void test_wide_128(TestObjs *) {
+  UInt128W x = UInt128W::from_hex("fedcba98765432100123456789abcdef");
+  UInt128W y = UInt128W::from_hex("aaaaaaaa55555555ffffffff00000001");
+  ASSERT((x * y).to_hex() == "61172287ba375f27777777889abcdef");
+  ASSERT(x / y == UInt128W(1));
+  ASSERT((x % y).to_hex() == "54320fee20fedcba0123456889abcdee");
+  ASSERT(x - y == x % y);
+  ASSERT((x << 128).is_zero());
+  ASSERT(x.rotl(64).to_hex() == "123456789abcdeffedcba9876543210");
+}
+
+void test_wide_512(TestObjs *objs) {
+  UInt512W a = objs->a512, b = objs->b512;
+  ASSERT((a * b).to_hex() ==
+         "b791a824708cac47207811c365901eec7abdfe014bf83b651f2952d1eb4e3344"
+         "8f23516ca7faecfc8152e2da4d978985423e543671c4c00e800000008badf00d");
+  ASSERT(mul_wide(a, b).to_hex() ==
+         "71f52b0d003d66ad684eec9b8a90c294aceb7a9db399896a0b5bcc8f3cea0f4d"
+         "9e538d43221bde90d06dcbcd922fb42eaef16d795ae236f5a5d4e9e5a9151fd0"
+         "b791a824708cac47207811c365901eec7abdfe014bf83b651f2952d1eb4e3344"
+         "8f23516ca7faecfc8152e2da4d978985423e543671c4c00e800000008badf00d");
+  ASSERT(a / b == UInt512W(2));
+  ASSERT((a % b).to_hex() ==
+         "19edeaf77cb44613b58920b0ff63fc602876a4bb71ea6a5dbb130a967d5588c1"
+         "147ae147a40369cffc962f3a740da741ed4f2ccabf57dfd9e8a41fe3e8a41fe7");
+  ASSERT((a << 77).to_hex() ==
+         "68acf13579bdfbd5b7ddf95fd757c175be01b175be01a2468acf121579bdffdb"
+         "974130eca864355555554aaaaaaabfffffffe000000020000000000000000000");
+  ASSERT((a >> 300).to_hex() ==
+         "fedcba98765432100123456789abcdefdeadbeefcafebabe0badf");
+  std::string dec =
+      "1334821767247618555696416825738282155419080923260734108285666850107752"
+      "7416133033607019982287456464054714258771977328593914705894404984864694"
+      "308091449049089";
+  ASSERT(a.to_dec() == dec);
+  ASSERT(UInt512W::from_dec(dec) == a);
+}
+
+void test_wide_1024(TestObjs *objs) {
+  UInt1024W a = wide_uint_cast<1024>(objs->a512);
+  UInt1024W b = wide_uint_cast<1024>(objs->b512);
+  UInt1024W c = (a << 512) | b;
+  UInt1024W d = b >> 100;
+  ASSERT((c / d).to_hex() ==
+         "239fd762fed4761d72030307f884d4e9f2232194abb96ac2ff695237d137076c"
+         "184b05167a332ec7cdd7e48008999d98063005d3045348f619ca76ed92a9d9a7"
+         "89f39a437be4198bd489bf7754");
+  ASSERT((c % d).to_hex() ==
+         "2365e7485dda8438d576098bb5cf8df01c59971a0a3f22d450fea72a1cb6c143"
+         "a9470af3164f50f5c7228160cb3d1d599d023f5");
+  ASSERT((c / d) * d + c % d == c);
+  ASSERT(c.bit_length() == 1024);
+  ASSERT(c.clz() == 0);
+}
+
+void test_limb64(TestObjs *objs) {
+  // 64-bit limbs give the same results as 32-bit ones
+  using W64 = WideUInt<512, uint64_t>;
+  W64 a = W64::from_hex(objs->a512.to_hex());
+  W64 b = W64::from_hex(objs->b512.to_hex());
+  ASSERT((a * b).to_hex() == (objs->a512 * objs->b512).to_hex());
+  ASSERT((a % b).to_hex() == (objs->a512 % objs->b512).to_hex());
+  ASSERT((a >> 1).to_hex() == (objs->a512 >> 1).to_hex());
+  ASSERT(mul_wide(a, b).to_hex() == mul_wide(objs->a512, objs->b512).to_hex());
+  W64 d = b >> 450;
+  ASSERT((a / d).to_hex() == (objs->a512 / (objs->b512 >> 450)).to_hex());
+  ASSERT(a.to_dec() == objs->a512.to_dec());
+}